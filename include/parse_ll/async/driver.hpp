@@ -0,0 +1,306 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a driver that parses messages from many file descriptors, such as
+sockets or pipes, on one thread, with C++20 coroutines and epoll.
+
+Each stream is parsed by a coroutine that waits, without holding up the
+thread, until its file descriptor has input.
+Thousands of streams can therefore be parsed on a few threads, each of which
+runs an event_loop.
+
+A C++20 coroutine cannot suspend from inside the parsers, since they are not
+coroutines themselves.
+Therefore, when the parser runs out of input that has arrived, the parse of
+the current message is abandoned (through parse_ll::need_more_input), and
+run again from the start of the message when more input has arrived.
+Grammars need not be changed, but actors with side effects may be called
+more than once.
+Messages are normally short compared to the input as a whole, so the cost of
+this is small.
+A message that arrives in many pieces does cost time quadratic in its length,
+and is kept in memory until it is complete, so parse_stream() gives up on
+messages longer than a limit.
+
+This requires C++20 and Linux.
+*/
+
+#ifndef PARSE_LL_ASYNC_DRIVER_HPP_INCLUDED
+#define PARSE_LL_ASYNC_DRIVER_HPP_INCLUDED
+
+#if !defined (__cpp_impl_coroutine)
+#error "parse_ll/async/driver.hpp requires C++20 coroutines."
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <coroutine>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <boost/exception/errinfo_errno.hpp>
+
+#include "range/core.hpp"
+
+#include "../core/core.hpp"
+#include "../support/block_range.hpp"
+#include "stream_range.hpp"
+
+namespace parse_ll { namespace async {
+
+/**
+\return An input_error that describes the current errno.
+*/
+inline input_error system_error (char const * description) {
+    input_error e;
+    e << error_description (description) << boost::errinfo_errno (errno);
+    return e;
+}
+
+/**
+Event loop that resumes coroutines when the file descriptors they wait for
+have input.
+One event loop is used by one thread.
+*/
+class event_loop {
+    int epoll_;
+    // The number of coroutines that are waiting.
+    std::size_t waiting_;
+
+public:
+    /**
+    Awaitable that suspends the coroutine until a file descriptor has input,
+    or has been closed at the other end.
+    */
+    class readable {
+        event_loop & loop_;
+        int file_;
+        std::coroutine_handle <> handle_;
+
+        friend class event_loop;
+
+    public:
+        readable (event_loop & loop, int file) : loop_ (loop), file_ (file) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend (std::coroutine_handle <> handle) {
+            handle_ = handle;
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.ptr = this;
+            if (epoll_ctl (loop_.epoll_, EPOLL_CTL_ADD, file_, &event) != 0)
+                throw system_error ("Could not wait for input");
+            ++ loop_.waiting_;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    event_loop() : epoll_ (epoll_create1 (EPOLL_CLOEXEC)), waiting_ (0) {
+        if (epoll_ < 0)
+            throw system_error ("Could not create event loop");
+    }
+
+    event_loop (event_loop const &) = delete;
+    event_loop & operator = (event_loop const &) = delete;
+
+    ~event_loop() { close (epoll_); }
+
+    /**
+    \return The number of coroutines that are waiting.
+    */
+    std::size_t waiting() const { return waiting_; }
+
+    /**
+    Resume coroutines when their input arrives, until no coroutine is
+    waiting any more.
+    */
+    void run() {
+        epoll_event events [64];
+        while (waiting_ != 0) {
+            int event_num = epoll_wait (epoll_, events, 64, -1);
+            if (event_num < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw system_error ("Could not wait for events");
+            }
+            for (int i = 0; i != event_num; ++ i) {
+                readable * awaiter = static_cast <readable *> (
+                    events [i].data.ptr);
+                epoll_ctl (epoll_, EPOLL_CTL_DEL, awaiter->file_, nullptr);
+                -- waiting_;
+                awaiter->handle_.resume();
+            }
+        }
+    }
+};
+
+/**
+Why a stream was no longer parsed.
+*/
+enum class stream_end {
+    /// The input was closed after a complete message.
+    closed,
+    /// A message could not be parsed, or the input was closed in the middle
+    /// of one.
+    parse_failed
+};
+
+/**
+Coroutine that parses a stream.
+It starts running when it is created, and runs until it waits for input.
+The coroutine is destructed with this object, which must therefore outlive
+the event loop's run().
+*/
+class parse_task {
+public:
+    struct promise_type {
+        stream_end end;
+        std::exception_ptr error;
+
+        parse_task get_return_object() {
+            return parse_task (
+                std::coroutine_handle <promise_type>::from_promise (*this));
+        }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        // Keep the result until the parse_task is destructed.
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value (stream_end end) { this->end = end; }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+private:
+    std::coroutine_handle <promise_type> handle_;
+
+    explicit parse_task (std::coroutine_handle <promise_type> handle)
+    : handle_ (handle) {}
+
+public:
+    parse_task (parse_task && other)
+    : handle_ (std::exchange (other.handle_, nullptr)) {}
+
+    parse_task & operator = (parse_task && other) {
+        std::swap (handle_, other.handle_);
+        return *this;
+    }
+
+    ~parse_task() {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    bool done() const { return handle_.done(); }
+
+    /**
+    \return Why the stream was no longer parsed.
+    \pre done().
+    \throw The exception that the parse threw, if any.
+    */
+    stream_end result() const {
+        if (handle_.promise().error)
+            std::rethrow_exception (handle_.promise().error);
+        return handle_.promise().end;
+    }
+};
+
+namespace driver_detail {
+
+    template <class Handler, class Outcome>
+        inline void call (Handler & handler, Outcome const & outcome,
+            std::true_type)
+    {
+        ::parse_ll::output (outcome);
+        handler();
+    }
+
+    template <class Handler, class Outcome>
+        inline void call (Handler & handler, Outcome const & outcome,
+            std::false_type)
+    { handler (::parse_ll::output (outcome)); }
+
+} // namespace driver_detail
+
+/**
+Parse messages from file descriptor "file" with "parser", as input arrives,
+and call "handler" with the output of each message, or with no arguments if
+the output is void.
+Each message must consume some input.
+
+The coroutine finishes with stream_end::closed if the input is closed after
+a whole number of messages, and with stream_end::parse_failed if a message
+fails to parse, or if max_message_size bytes or more of a message have
+arrived and the parser still needs more.
+The limit keeps a client that never completes a message from using up memory,
+and bounds the time spent parsing a message again as its pieces arrive.
+The file descriptor is not closed.
+
+The parser and the handler are copied into the coroutine.
+The handler is called only once per message, but actors in the grammar may
+be called more than once, since a parse is run again when it runs out of
+input.
+*/
+template <class Parser, class Handler>
+    inline parse_task parse_stream (event_loop & loop, int file,
+        Parser parser, Handler handler, std::size_t read_size = 1 << 16,
+        std::size_t max_message_size = 1 << 20)
+{
+    ::range::stream_buffer buffer;
+    std::string block (read_size, '\0');
+    while (true) {
+        try {
+            ::range::stream_range input = buffer.range();
+            if (::range::empty (input))
+                co_return stream_end::closed;
+            auto outcome = ::parse_ll::parse (parser, input);
+            if (!::parse_ll::success (outcome))
+                co_return stream_end::parse_failed;
+            ::range::stream_range rest = ::parse_ll::rest (outcome);
+            if (rest == input)
+                co_return stream_end::parse_failed;
+            typedef std::is_void <decltype (::parse_ll::output (outcome))>
+                void_output;
+            driver_detail::call (handler, outcome, void_output());
+            buffer.discard (rest);
+            continue;
+        } catch (need_more_input const &) {}
+
+        // The buffer contains only the current message.
+        if (buffer.size() >= max_message_size)
+            co_return stream_end::parse_failed;
+
+        // A coroutine cannot wait inside a catch block.
+        co_await event_loop::readable (loop, file);
+        ssize_t size = read (file, &block [0], block.size());
+        if (size < 0) {
+            if (errno != EINTR && errno != EAGAIN)
+                throw system_error ("Could not read input");
+        } else if (size == 0)
+            buffer.close();
+        else
+            buffer.append (block.data(), std::size_t (size));
+    }
+}
+
+}} // namespace parse_ll::async
+
+#endif  // PARSE_LL_ASYNC_DRIVER_HPP_INCLUDED
@@ -0,0 +1,173 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a range over input that arrives bit by bit, for example from a socket,
+and that signals when it runs out of input that has arrived.
+*/
+
+#ifndef PARSE_LL_ASYNC_STREAM_RANGE_HPP_INCLUDED
+#define PARSE_LL_ASYNC_STREAM_RANGE_HPP_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+#include "range/core.hpp"
+
+namespace parse_ll {
+
+/**
+Exception that stream_range throws when it is asked whether it is empty at
+the end of the input that has arrived, while more input may arrive.
+The parse then cannot be completed yet, and should be run again when more
+input has arrived.
+
+This does not derive from std::exception, so that it is not caught by
+handlers for errors.
+*/
+struct need_more_input {};
+
+} // namespace parse_ll
+
+namespace range {
+
+class stream_range;
+
+/**
+Buffer for input that arrives bit by bit.
+Input is added at the back with append(), and removed at the front, once it
+has been parsed, with discard().
+*/
+class stream_buffer {
+    std::string data_;
+    // The position in data_ of the first byte that is kept.
+    std::size_t begin_;
+    // The offset in the stream of data_ [0].
+    std::size_t offset_;
+    bool closed_;
+
+public:
+    stream_buffer() : begin_ (0), offset_ (0), closed_ (false) {}
+
+    stream_buffer (stream_buffer const &) = delete;
+    stream_buffer & operator = (stream_buffer const &) = delete;
+
+    void append (char const * data, std::size_t size)
+    { data_.append (data, size); }
+
+    /**
+    Indicate that no more input will arrive.
+    */
+    void close() { closed_ = true; }
+
+    bool closed() const { return closed_; }
+
+    /**
+    \return The number of bytes that have arrived and have not been
+    discarded.
+    */
+    std::size_t size() const { return data_.size() - begin_; }
+
+    /**
+    \return A range that starts at the first byte that has not been
+    discarded.
+    Ranges refer to the buffer, so it must outlive them.
+    */
+    stream_range range() const;
+
+    /**
+    Discard all input before "position", which must have been derived from
+    range().
+    Ranges from before position become invalid.
+    */
+    void discard (stream_range const & position);
+
+private:
+    friend class stream_range;
+
+    std::size_t end_offset() const { return offset_ + data_.size(); }
+
+    char at (std::size_t offset) const { return data_ [offset - offset_]; }
+};
+
+struct stream_range_tag {};
+
+template <> struct tag_of_qualified <stream_range>
+{ typedef stream_range_tag type; };
+
+/**
+Range over the input in a stream_buffer.
+At the end of the input that has arrived, empty() returns true if the buffer
+has been closed, and otherwise throws parse_ll::need_more_input, since
+whether the range is empty is not known yet.
+
+The range holds a pointer to the buffer and an offset, so that it is cheap
+to copy, and does not become invalid when input is appended.
+*/
+class stream_range {
+    stream_buffer const * buffer_;
+    std::size_t offset_;
+
+    friend class stream_buffer;
+
+    stream_range (stream_buffer const & buffer, std::size_t offset)
+    : buffer_ (&buffer), offset_ (offset) {}
+
+public:
+    /**
+    \return The offset in the stream.
+    */
+    std::size_t offset() const { return offset_; }
+
+    bool operator == (stream_range const & other) const
+    { return buffer_ == other.buffer_ && offset_ == other.offset_; }
+    bool operator != (stream_range const & other) const
+    { return !(*this == other); }
+
+private:
+    friend class range::helper::member_access;
+
+    bool empty (direction::front) const {
+        if (offset_ != buffer_->end_offset())
+            return false;
+        if (buffer_->closed())
+            return true;
+        throw ::parse_ll::need_more_input();
+    }
+
+    char first (direction::front) const { return buffer_->at (offset_); }
+
+    stream_range drop_one (direction::front) const
+    { return stream_range (*buffer_, offset_ + 1); }
+};
+
+inline stream_range stream_buffer::range() const
+{ return stream_range (*this, offset_ + begin_); }
+
+inline void stream_buffer::discard (stream_range const & position) {
+    begin_ = position.offset() - offset_;
+    // Move the rest of the data to the front only once that is cheap
+    // compared to how much has been parsed.
+    if (begin_ > data_.size() / 2) {
+        data_.erase (0, begin_);
+        offset_ += begin_;
+        begin_ = 0;
+    }
+}
+
+} // namespace range
+
+#endif  // PARSE_LL_ASYNC_STREAM_RANGE_HPP_INCLUDED
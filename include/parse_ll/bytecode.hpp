@@ -0,0 +1,31 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Compile parsers into bytecode programs and run them.
+*/
+
+#ifndef PARSE_LL_BYTECODE_HPP_INCLUDED
+#define PARSE_LL_BYTECODE_HPP_INCLUDED
+
+#include "bytecode/program.hpp"
+#include "bytecode/lowering.hpp"
+#include "bytecode/rule.hpp"
+#include "bytecode/interpreter.hpp"
+#include "bytecode/parser.hpp"
+#include "bytecode/peg.hpp"
+
+#endif  // PARSE_LL_BYTECODE_HPP_INCLUDED
@@ -0,0 +1,276 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Run a bytecode program on input.
+*/
+
+#ifndef PARSE_LL_BYTECODE_INTERPRETER_HPP_INCLUDED
+#define PARSE_LL_BYTECODE_INTERPRETER_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#include "range/core.hpp"
+
+#include "../core/error.hpp"
+
+#include "program.hpp"
+
+namespace parse_ll { namespace bytecode {
+
+/**
+Result of running a program.
+If the program has succeeded, rest contains the remaining input.
+Whether or not it has succeeded, furthest contains the number of characters
+before the furthest point at which a character instruction failed, and
+expected the description of what was expected there.
+This comes from describe() on the outermost named parser, or on the parser
+itself.
+Failures in skip parsers are not reported.
+If nothing failed, expected is empty.
+*/
+template <class Input> struct result {
+    bool success;
+    Input rest;
+    std::size_t furthest;
+    std::string expected;
+
+    result (bool success, Input const & rest, std::size_t furthest,
+        std::string const & expected)
+    : success (success), rest (rest), furthest (furthest),
+        expected (expected) {}
+};
+
+namespace run_detail {
+
+    /**
+    Entry on the stack: either a backtrack point or a return address.
+    */
+    template <class Input> struct entry {
+        std::uint32_t address;
+        bool is_call;
+        Input input;
+        std::size_t position;
+
+        entry (std::uint32_t address, bool is_call, Input const & input,
+            std::size_t position)
+        : address (address), is_call (is_call), input (input),
+            position (position) {}
+    };
+
+    /**
+    Check that the top of the stack is a return address if is_call, or a
+    backtrack point otherwise.
+    \throw format_error if not.
+    */
+    template <class Input> inline void check_top (
+        std::vector <entry <Input>> const & stack, bool is_call)
+    {
+        if (stack.empty() || stack.back().is_call != is_call) {
+            throw program_detail::error (is_call
+                ? "Instruction expects a return address on the stack"
+                : "Instruction expects a backtrack point on the stack");
+        }
+    }
+
+} // namespace run_detail
+
+/**
+Run program on input.
+The elements of the input must be characters.
+The program must have been verified, which compile() and program::read() do.
+
+The interpreter is one loop over the instructions, with an explicit stack for
+backtracking and calls, so the depth of the grammar does not use up the
+machine stack.
+
+\throw parse_ll::error if an "expect" instruction is reached, i.e. if the
+second parser in a > b fails.
+\throw format_error if an instruction finds the wrong kind of entry, or no
+entry, on top of the stack.
+This cannot happen with a program produced by compile(), but verify() does
+not rule it out for a program that was read.
+*/
+template <class Input> inline
+    result <Input> run (program const & program, Input input)
+{
+    typedef typename std::decay <decltype (::range::first (input))>::type
+        element_type;
+    static_assert (std::is_integral <element_type>::value
+        && sizeof (element_type) == 1,
+        "Bytecode programs can only parse ranges of characters.");
+
+    using ::range::empty; using ::range::first; using ::range::drop;
+
+    static const std::uint32_t nothing_expected = std::uint32_t (-1);
+
+    std::vector <run_detail::entry <Input>> stack;
+    instruction const * instructions = program.instructions.data();
+    std::uint32_t address = 0;
+    // Number of characters consumed.
+    std::size_t position = 0;
+    std::size_t furthest = 0;
+    std::uint32_t expected = nothing_expected;
+
+    while (true) {
+        instruction const & current = instructions [address];
+        bool failed = false;
+        switch (current.code) {
+        case opcode::any:
+            if (empty (input))
+                failed = true;
+            else {
+                input = drop (input);
+                ++ position;
+                ++ address;
+            }
+            break;
+
+        case opcode::character:
+            if (empty (input) || static_cast <unsigned char> (first (input))
+                    != current.argument)
+                failed = true;
+            else {
+                input = drop (input);
+                ++ position;
+                ++ address;
+            }
+            break;
+
+        case opcode::set:
+            if (empty (input) || !program.sets [current.argument] [
+                    static_cast <unsigned char> (first (input))])
+                failed = true;
+            else {
+                input = drop (input);
+                ++ position;
+                ++ address;
+            }
+            break;
+
+        case opcode::string:
+            {
+                std::string const & s = program.strings [current.argument];
+                Input rest = input;
+                std::size_t index = 0;
+                for (; index != s.size(); ++ index) {
+                    if (empty (rest) || first (rest) != s [index])
+                        break;
+                    rest = drop (rest);
+                }
+                if (index != s.size())
+                    failed = true;
+                else {
+                    input = rest;
+                    position += s.size();
+                    ++ address;
+                }
+            }
+            break;
+
+        case opcode::end_of_input:
+            if (!empty (input))
+                failed = true;
+            else
+                ++ address;
+            break;
+
+        case opcode::fail:
+            failed = true;
+            break;
+
+        case opcode::jump:
+            address = current.argument;
+            break;
+
+        case opcode::choice:
+            stack.emplace_back (current.argument, false, input, position);
+            ++ address;
+            break;
+
+        case opcode::commit:
+            run_detail::check_top (stack, false);
+            stack.pop_back();
+            address = current.argument;
+            break;
+
+        case opcode::partial_commit:
+            run_detail::check_top (stack, false);
+            stack.back().input = input;
+            stack.back().position = position;
+            address = current.argument;
+            break;
+
+        case opcode::fail_twice:
+            run_detail::check_top (stack, false);
+            stack.pop_back();
+            failed = true;
+            break;
+
+        case opcode::call:
+            stack.emplace_back (address + 1, true, input, position);
+            address = current.argument;
+            break;
+
+        case opcode::return_:
+            run_detail::check_top (stack, true);
+            address = stack.back().address;
+            stack.pop_back();
+            break;
+
+        case opcode::expect:
+            throw error() << error_at <Input> (input)
+                << error_description (
+                    program.descriptions [current.description]);
+
+        case opcode::halt:
+            return result <Input> (true, input, furthest,
+                expected == nothing_expected ? std::string()
+                : program.descriptions [expected]);
+        }
+
+        if (failed) {
+            if (current.code != opcode::fail
+                && current.code != opcode::fail_twice
+                && (expected == nothing_expected || position > furthest)
+                && !program.descriptions [current.description].empty())
+            {
+                furthest = position;
+                expected = current.description;
+            }
+            // Backtrack.
+            while (!stack.empty() && stack.back().is_call)
+                stack.pop_back();
+            if (stack.empty()) {
+                return result <Input> (false, input, furthest,
+                    expected == nothing_expected ? std::string()
+                    : program.descriptions [expected]);
+            }
+            input = stack.back().input;
+            position = stack.back().position;
+            address = stack.back().address;
+            stack.pop_back();
+        }
+    }
+}
+
+}} // namespace parse_ll::bytecode
+
+#endif  // PARSE_LL_BYTECODE_INTERPRETER_HPP_INCLUDED
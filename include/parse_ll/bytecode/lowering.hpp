@@ -0,0 +1,391 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Lower a parser expression into a bytecode program.
+
+Each parser type specialises operation::lower for its tag, next to
+operation::parse and operation::describe.
+The lowering mirrors the parse, including the policy, so that skip parsers
+are put in the same places.
+*/
+
+#ifndef PARSE_LL_BYTECODE_LOWERING_HPP_INCLUDED
+#define PARSE_LL_BYTECODE_LOWERING_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <bitset>
+
+#include "range/core.hpp"
+
+#include "../core/fwd.hpp"
+#include "../core/core.hpp"
+#include "../core/fail.hpp"
+#include "../core/describe.hpp"
+
+#include "program.hpp"
+
+namespace parse_ll {
+
+class rule_explicit_skip_parser;
+
+namespace bytecode {
+
+/**
+Exception that is thrown when a parser cannot be lowered into bytecode.
+*/
+struct lowering_error
+: public virtual boost::exception, public virtual std::exception {};
+
+/**
+Stand-in for a skip parser whose subroutine has already been emitted.
+Parsers inside a rule are lowered with a policy that has this as its skip
+parser, since the skip parser outside the rule is not known by type there.
+*/
+struct skip_subroutine {
+    std::uint32_t entry;
+};
+
+/**
+Lower parser expressions into a program.
+Parsers lower themselves by calling the member functions, which append
+instructions.
+
+Labels stand for instruction addresses that may not be known yet.
+finish() resolves them.
+
+Subroutines (for rules and skip parsers) are emitted inline, with a jump
+around them, and are memoised, so that recursive rules produce recursive
+calls.
+*/
+class lowering {
+public:
+    typedef std::uint32_t label;
+    static const label no_label = label (-1);
+
+private:
+    program program_;
+    std::vector <std::size_t> addresses;
+    std::map <std::string, std::uint32_t> description_indices;
+    std::map <std::pair <void const *, label>, label> subroutines;
+    std::vector <const char *> names;
+
+    std::uint32_t description_index (const char * description) {
+        // Inside a named parser, describe with the outermost name.
+        std::string text = names.empty() ? description : names.front();
+        auto position = description_indices.find (text);
+        if (position != description_indices.end())
+            return position->second;
+        std::uint32_t index = program_.descriptions.size();
+        program_.descriptions.push_back (text);
+        description_indices [text] = index;
+        return index;
+    }
+
+    void emit (opcode code, std::uint32_t argument,
+        const char * description = "")
+    {
+        program_.instructions.push_back (instruction (
+            code, argument, description_index (description)));
+    }
+
+    static std::pair <void const *, label> key (
+        void const * address, label context)
+    { return std::make_pair (address, context); }
+
+    template <class Char> static std::uint32_t code_of (Char c)
+    { return static_cast <unsigned char> (c); }
+
+public:
+    /// Labels.
+    label new_label() {
+        addresses.push_back (std::size_t (-1));
+        return label (addresses.size() - 1);
+    }
+    void place (label l) { addresses [l] = program_.instructions.size(); }
+
+    /// Primitive instructions.
+    void any (const char * description)
+    { emit (opcode::any, 0, description); }
+
+    template <class Char>
+        void character (Char c, const char * description)
+    { emit (opcode::character, code_of (c), description); }
+
+    /**
+    Emit an instruction that consumes a character for which
+    predicate (char (c)) holds.
+    The predicate is evaluated now for all 256 values of char.
+    */
+    template <class Predicate>
+        void set (Predicate const & predicate, const char * description)
+    {
+        std::bitset <256> set;
+        for (int code = 0; code != 256; ++ code)
+            set [code] = bool (predicate (static_cast <char> (code)));
+        this->set (set, description);
+    }
+
+    void set (std::bitset <256> const & set, const char * description) {
+        std::uint32_t index = program_.sets.size();
+        program_.sets.push_back (set);
+        emit (opcode::set, index, description);
+    }
+
+    void string (char c, const char * description)
+    { character (c, description); }
+
+    template <class Literal>
+        void string (Literal const & literal, const char * description)
+    {
+        std::string s;
+        for (auto r = ::range::view (literal); !::range::empty (r);
+                r = ::range::drop (r))
+            s.push_back (static_cast <char> (::range::first (r)));
+        if (s.size() == 1)
+            character (s [0], description);
+        else {
+            std::uint32_t index = program_.strings.size();
+            program_.strings.push_back (s);
+            emit (opcode::string, index, description);
+        }
+    }
+
+    void end_of_input (const char * description)
+    { emit (opcode::end_of_input, 0, description); }
+    void fail() { emit (opcode::fail, 0); }
+    void fail_twice() { emit (opcode::fail_twice, 0); }
+    void expect (const char * description)
+    { emit (opcode::expect, 0, description); }
+
+    void jump (label target) { emit (opcode::jump, target); }
+    void choice (label target) { emit (opcode::choice, target); }
+    void commit (label target) { emit (opcode::commit, target); }
+    void partial_commit (label target)
+    { emit (opcode::partial_commit, target); }
+    void call (label target) { emit (opcode::call, target); }
+    void return_() { emit (opcode::return_, 0); }
+
+    /// Named parsers describe what they contain.
+    /// An empty name means that failures should not be reported.
+    void push_name (const char * name) { names.push_back (name); }
+    void pop_name() { names.pop_back(); }
+
+    /**
+    Lower a parser with a policy.
+    */
+    template <class Policy, class Parser>
+        void lower (Policy const & policy, Parser const & parser)
+    {
+        operation::lower <typename parser_tag <Parser>::type>() (
+            *this, policy, parser);
+    }
+
+    /**
+    Emit a call to the subroutine identified by (address, context).
+    The first time, emit_body is called to emit the body of the subroutine.
+    \return The label of the subroutine.
+    */
+    template <class EmitBody> label call (
+        void const * address, label context, EmitBody const & emit_body)
+    {
+        auto position = subroutines.find (key (address, context));
+        label entry;
+        if (position != subroutines.end())
+            entry = position->second;
+        else {
+            entry = new_label();
+            // Register before emitting the body, for recursion.
+            subroutines [key (address, context)] = entry;
+            label after = new_label();
+            jump (after);
+            place (entry);
+            emit_body();
+            return_();
+            place (after);
+        }
+        call (entry);
+        return entry;
+    }
+
+    /**
+    \return The label of a subroutine that applies the skip parser, or
+    no_label if the skip parser never consumes anything.
+    Like skip_over, this succeeds even if the skip parser does not.
+    */
+    template <class SkipParser>
+        label skip_label (SkipParser const & skip_parser)
+    {
+        auto position = subroutines.find (key (&skip_parser, no_label));
+        if (position != subroutines.end())
+            return position->second;
+        // Emit the subroutine without calling it.
+        label after = new_label();
+        jump (after);
+        label entry = new_label();
+        subroutines [key (&skip_parser, no_label)] = entry;
+        place (entry);
+        label done = new_label();
+        choice (done);
+        // Failures of the skip parser are not interesting to report.
+        push_name ("");
+        lower (parse_policy::direct(), skip_parser);
+        pop_name();
+        commit (done);
+        place (done);
+        return_();
+        place (after);
+        return entry;
+    }
+
+    label skip_label (fail_parser const &) { return no_label; }
+    label skip_label (rule_explicit_skip_parser const &) { return no_label; }
+
+    label skip_label (skip_subroutine const & skip_parser)
+    { return skip_parser.entry; }
+
+    /**
+    Emit a call to the skip parser of the policy, as skip_over would apply
+    it between elements.
+    */
+    template <class Policy> void skip (Policy const & policy) {
+        label skip = skip_label (policy.skip_parser());
+        if (skip != no_label)
+            call (skip);
+    }
+
+    /**
+    Emit code for a repetition of between minimum and maximum elements, where
+    maximum is -1 for no maximum.
+    emit_element emits one element; emit_between emits what is between two
+    elements.
+    If the element or what follows it fails, the input is reset to after the
+    previous element.
+    */
+    template <class EmitBetween, class EmitElement>
+        void repeat (int minimum, int maximum,
+            EmitBetween const & emit_between, EmitElement const & emit_element)
+    {
+        for (int count = 0; count != minimum; ++ count) {
+            if (count != 0)
+                emit_between();
+            emit_element();
+        }
+        label done = new_label();
+        if (maximum == -1) {
+            label body = new_label();
+            if (minimum == 0) {
+                // The first element comes without anything in between.
+                label loop = new_label();
+                choice (done);
+                emit_element();
+                commit (loop);
+                place (loop);
+            }
+            choice (done);
+            place (body);
+            emit_between();
+            emit_element();
+            partial_commit (body);
+        } else {
+            for (int count = minimum; count < maximum; ++ count) {
+                label next = new_label();
+                choice (done);
+                if (count != 0)
+                    emit_between();
+                emit_element();
+                commit (next);
+                place (next);
+            }
+        }
+        place (done);
+    }
+
+    /**
+    Emit code for a repetition of sub_parser, with the skip parser of the
+    policy in between elements.
+    */
+    template <class Policy, class SubParser>
+        void repeat (Policy const & policy, SubParser const & sub_parser,
+            int minimum, int maximum)
+    {
+        repeat (minimum, maximum,
+            [&] { this->skip (policy); },
+            [&] { this->lower (policy, sub_parser); });
+    }
+
+    /**
+    Finish the program with "halt", resolve labels, and return it.
+    */
+    program finish() {
+        emit (opcode::halt, 0);
+        for (instruction & i : program_.instructions) {
+            if (has_address (i.code))
+                i.argument = addresses [i.argument];
+        }
+        program_.verify();
+        return std::move (program_);
+    }
+};
+
+/**
+Compile a parser into a program, as if it were parsed with policy.
+\throw lowering_error if the parser, or a parser inside it, cannot be
+lowered.
+*/
+template <class Policy, class Parser>
+    inline program compile (Policy const & policy, Parser const & parser)
+{
+    lowering l;
+    l.lower (policy, parser);
+    return l.finish();
+}
+
+/**
+Compile a parser into a program, as if it were parsed with the default
+policy.
+*/
+template <class Parser> inline program compile (Parser const & parser)
+{ return compile (parse_policy::direct(), parser); }
+
+} // namespace bytecode
+
+namespace operation {
+
+    /**
+    Implementation of lowering for parsers that do not support it.
+    Parsers that can be lowered specialise this.
+    */
+    template <class ParserTag, typename Enable /* = void */> struct lower {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering &, Policy const &,
+                Parser const & parser) const
+        {
+            throw bytecode::lowering_error() << error_description (
+                std::string ("Cannot lower parser to bytecode: ")
+                + ::parse_ll::describe (parser));
+        }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_BYTECODE_LOWERING_HPP_INCLUDED
@@ -0,0 +1,83 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a parser that runs a bytecode program.
+*/
+
+#ifndef PARSE_LL_BYTECODE_PARSER_HPP_INCLUDED
+#define PARSE_LL_BYTECODE_PARSER_HPP_INCLUDED
+
+#include <memory>
+#include <utility>
+
+#include "../core/core.hpp"
+#include "../core/outcome/failed.hpp"
+#include "../core/outcome/explicit.hpp"
+
+#include "program.hpp"
+#include "interpreter.hpp"
+
+namespace parse_ll {
+
+/**
+Parser that runs a bytecode program, for example one that was compiled with
+bytecode::compile() or read from a file with bytecode::program::read().
+Its output is void.
+The skip parser is part of the program; the skip parser of the policy that
+this parser is used with is not used.
+Like rule, this keeps the program in a shared_ptr, so that it is cheap to
+copy.
+*/
+class bytecode_parser : public parser_base <bytecode_parser> {
+    std::shared_ptr <bytecode::program const> program_;
+public:
+    explicit bytecode_parser (bytecode::program program)
+    : program_ (std::make_shared <bytecode::program const> (
+        std::move (program))) {}
+
+    bytecode::program const & program() const { return *program_; }
+};
+
+struct bytecode_parser_tag;
+template <> struct decayed_parser_tag <bytecode_parser>
+{ typedef bytecode_parser_tag type; };
+
+namespace operation {
+
+    template <> struct parse <bytecode_parser_tag> {
+        template <class Policy, class Input>
+            explicit_outcome <void, Input> operator() (Policy const &,
+                bytecode_parser const & parser, Input const & input) const
+        {
+            auto result = bytecode::run (parser.program(), input);
+            if (result.success)
+                return explicit_outcome <void, Input> (result.rest);
+            else
+                return failed();
+        }
+    };
+
+    template <> struct describe <bytecode_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "bytecode"; }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_BYTECODE_PARSER_HPP_INCLUDED
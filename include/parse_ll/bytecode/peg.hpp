@@ -0,0 +1,707 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Read a grammar in PEG notation at run time and compile it into a bytecode
+program.
+
+The notation is that of parsing expression grammars, with some common
+alternatives from EBNF:
+
+    # Comments run to the end of the line.
+    list    <- item (',' item)*
+    item    <- [a-zA-Z_] [a-zA-Z_0-9]* / number
+    number  = '-'? [0-9]+ ;
+
+\li A rule is "name <- expression" or "name = expression", optionally
+    followed by ";".
+    The first rule is the start rule, unless another one is given.
+\li 'literal' and "literal" match literal text.
+    The escapes \\n, \\r, \\t, \\\\, \\', \\", \\[, \\], \\- and \\xHH are
+    recognised.
+\li [a-z_] matches one character in a class; [^...] one character not in it.
+\li . matches any character.
+\li e1 e2 is a sequence; e1 / e2 and e1 | e2 are ordered choices.
+\li e*, e+ and e? repeat and make optional; !e and &e are lookahead.
+\li Whitespace is not skipped implicitly, as is usual for PEG.
+
+Grammars that would not terminate are rejected when they are read, as
+the corresponding parser expressions are rejected at compile time: e* and e+
+where e can succeed without consuming input, and left-recursive rules.
+*/
+
+#ifndef PARSE_LL_BYTECODE_PEG_HPP_INCLUDED
+#define PARSE_LL_BYTECODE_PEG_HPP_INCLUDED
+
+#include <cstddef>
+#include <bitset>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/exception/all.hpp>
+
+#include "../core/error.hpp"
+
+#include "program.hpp"
+#include "lowering.hpp"
+#include "parser.hpp"
+
+namespace parse_ll {
+
+namespace bytecode {
+
+/**
+Exception that is thrown when a grammar cannot be read.
+It contains an error_description.
+If the problem is in the grammar text, it also contains a grammar_line; if it
+is with a rule, it also contains the grammar_rule, and the grammar_line of the
+definition of the rule.
+*/
+struct grammar_error
+: public virtual boost::exception, public virtual std::exception {};
+
+typedef boost::error_info <struct grammar_line_tag, std::size_t>
+    grammar_line;
+typedef boost::error_info <struct grammar_rule_tag, std::string>
+    grammar_rule;
+
+namespace peg_detail {
+
+    /**
+    Expression in a grammar.
+    */
+    struct expression {
+        enum class kind { any, literal, set, rule, sequence, choice,
+            zero_or_more, one_or_more, optional, not_, and_ };
+
+        kind type;
+        // For literal and rule.
+        std::string text;
+        // For set.
+        std::bitset <256> set;
+        std::vector <expression> children;
+
+        explicit expression (kind type) : type (type) {}
+    };
+
+    /**
+    Definition of a rule, with the line of the grammar it starts on.
+    */
+    struct rule_definition {
+        std::string name;
+        expression body;
+        std::size_t line;
+
+        rule_definition (std::string const & name, expression && body,
+            std::size_t line)
+        : name (name), body (std::move (body)), line (line) {}
+    };
+
+    typedef std::vector <rule_definition> rules_type;
+
+    inline grammar_error rule_error (rule_definition const & rule,
+        std::string const & description)
+    {
+        return grammar_error() << error_description (description)
+            << grammar_rule (rule.name) << grammar_line (rule.line);
+    }
+
+    /**
+    Recursive-descent reader for the grammar notation.
+    */
+    class reader {
+        std::string const & text;
+        std::size_t position;
+        std::size_t line;
+
+        grammar_error error (std::string const & description) const {
+            return grammar_error() << error_description (description)
+                << grammar_line (line);
+        }
+
+        bool at_end() const { return position == text.size(); }
+        char current() const { return text [position]; }
+
+        void skip_space() {
+            while (!at_end()) {
+                if (current() == '#') {
+                    while (!at_end() && current() != '\n')
+                        ++ position;
+                } else if (current() == '\n') {
+                    ++ line;
+                    ++ position;
+                } else if (current() == ' ' || current() == '\t'
+                        || current() == '\r')
+                    ++ position;
+                else
+                    break;
+            }
+        }
+
+        bool accept (const char * token) {
+            std::string t (token);
+            if (text.compare (position, t.size(), t) != 0)
+                return false;
+            position += t.size();
+            skip_space();
+            return true;
+        }
+
+        static bool is_identifier_start (char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+                || c == '_';
+        }
+        static bool is_identifier_char (char c)
+        { return is_identifier_start (c) || (c >= '0' && c <= '9'); }
+
+        std::string identifier() {
+            std::size_t start = position;
+            while (!at_end() && is_identifier_char (current()))
+                ++ position;
+            std::string result = text.substr (start, position - start);
+            skip_space();
+            return result;
+        }
+
+        // Whether the text at the current position starts a new rule.
+        bool at_definition() {
+            if (at_end() || !is_identifier_start (current()))
+                return false;
+            std::size_t saved_position = position, saved_line = line;
+            identifier();
+            bool result = !at_end() && (current() == '='
+                || text.compare (position, 2, "<-") == 0);
+            position = saved_position;
+            line = saved_line;
+            return result;
+        }
+
+        static int hex_value (char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        // Read one, possibly escaped, character in a literal or class.
+        char character() {
+            if (at_end())
+                throw error ("Unexpected end of grammar");
+            char c = current();
+            ++ position;
+            if (c == '\n')
+                ++ line;
+            if (c != '\\')
+                return c;
+            if (at_end())
+                throw error ("Unexpected end of grammar after \\");
+            char escaped = current();
+            ++ position;
+            switch (escaped) {
+            case 'n': return '\n';
+            case 'r': return '\r';
+            case 't': return '\t';
+            case '\\': case '\'': case '"': case '[': case ']': case '-':
+                return escaped;
+            case 'x':
+                {
+                    if (text.size() - position < 2
+                            || hex_value (text [position]) < 0
+                            || hex_value (text [position + 1]) < 0)
+                        throw error ("Expected two hexadecimal digits");
+                    int value = hex_value (text [position]) * 16
+                        + hex_value (text [position + 1]);
+                    position += 2;
+                    return char (value);
+                }
+            default:
+                throw error (std::string ("Unknown escape \\") + escaped);
+            }
+        }
+
+        expression literal() {
+            char quote = current();
+            ++ position;
+            expression result (expression::kind::literal);
+            while (true) {
+                if (at_end())
+                    throw error ("Literal is not terminated");
+                if (current() == quote)
+                    break;
+                result.text.push_back (character());
+            }
+            ++ position;
+            skip_space();
+            return result;
+        }
+
+        expression character_class() {
+            ++ position;
+            expression result (expression::kind::set);
+            bool negate = !at_end() && current() == '^';
+            if (negate)
+                ++ position;
+            while (true) {
+                if (at_end())
+                    throw error ("Character class is not terminated");
+                if (current() == ']')
+                    break;
+                unsigned char first = character();
+                unsigned char last = first;
+                if (!at_end() && current() == '-'
+                        && position + 1 < text.size()
+                        && text [position + 1] != ']')
+                {
+                    ++ position;
+                    last = character();
+                    if (last < first)
+                        throw error ("Character range is reversed");
+                }
+                for (unsigned code = first; code <= last; ++ code)
+                    result.set [code] = true;
+            }
+            ++ position;
+            skip_space();
+            if (negate)
+                result.set.flip();
+            return result;
+        }
+
+        expression primary() {
+            if (at_end())
+                throw error ("Expected an expression");
+            char c = current();
+            if (accept ("(")) {
+                expression result = choice();
+                if (!accept (")"))
+                    throw error ("Expected )");
+                return result;
+            }
+            if (c == '\'' || c == '"')
+                return literal();
+            if (c == '[')
+                return character_class();
+            if (accept ("."))
+                return expression (expression::kind::any);
+            if (is_identifier_start (c)) {
+                expression result (expression::kind::rule);
+                result.text = identifier();
+                return result;
+            }
+            throw error (std::string ("Unexpected character: ") + c);
+        }
+
+        expression suffix() {
+            expression result = primary();
+            while (true) {
+                expression::kind type;
+                if (accept ("*"))
+                    type = expression::kind::zero_or_more;
+                else if (accept ("+"))
+                    type = expression::kind::one_or_more;
+                else if (accept ("?"))
+                    type = expression::kind::optional;
+                else
+                    return result;
+                expression repeated (type);
+                repeated.children.push_back (std::move (result));
+                result = std::move (repeated);
+            }
+        }
+
+        expression prefix() {
+            expression::kind type;
+            if (accept ("!"))
+                type = expression::kind::not_;
+            else if (accept ("&"))
+                type = expression::kind::and_;
+            else
+                return suffix();
+            expression result (type);
+            result.children.push_back (prefix());
+            return result;
+        }
+
+        bool at_sequence_end() {
+            return at_end() || current() == ')' || current() == '/'
+                || current() == '|' || current() == ';' || at_definition();
+        }
+
+        expression sequence() {
+            expression result (expression::kind::sequence);
+            while (!at_sequence_end())
+                result.children.push_back (prefix());
+            if (result.children.size() == 1)
+                return std::move (result.children.front());
+            return result;
+        }
+
+        expression choice() {
+            expression result (expression::kind::choice);
+            result.children.push_back (sequence());
+            while (accept ("/") || accept ("|"))
+                result.children.push_back (sequence());
+            if (result.children.size() == 1)
+                return std::move (result.children.front());
+            return result;
+        }
+
+    public:
+        explicit reader (std::string const & text)
+        : text (text), position (0), line (1) {}
+
+        rules_type rules() {
+            rules_type result;
+            skip_space();
+            while (!at_end()) {
+                if (!is_identifier_start (current()))
+                    throw error ("Expected the name of a rule");
+                std::size_t rule_line = line;
+                std::string name = identifier();
+                if (!accept ("<-") && !accept ("="))
+                    throw error ("Expected <- or = after " + name);
+                expression body = choice();
+                accept (";");
+                result.push_back (
+                    rule_definition (name, std::move (body), rule_line));
+            }
+            if (result.empty())
+                throw error ("The grammar contains no rules");
+            return result;
+        }
+    };
+
+    /**
+    Check that a grammar terminates on any input.
+    It finds which rules can succeed without consuming input, and from that,
+    repetitions of such expressions, and rules that call themselves without
+    consuming input.
+    */
+    class checker {
+        rules_type const & rules;
+        std::map <std::string, std::size_t> indices;
+        std::vector <bool> nullable_rules;
+
+        /**
+        \return The index of the rule called name, which check_calls() has
+        made sure exists.
+        */
+        std::size_t index (std::string const & name) const
+        { return indices.find (name)->second; }
+
+        /**
+        Throw if e, in rule, calls a rule that is not defined.
+        */
+        void check_calls (rule_definition const & rule,
+            expression const & e) const
+        {
+            if (e.type == expression::kind::rule
+                    && indices.find (e.text) == indices.end())
+                throw rule_error (rule, "Undefined rule: " + e.text);
+            for (expression const & child : e.children)
+                check_calls (rule, child);
+        }
+
+        /**
+        \return true iff e can succeed without consuming input, given what
+        is known about the rules so far.
+        */
+        bool nullable (expression const & e) const {
+            typedef expression::kind kind;
+            switch (e.type) {
+            case kind::any:
+            case kind::set:
+                return false;
+            case kind::literal:
+                return e.text.empty();
+            case kind::rule:
+                return nullable_rules [index (e.text)];
+            case kind::sequence:
+                for (expression const & child : e.children)
+                    if (!nullable (child))
+                        return false;
+                return true;
+            case kind::choice:
+                for (expression const & child : e.children)
+                    if (nullable (child))
+                        return true;
+                return false;
+            case kind::one_or_more:
+                return nullable (e.children.front());
+            case kind::zero_or_more:
+            case kind::optional:
+            case kind::not_:
+            case kind::and_:
+                return true;
+            }
+            return false;
+        }
+
+        /**
+        Throw if e contains a repetition of an expression that can succeed
+        without consuming input.
+        */
+        void check_repetitions (rule_definition const & rule,
+            expression const & e) const
+        {
+            if ((e.type == expression::kind::zero_or_more
+                    || e.type == expression::kind::one_or_more)
+                && nullable (e.children.front()))
+            {
+                throw rule_error (rule, "Rule " + rule.name
+                    + " repeats an expression that can match nothing");
+            }
+            for (expression const & child : e.children)
+                check_repetitions (rule, child);
+        }
+
+        /**
+        Add the rules that e calls before consuming any input to "called".
+        */
+        void left_calls (expression const & e,
+            std::vector <std::size_t> & called) const
+        {
+            typedef expression::kind kind;
+            switch (e.type) {
+            case kind::rule:
+                called.push_back (index (e.text));
+                break;
+            case kind::sequence:
+                for (expression const & child : e.children) {
+                    left_calls (child, called);
+                    if (!nullable (child))
+                        break;
+                }
+                break;
+            default:
+                for (expression const & child : e.children)
+                    left_calls (child, called);
+            }
+        }
+
+    public:
+        /**
+        \throw grammar_error if a rule is defined twice, or if an undefined
+        rule is called.
+        */
+        explicit checker (rules_type const & rules)
+        : rules (rules), nullable_rules (rules.size(), false)
+        {
+            for (std::size_t i = 0; i != rules.size(); ++ i) {
+                if (!indices.insert (std::make_pair (rules [i].name, i)).second)
+                {
+                    throw rule_error (rules [i],
+                        "Rule defined twice: " + rules [i].name);
+                }
+            }
+            for (rule_definition const & rule : rules)
+                check_calls (rule, rule.body);
+
+            // Find the nullable rules by iterating until nothing changes.
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                for (std::size_t i = 0; i != rules.size(); ++ i) {
+                    if (!nullable_rules [i] && nullable (rules [i].body)) {
+                        nullable_rules [i] = true;
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        /**
+        \throw grammar_error if the grammar may not terminate.
+        */
+        void check() const {
+            for (rule_definition const & rule : rules)
+                check_repetitions (rule, rule.body);
+
+            std::vector <std::vector <std::size_t>> calls (rules.size());
+            for (std::size_t i = 0; i != rules.size(); ++ i)
+                left_calls (rules [i].body, calls [i]);
+
+            // Depth-first search for a cycle of left calls.
+            enum class mark { unvisited, active, finished };
+            std::vector <mark> marks (rules.size(), mark::unvisited);
+            for (std::size_t start = 0; start != rules.size(); ++ start) {
+                if (marks [start] != mark::unvisited)
+                    continue;
+                // Stack of (rule, index of the next call to follow).
+                std::vector <std::pair <std::size_t, std::size_t>> stack;
+                stack.push_back (std::make_pair (start, 0));
+                marks [start] = mark::active;
+                while (!stack.empty()) {
+                    std::size_t current = stack.back().first;
+                    std::size_t & next = stack.back().second;
+                    if (next == calls [current].size()) {
+                        marks [current] = mark::finished;
+                        stack.pop_back();
+                        continue;
+                    }
+                    std::size_t callee = calls [current][next];
+                    ++ next;
+                    if (marks [callee] == mark::active) {
+                        throw rule_error (rules [callee], "Rule "
+                            + rules [callee].name + " is left-recursive");
+                    }
+                    if (marks [callee] == mark::unvisited) {
+                        marks [callee] = mark::active;
+                        stack.push_back (std::make_pair (callee, 0));
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+    Emit the code for expressions.
+    */
+    class emitter {
+        lowering & l;
+        std::map <std::string, lowering::label> const & labels;
+
+    public:
+        emitter (lowering & l,
+            std::map <std::string, lowering::label> const & labels)
+        : l (l), labels (labels) {}
+
+        void emit (expression const & e) {
+            typedef expression::kind kind;
+            switch (e.type) {
+            case kind::any:
+                l.any ("");
+                break;
+            case kind::literal:
+                l.string (e.text, "");
+                break;
+            case kind::set:
+                l.set (e.set, "");
+                break;
+            case kind::rule:
+                // The checker has made sure that the rule is defined.
+                l.call (labels.find (e.text)->second);
+                break;
+            case kind::sequence:
+                for (expression const & child : e.children)
+                    emit (child);
+                break;
+            case kind::choice:
+                {
+                    auto done = l.new_label();
+                    for (std::size_t index = 0;
+                        index + 1 < e.children.size(); ++ index)
+                    {
+                        auto next = l.new_label();
+                        l.choice (next);
+                        emit (e.children [index]);
+                        l.commit (done);
+                        l.place (next);
+                    }
+                    emit (e.children.back());
+                    l.place (done);
+                }
+                break;
+            case kind::zero_or_more:
+            case kind::one_or_more:
+            case kind::optional:
+                l.repeat (e.type == kind::one_or_more ? 1 : 0,
+                    e.type == kind::optional ? 1 : -1,
+                    [] {}, [&] { this->emit (e.children.front()); });
+                break;
+            case kind::not_:
+                {
+                    auto done = l.new_label();
+                    l.choice (done);
+                    emit (e.children.front());
+                    l.fail_twice();
+                    l.place (done);
+                }
+                break;
+            case kind::and_:
+                {
+                    // Equivalent to !!e.
+                    expression inner (kind::not_);
+                    inner.children.push_back (e.children.front());
+                    expression outer (kind::not_);
+                    outer.children.push_back (std::move (inner));
+                    emit (outer);
+                }
+                break;
+            }
+        }
+    };
+
+} // namespace peg_detail
+
+/**
+Compile a grammar in PEG notation into a program.
+\param grammar The text of the grammar.
+\param start The name of the start rule.
+    If this is empty, the first rule is used.
+\throw grammar_error if the grammar cannot be read, if a rule is defined
+    twice, if an undefined rule is used, or if the grammar may not
+    terminate, in which cases the grammar_error contains a grammar_rule; or
+    if the start rule is not defined, in which case it contains no
+    grammar_line.
+*/
+inline program compile_peg (std::string const & grammar,
+    std::string const & start = std::string())
+{
+    peg_detail::rules_type rules = peg_detail::reader (grammar).rules();
+    peg_detail::checker (rules).check();
+
+    lowering l;
+    std::map <std::string, lowering::label> labels;
+    for (peg_detail::rule_definition const & rule : rules)
+        labels [rule.name] = l.new_label();
+
+    auto start_rule = labels.find (start.empty() ? rules.front().name : start);
+    if (start_rule == labels.end())
+        throw grammar_error() << error_description ("Undefined rule: " + start);
+    auto done = l.new_label();
+    l.call (start_rule->second);
+    l.jump (done);
+
+    peg_detail::emitter emitter (l, labels);
+    for (peg_detail::rule_definition const & rule : rules) {
+        l.place (labels [rule.name]);
+        // Failures are described by the name of the rule.
+        l.push_name (rule.name.c_str());
+        emitter.emit (rule.body);
+        l.pop_name();
+        l.return_();
+    }
+    l.place (done);
+    return l.finish();
+}
+
+} // namespace bytecode
+
+/**
+\return A parser that parses with a grammar in PEG notation, read at run time.
+Its output is void.
+\throw bytecode::grammar_error if the grammar cannot be read.
+*/
+inline bytecode_parser peg (std::string const & grammar,
+    std::string const & start = std::string())
+{ return bytecode_parser (bytecode::compile_peg (grammar, start)); }
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_BYTECODE_PEG_HPP_INCLUDED
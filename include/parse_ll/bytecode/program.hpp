@@ -0,0 +1,295 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a flat representation of a grammar as a list of instructions for a
+simple virtual machine, and its serialisation.
+*/
+
+#ifndef PARSE_LL_BYTECODE_PROGRAM_HPP_INCLUDED
+#define PARSE_LL_BYTECODE_PROGRAM_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <bitset>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+#include <boost/exception/all.hpp>
+
+#include "../core/error.hpp"
+
+namespace parse_ll { namespace bytecode {
+
+/**
+Exception that is thrown when a serialised program cannot be read, or does
+not make sense.
+*/
+struct format_error
+: public virtual boost::exception, public virtual std::exception {};
+
+/**
+Operation codes.
+The virtual machine keeps the current input, the current instruction, and a
+stack of entries that are either backtrack points (an instruction and an
+input) or return addresses.
+"Fail" means: pop entries until a backtrack point is found, restore its input
+and continue at its instruction; if the stack runs out, the parse fails.
+*/
+enum class opcode : std::uint8_t {
+    /// Consume any one character.
+    any,
+    /// Consume the character "argument".
+    character,
+    /// Consume a character in set "argument".
+    set,
+    /// Consume string "argument".
+    string,
+    /// Succeed only at the end of the input.
+    end_of_input,
+    /// Fail.
+    fail,
+    /// Continue at "argument".
+    jump,
+    /// Push a backtrack point to "argument" with the current input.
+    choice,
+    /// Pop the backtrack point and continue at "argument".
+    commit,
+    /// Set the input of the backtrack point to the current input, and
+    /// continue at "argument".
+    partial_commit,
+    /// Pop the backtrack point and fail.
+    fail_twice,
+    /// Push a return address and continue at "argument".
+    call,
+    /// Pop the return address and continue there.
+    return_,
+    /// Throw parse_ll::error at the current input.
+    expect,
+    /// Stop: the parse has succeeded.
+    halt
+};
+
+/**
+\return The name of the opcode, as used in the serialised format.
+*/
+inline const char * opcode_name (opcode code) {
+    static const char * const names[] = { "any", "character", "set",
+        "string", "end_of_input", "fail", "jump", "choice", "commit",
+        "partial_commit", "fail_twice", "call", "return", "expect", "halt" };
+    return names [std::size_t (code)];
+}
+
+static const std::size_t opcode_num = std::size_t (opcode::halt) + 1;
+
+/**
+Whether the argument of the opcode is the address of an instruction.
+*/
+inline bool has_address (opcode code) {
+    return code == opcode::jump || code == opcode::choice
+        || code == opcode::commit || code == opcode::partial_commit
+        || code == opcode::call;
+}
+
+/**
+One instruction of the virtual machine.
+"description" is an index into program::descriptions, and describes what the
+instruction expects.
+*/
+struct instruction {
+    opcode code;
+    std::uint32_t argument;
+    std::uint32_t description;
+
+    instruction (opcode code, std::uint32_t argument,
+        std::uint32_t description)
+    : code (code), argument (argument), description (description) {}
+};
+
+/**
+Program for the virtual machine.
+It starts at the first instruction.
+The tables contain the strings, character sets and descriptions that
+instructions refer to by index.
+*/
+struct program {
+    std::vector <instruction> instructions;
+    std::vector <std::string> strings;
+    std::vector <std::bitset <256>> sets;
+    std::vector <std::string> descriptions;
+
+    /**
+    Check that the instructions only refer to existing instructions and table
+    entries, and that the program cannot run off its end.
+    Whether the instructions use the stack consistently is only checked by
+    run(), as it goes.
+    \throw format_error if not.
+    */
+    void verify() const;
+
+    /**
+    Write the program in a versioned text format that read() can read back.
+    */
+    void write (std::ostream & stream) const;
+
+    /**
+    Read a program written by write().
+    \throw format_error if the stream does not contain a valid program.
+    */
+    static program read (std::istream & stream);
+};
+
+namespace program_detail {
+
+    inline format_error error (std::string const & description) {
+        return format_error() << error_description (description);
+    }
+
+    inline void write_string (std::ostream & stream, std::string const & s)
+    { stream << s.size() << ' ' << s << '\n'; }
+
+    /**
+    Number of bytes that read_string() reads at a time.
+    The size in the stream is not trusted, so that a corrupt size does not
+    cause a huge allocation before the stream runs out.
+    */
+    static const std::size_t string_chunk_size = 4096;
+
+    inline std::string read_string (std::istream & stream) {
+        std::size_t size;
+        if (!(stream >> size) || stream.get() != ' ')
+            throw error ("Expected a string");
+        std::string result;
+        while (result.size() != size) {
+            std::size_t chunk = std::min (size - result.size(),
+                string_chunk_size);
+            std::size_t old_size = result.size();
+            result.resize (old_size + chunk);
+            if (!stream.read (&result [old_size], chunk))
+                throw error ("String is cut off");
+        }
+        if (stream.get() != '\n')
+            throw error ("Expected the end of a string");
+        return result;
+    }
+
+    inline std::size_t read_count (std::istream & stream,
+        std::string const & expected_name)
+    {
+        std::string name;
+        std::size_t count;
+        if (!(stream >> name >> count) || name != expected_name)
+            throw error ("Expected the number of " + expected_name);
+        // Skip the end of the line.
+        if (stream.get() != '\n')
+            throw error ("Expected the end of a line");
+        return count;
+    }
+
+    static const char * const header = "parse_ll bytecode 1";
+
+} // namespace program_detail
+
+inline void program::verify() const {
+    using program_detail::error;
+    if (instructions.empty() || instructions.back().code != opcode::halt)
+        throw error ("The program must end with halt");
+    for (instruction const & i : instructions) {
+        if (std::size_t (i.code) >= opcode_num)
+            throw error ("Unknown opcode");
+        if (i.description >= descriptions.size())
+            throw error ("Description out of range");
+        if (has_address (i.code) && i.argument >= instructions.size())
+            throw error ("Address out of range");
+        if (i.code == opcode::set && i.argument >= sets.size())
+            throw error ("Set out of range");
+        if (i.code == opcode::string && i.argument >= strings.size())
+            throw error ("String out of range");
+    }
+}
+
+inline void program::write (std::ostream & stream) const {
+    using program_detail::write_string;
+    stream << program_detail::header << '\n';
+    stream << "strings " << strings.size() << '\n';
+    for (std::string const & s : strings)
+        write_string (stream, s);
+    stream << "sets " << sets.size() << '\n';
+    for (std::bitset <256> const & set : sets)
+        stream << set << '\n';
+    stream << "descriptions " << descriptions.size() << '\n';
+    for (std::string const & description : descriptions)
+        write_string (stream, description);
+    stream << "instructions " << instructions.size() << '\n';
+    for (instruction const & i : instructions) {
+        stream << opcode_name (i.code) << ' ' << i.argument << ' '
+            << i.description << '\n';
+    }
+}
+
+inline program program::read (std::istream & stream) {
+    using program_detail::error;
+    using program_detail::read_count;
+    using program_detail::read_string;
+
+    std::string header;
+    if (!std::getline (stream, header) || header != program_detail::header)
+        throw error ("Not a parse_ll bytecode program of a known version");
+
+    program result;
+    std::size_t string_num = read_count (stream, "strings");
+    for (std::size_t index = 0; index != string_num; ++ index)
+        result.strings.push_back (read_string (stream));
+
+    std::size_t set_num = read_count (stream, "sets");
+    for (std::size_t index = 0; index != set_num; ++ index) {
+        std::bitset <256> set;
+        if (!(stream >> set))
+            throw error ("Expected a set");
+        result.sets.push_back (set);
+    }
+
+    std::size_t description_num = read_count (stream, "descriptions");
+    for (std::size_t index = 0; index != description_num; ++ index)
+        result.descriptions.push_back (read_string (stream));
+
+    // The number of instructions is not trusted, so no space is reserved.
+    std::size_t instruction_num = read_count (stream, "instructions");
+    for (std::size_t index = 0; index != instruction_num; ++ index) {
+        std::string name;
+        std::uint32_t argument, description;
+        if (!(stream >> name >> argument >> description))
+            throw error ("Expected an instruction");
+        std::size_t code = 0;
+        while (code != opcode_num && name != opcode_name (opcode (code)))
+            ++ code;
+        if (code == opcode_num)
+            throw error ("Unknown opcode: " + name);
+        result.instructions.push_back (
+            instruction (opcode (code), argument, description));
+    }
+
+    result.verify();
+    return result;
+}
+
+}} // namespace parse_ll::bytecode
+
+#endif  // PARSE_LL_BYTECODE_PROGRAM_HPP_INCLUDED
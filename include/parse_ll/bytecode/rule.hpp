@@ -0,0 +1,206 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Allow rules to be lowered into bytecode.
+
+A rule hides the type of its parser, so lowering it needs a virtual function
+that is generated when the rule is initialised.
+Only rules that are initialised with lowerable (parser) get one, so that
+rules that are never lowered do not generate the code for lowering.
+*/
+
+#ifndef PARSE_LL_BYTECODE_RULE_HPP_INCLUDED
+#define PARSE_LL_BYTECODE_RULE_HPP_INCLUDED
+
+#include <utility>
+
+#include "utility/returns.hpp"
+
+#include "../core/core.hpp"
+#include "../core/rule.hpp"
+
+#include "lowering.hpp"
+
+namespace parse_ll {
+
+namespace bytecode {
+
+    /**
+    Wrapper around a parser that makes a rule that it is assigned to
+    lowerable.
+    It otherwise behaves exactly like the parser it contains.
+    */
+    template <class SubParser> struct lowerable_parser
+    : public parser_base <lowerable_parser <SubParser>>
+    {
+        SubParser sub_parser;
+    public:
+        explicit lowerable_parser (SubParser const & sub_parser)
+        : sub_parser (sub_parser) {}
+    };
+
+    /**
+    \return A wrapper around parser that a rule can be initialised with so
+    that it can be lowered into bytecode.
+    \code
+    parse_ll::rule <input_type> pairs = bytecode::lowerable (*pair);
+    \endcode
+    */
+    template <class Parser> inline
+        lowerable_parser <typename std::decay <Parser>::type>
+        lowerable (Parser const & parser)
+    { return lowerable_parser <typename std::decay <Parser>::type> (parser); }
+
+    /**
+    Policy that parsers inside a rule are lowered with.
+    */
+    class rule_lowering_policy : public parse_policy::direct {
+        skip_subroutine skip_parser_;
+    public:
+        explicit rule_lowering_policy (lowering::label skip)
+        : skip_parser_ (skip_subroutine {skip}) {}
+
+        skip_subroutine const & skip_parser() const { return skip_parser_; }
+    };
+
+    /**
+    Interface of rule implementations that can be lowered.
+    */
+    class polymorphic_lowerable {
+    public:
+        virtual ~polymorphic_lowerable() {}
+
+        /**
+        Lower the parser in the rule, with the skip parser outside the rule
+        at label "skip".
+        */
+        virtual void lower (lowering & l, lowering::label skip) const = 0;
+    };
+
+    template <class Input, class Output, class SkipParser, class Parser>
+        class lowerable_implementation
+    : public detail::polymorphic_parser_implementation <
+        Input, Output, SkipParser, Parser>,
+        public polymorphic_lowerable
+    {
+        typedef detail::polymorphic_parser_implementation <
+            Input, Output, SkipParser, Parser> base;
+    public:
+        explicit lowerable_implementation (Parser const & parser)
+        : base (parser) {}
+
+        virtual void lower (lowering & l, lowering::label skip) const
+        { l.lower (rule_lowering_policy (skip), this->parser); }
+    };
+
+    /**
+    \return The label of the skip parser that the parser inside a rule is
+    lowered with.
+    */
+    template <class SkipParser> struct rule_skip_label {
+        template <class Policy> lowering::label operator() (
+            lowering & l, Policy const & outside_policy) const
+        { return l.skip_label (outside_policy.skip_parser()); }
+    };
+
+    // The rule provides its own skip parser.
+    template <> struct rule_skip_label <rule_explicit_skip_parser> {
+        template <class Policy> lowering::label operator() (
+            lowering &, Policy const &) const
+        { return lowering::no_label; }
+    };
+
+} // namespace bytecode
+
+namespace detail {
+
+    template <class Input, class Output, class SkipParser, class Parser>
+        struct make_polymorphic_parser <Input, Output, SkipParser,
+            bytecode::lowerable_parser <Parser>>
+    {
+        static polymorphic_parser <Input, Output, SkipParser> * apply (
+            bytecode::lowerable_parser <Parser> const & parser)
+        {
+            return new bytecode::lowerable_implementation <
+                Input, Output, SkipParser, Parser> (parser.sub_parser);
+        }
+    };
+
+} // namespace detail
+
+struct lowerable_parser_tag;
+template <class SubParser>
+    struct decayed_parser_tag <bytecode::lowerable_parser <SubParser>>
+{ typedef lowerable_parser_tag type; };
+
+namespace operation {
+
+    template <> struct parse <lowerable_parser_tag> {
+        template <class Policy, class Parser, class Input>
+            auto operator() (Policy const & policy, Parser const & parser,
+                Input const & input) const
+        RETURNS (::parse_ll::parse (policy, parser.sub_parser, input));
+    };
+
+    template <> struct describe <lowerable_parser_tag> {
+        template <class Parser> auto operator() (Parser const & parser) const
+        RETURNS (::parse_ll::describe (parser.sub_parser));
+    };
+
+    template <> struct lower <lowerable_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        { lowering.lower (policy, parser.sub_parser); }
+    };
+
+    /**
+    Lower a rule into a subroutine, once for every skip parser it is used
+    with, so that recursive rules become recursive calls.
+    The rule must have been initialised with bytecode::lowerable.
+    */
+    template <> struct lower <rule_tag> {
+        template <class Policy, class Input, class Output, class SkipParser>
+            void operator() (bytecode::lowering & lowering,
+                Policy const & outside_policy,
+                rule <Input, Output, SkipParser> const & parser) const
+        {
+            if (!parser.implementation) {
+                throw bytecode::lowering_error() << error_description (
+                    "Cannot lower a rule that has not been initialised");
+            }
+            auto lowerable = dynamic_cast <
+                bytecode::polymorphic_lowerable const *> (
+                    parser.implementation.get());
+            if (!lowerable) {
+                throw bytecode::lowering_error() << error_description (
+                    "Cannot lower a rule that was not initialised with "
+                    "bytecode::lowerable");
+            }
+            bytecode::lowering::label skip
+                = bytecode::rule_skip_label <SkipParser>() (
+                    lowering, outside_policy);
+            lowering.call (parser.implementation.get(), skip,
+                [&] { lowerable->lower (lowering, skip); });
+        }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_BYTECODE_RULE_HPP_INCLUDED
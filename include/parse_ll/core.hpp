@@ -28,6 +28,7 @@ Include everything from "core".
 // Terminal parsers
 #include "core/literal.hpp"
 #include "core/char.hpp"
+#include "core/char_class.hpp"
 #include "core/nothing.hpp"
 #include "core/end.hpp"
 
@@ -38,8 +39,13 @@ Include everything from "core".
 // Structured parsers
 #include "core/alternative.hpp"
 #include "core/difference.hpp"
+#include "core/list.hpp"
 #include "core/optional.hpp"
 #include "core/repeat.hpp"
+#include "core/collect.hpp"
+#include "core/counted.hpp"
+#include "core/fixed_repeat.hpp"
+#include "core/fold.hpp"
 #include "core/sequence.hpp"
 #include "core/transform.hpp"
 
@@ -47,6 +53,9 @@ Include everything from "core".
 #include "core/named.hpp"
 #include "core/error.hpp"
 #include "core/rule.hpp"
+#include "core/static_rule.hpp"
+#include "core/compiled_grammar.hpp"
+#include "core/optimize.hpp"
 #include "core/whitespace.hpp"
 
 #endif  // PARSE_LL_BASE_HPP_INCLUDED
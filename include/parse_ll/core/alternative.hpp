@@ -22,8 +22,14 @@ parsers until one of them succeeds.
 #ifndef PARSE_LL_ALTERNATIVE_HPP_INCLUDED
 #define PARSE_LL_ALTERNATIVE_HPP_INCLUDED
 
+#include <utility>
 #include <type_traits>
 
+#include <boost/mpl/if.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/blank.hpp>
+#include <boost/variant.hpp>
+
 #include "utility/returns.hpp"
 
 #include "fwd.hpp"
@@ -31,8 +37,6 @@ parsers until one of them succeeds.
 
 #include "outcome.hpp"
 
-#include <boost/variant.hpp>
-
 namespace parse_ll {
 
 template <class Parser1, class Parser2> struct alternative_parser
@@ -41,7 +45,8 @@ template <class Parser1, class Parser2> struct alternative_parser
     Parser1 parser_1;
     Parser2 parser_2;
 public:
-    alternative_parser (Parser1 const & parser_1, Parser2 const & parser_2)
+    constexpr alternative_parser (
+        Parser1 const & parser_1, Parser2 const & parser_2)
     : parser_1 (parser_1), parser_2 (parser_2) {}
 };
 
@@ -50,6 +55,16 @@ template <class Parser1, class Parser2>
     struct decayed_parser_tag <alternative_parser <Parser1, Parser2>>
 { typedef alternative_parser_tag type; };
 
+template <class Parser1, class Parser2>
+    struct always_succeeds <alternative_parser <Parser1, Parser2>>
+: properties_detail::either_always_succeeds <Parser1, Parser2> {};
+template <class Parser1, class Parser2>
+    struct never_consumes <alternative_parser <Parser1, Parser2>>
+: properties_detail::both_never_consume <Parser1, Parser2> {};
+template <class Parser1, class Parser2>
+    struct may_be_empty <alternative_parser <Parser1, Parser2>>
+: properties_detail::either_may_be_empty <Parser1, Parser2> {};
+
 template <class... Parsers> struct make_alternative;
 
 /**
@@ -102,6 +117,132 @@ RETURNS (alternative (
     alternative_parser <Parser1, Parser2> (parser_1, parser_2), parsers...));
 */
 
+/**
+Alternative parser whose output is a boost::variant of the outputs of the two
+sub-parsers, instead of their common type.
+This is useful if the outputs of the sub-parsers are unrelated.
+A void output is represented as boost::blank.
+The outputs of the sub-parsers must have different types.
+\sa variant_alternative
+*/
+template <class Parser1, class Parser2> struct variant_alternative_parser
+: parser_base <variant_alternative_parser <Parser1, Parser2> >
+{
+    Parser1 parser_1;
+    Parser2 parser_2;
+public:
+    constexpr variant_alternative_parser (
+        Parser1 const & parser_1, Parser2 const & parser_2)
+    : parser_1 (parser_1), parser_2 (parser_2) {}
+};
+
+struct variant_alternative_parser_tag;
+template <class Parser1, class Parser2>
+    struct decayed_parser_tag <variant_alternative_parser <Parser1, Parser2>>
+{ typedef variant_alternative_parser_tag type; };
+
+template <class Parser1, class Parser2>
+    struct always_succeeds <variant_alternative_parser <Parser1, Parser2>>
+: properties_detail::either_always_succeeds <Parser1, Parser2> {};
+template <class Parser1, class Parser2>
+    struct never_consumes <variant_alternative_parser <Parser1, Parser2>>
+: properties_detail::both_never_consume <Parser1, Parser2> {};
+template <class Parser1, class Parser2>
+    struct may_be_empty <variant_alternative_parser <Parser1, Parser2>>
+: properties_detail::either_may_be_empty <Parser1, Parser2> {};
+
+/**
+variant_alternative (p1, p2) is like p1 | p2, but its output is a
+boost::variant of the outputs of p1 and p2.
+*/
+template <class Parser1, class Parser2> constexpr
+    variant_alternative_parser <Parser1, Parser2>
+    variant_alternative (Parser1 const & parser_1, Parser2 const & parser_2)
+{ return variant_alternative_parser <Parser1, Parser2> (parser_1, parser_2); }
+
+namespace alternative_detail {
+
+    /**
+    Wrap the outcome of one of the sub-parsers, so that the types in the
+    variant are distinct even if the sub-parsers have the same outcome type.
+    */
+    template <int index, class Outcome> struct branch {
+        Outcome outcome;
+    public:
+        explicit branch (Outcome && outcome) : outcome (std::move (outcome)) {}
+    };
+
+    template <class Output> struct variant_element
+    { typedef typename std::decay <Output>::type type; };
+    template <> struct variant_element <void>
+    { typedef boost::blank type; };
+
+} // namespace alternative_detail
+
+/**
+Outcome of an alternative parser.
+It keeps the outcome of the sub-parser that succeeded, in a variant, and
+forwards success(), output() and rest() to it.
+The output of the sub-parser is therefore only produced when output() is
+called, and then converted to Output.
+If neither sub-parser succeeded, the variant contains "failed".
+*/
+template <class Output, class Policy, class Parser1, class Parser2,
+    class Input>
+struct alternative_outcome {
+    typedef alternative_detail::branch <1, typename
+        detail::parser_outcome <Policy, Parser1, Input>::type> branch_1_type;
+    typedef alternative_detail::branch <2, typename
+        detail::parser_outcome <Policy, Parser2, Input>::type> branch_2_type;
+    typedef boost::variant <failed, branch_1_type, branch_2_type> winner_type;
+
+    winner_type winner;
+
+private:
+    static winner_type parse_winner (Policy const & policy,
+        Parser1 const & parser_1, Parser2 const & parser_2,
+        Input const & input)
+    {
+        {
+            // Try parser 1
+            auto outcome_1 = parse_ll::parse (policy, parser_1, input);
+            if (::parse_ll::success (outcome_1))
+                return winner_type (branch_1_type (std::move (outcome_1)));
+            // Failed; destruct outcome_1.
+        }
+        // Try parser 2
+        auto outcome_2 = parse_ll::parse (policy, parser_2, input);
+        if (::parse_ll::success (outcome_2))
+            return winner_type (branch_2_type (std::move (outcome_2)));
+        // Otherwise, fail.
+        return winner_type (failed());
+    }
+
+public:
+    alternative_outcome (Policy const & policy, Parser1 const & parser_1,
+        Parser2 const & parser_2, Input const & input)
+    : winner (parse_winner (policy, parser_1, parser_2, input)) {}
+};
+
+/**
+Outcome of an alternative parser whose first sub-parser always succeeds.
+The second sub-parser would never be used, so this keeps only the outcome of
+the first, and success() returns rime::true_type.
+*/
+template <class Output, class Policy, class Parser1, class Input>
+struct alternative_first_outcome {
+    typedef alternative_detail::branch <1, typename
+        detail::parser_outcome <Policy, Parser1, Input>::type> branch_1_type;
+
+    branch_1_type branch_1;
+
+public:
+    template <class Parser2>
+        alternative_first_outcome (Policy const & policy,
+            Parser1 const & parser_1, Parser2 const &, Input const & input)
+    : branch_1 (parse_ll::parse (policy, parser_1, input)) {}
+};
+
 namespace operation {
 
     template <> struct parse <alternative_parser_tag> {
@@ -112,16 +253,16 @@ namespace operation {
                 >::type outcome_1_type;
             typedef typename detail::parser_outcome <Policy, Parser2, Input
                 >::type outcome_2_type;
-            typedef typename detail::outcome_output <outcome_1_type>::type
-                output_1_type;
-            typedef typename detail::outcome_output <outcome_2_type>::type
-                output_2_type;
 
             typedef typename std::decay <decltype (true ?
                     ::parse_ll::output (std::declval <outcome_1_type>()) :
                     ::parse_ll::output (std::declval <outcome_2_type>()))
                 >::type output_type;
-            typedef explicit_outcome <output_type, Input> type;
+            typedef typename boost::mpl::if_ <always_succeeds <Parser1>,
+                alternative_first_outcome <output_type, Policy, Parser1, Input>,
+                alternative_outcome <
+                    output_type, Policy, Parser1, Parser2, Input>
+            >::type type;
         };
 
         template <class Policy, class Parser1, class Parser2, class Input>
@@ -130,22 +271,42 @@ namespace operation {
             alternative_parser <Parser1, Parser2> const & parser,
             Input const & input) const
         {
-            typedef typename result <Policy, Parser1, Parser2, Input>::type
-                result_type;
-            {
-                // Try parser 1
-                auto outcome_1 =
-                    parse_ll::parse (policy, parser.parser_1, input);
-                if (::parse_ll::success (outcome_1))
-                    return result_type (std::move (outcome_1));
-                // Failed; destruct outcome_1.
-            }
-            // Try parser 2
-            auto outcome_2 = parse_ll::parse (policy, parser.parser_2, input);
-            if (::parse_ll::success (outcome_2))
-                return result_type (std::move (outcome_2));
-            // Otherwise, fail.
-            return failed();
+            return typename result <Policy, Parser1, Parser2, Input>::type (
+                policy, parser.parser_1, parser.parser_2, input);
+        }
+    };
+
+    template <> struct parse <variant_alternative_parser_tag> {
+        template <class Policy, class Parser1, class Parser2, class Input>
+            struct result
+        {
+            typedef typename alternative_detail::variant_element <
+                    typename detail::parser_output <Policy, Parser1, Input
+                >::type>::type output_1_type;
+            typedef typename alternative_detail::variant_element <
+                    typename detail::parser_output <Policy, Parser2, Input
+                >::type>::type output_2_type;
+            static_assert (!std::is_same <output_1_type, output_2_type>::value,
+                "variant_alternative (p1, p2): the outputs of p1 and p2 must "
+                "have different types. Use p1 | p2 instead.");
+
+            typedef boost::variant <output_1_type, output_2_type>
+                output_type;
+            typedef typename boost::mpl::if_ <always_succeeds <Parser1>,
+                alternative_first_outcome <output_type, Policy, Parser1, Input>,
+                alternative_outcome <
+                    output_type, Policy, Parser1, Parser2, Input>
+            >::type type;
+        };
+
+        template <class Policy, class Parser1, class Parser2, class Input>
+            typename result <Policy, Parser1, Parser2, Input>::type
+        operator() (Policy const & policy,
+            variant_alternative_parser <Parser1, Parser2> const & parser,
+            Input const & input) const
+        {
+            return typename result <Policy, Parser1, Parser2, Input>::type (
+                policy, parser.parser_1, parser.parser_2, input);
         }
     };
 
@@ -154,6 +315,174 @@ namespace operation {
         { return "alternative"; }
     };
 
+    template <> struct describe <variant_alternative_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "variant alternative"; }
+    };
+
+    namespace alternative_detail {
+
+        struct lower {
+            template <class Lowering, class Policy, class Parser>
+                void operator() (Lowering & lowering, Policy const & policy,
+                    Parser const & parser) const
+            {
+                auto second = lowering.new_label();
+                auto done = lowering.new_label();
+                lowering.choice (second);
+                lowering.lower (policy, parser.parser_1);
+                lowering.commit (done);
+                lowering.place (second);
+                lowering.lower (policy, parser.parser_2);
+                lowering.place (done);
+            }
+        };
+
+    } // namespace alternative_detail
+
+    template <> struct lower <alternative_parser_tag>
+    : alternative_detail::lower {};
+
+    template <> struct lower <variant_alternative_parser_tag>
+    : alternative_detail::lower {};
+
+    template <class Output, class Policy, class Parser1, class Parser2,
+            class Input>
+        struct success <alternative_outcome <
+            Output, Policy, Parser1, Parser2, Input>>
+    {
+        bool operator() (alternative_outcome <
+            Output, Policy, Parser1, Parser2, Input> const & outcome) const
+        { return outcome.winner.which() != 0; }
+    };
+
+    namespace alternative_detail {
+
+        /**
+        Convert the output of a branch into Output.
+        */
+        template <class Output> struct convert_output {
+            template <class Branch>
+                Output operator() (Branch const & branch) const
+            { return Output (::parse_ll::output (branch.outcome)); }
+
+            template <class Branch>
+                Output operator() (Branch && branch) const
+            { return Output (::parse_ll::output (std::move (branch.outcome))); }
+        };
+
+        // A void output becomes boost::blank.
+        template <class ... Types>
+            struct convert_output <boost::variant <Types ...>>
+        {
+            typedef boost::variant <Types ...> result_type;
+
+            template <class Branch, class Outcome = decltype (
+                std::declval <Branch const &>().outcome)>
+                typename boost::enable_if <std::is_same <void,
+                    typename detail::outcome_output <Outcome const &>::type>,
+                result_type>::type
+            operator() (Branch const &) const
+            { return result_type (boost::blank()); }
+
+            template <class Branch, class Outcome = decltype (
+                std::declval <Branch const &>().outcome)>
+                typename boost::disable_if <std::is_same <void,
+                    typename detail::outcome_output <Outcome const &>::type>,
+                result_type>::type
+            operator() (Branch const & branch) const
+            { return result_type (::parse_ll::output (branch.outcome)); }
+        };
+
+        template <class Outcome, class Output> struct output {
+            Output operator() (Outcome const & outcome) const {
+                if (auto branch_1 = boost::get <typename Outcome::branch_1_type
+                        > (&outcome.winner))
+                    return convert_output <Output>() (*branch_1);
+                else
+                    return convert_output <Output>() (boost::get <
+                        typename Outcome::branch_2_type> (outcome.winner));
+            }
+
+            Output operator() (Outcome && outcome) const {
+                if (auto branch_1 = boost::get <typename Outcome::branch_1_type
+                        > (&outcome.winner))
+                    return convert_output <Output>() (std::move (*branch_1));
+                else
+                    return convert_output <Output>() (std::move (boost::get <
+                        typename Outcome::branch_2_type> (outcome.winner)));
+            }
+        };
+
+        // void output: not implemented since this should never be called.
+        template <class Outcome> struct output <Outcome, void>
+        { void operator() (Outcome const &) const; };
+
+        template <class Outcome, class Output> struct first_output {
+            Output operator() (Outcome const & outcome) const
+            { return convert_output <Output>() (outcome.branch_1); }
+
+            Output operator() (Outcome && outcome) const {
+                return convert_output <Output>() (
+                    std::move (outcome.branch_1));
+            }
+        };
+
+        template <class Outcome> struct first_output <Outcome, void>
+        { void operator() (Outcome const &) const; };
+
+    } // namespace alternative_detail
+
+    template <class Output, class Policy, class Parser1, class Parser2,
+            class Input>
+        struct output <alternative_outcome <
+            Output, Policy, Parser1, Parser2, Input>>
+    : alternative_detail::output <alternative_outcome <
+        Output, Policy, Parser1, Parser2, Input>, Output> {};
+
+    template <class Output, class Policy, class Parser1, class Input>
+        struct success <alternative_first_outcome <
+            Output, Policy, Parser1, Input>>
+    {
+        rime::true_type operator() (alternative_first_outcome <
+            Output, Policy, Parser1, Input> const &) const
+        { return rime::true_; }
+    };
+
+    template <class Output, class Policy, class Parser1, class Input>
+        struct output <alternative_first_outcome <
+            Output, Policy, Parser1, Input>>
+    : alternative_detail::first_output <alternative_first_outcome <
+        Output, Policy, Parser1, Input>, Output> {};
+
+    template <class Output, class Policy, class Parser1, class Input>
+        struct rest <alternative_first_outcome <
+            Output, Policy, Parser1, Input>>
+    {
+        Input operator() (alternative_first_outcome <
+            Output, Policy, Parser1, Input> const & outcome) const
+        { return ::parse_ll::rest (outcome.branch_1.outcome); }
+    };
+
+    template <class Output, class Policy, class Parser1, class Parser2,
+            class Input>
+        struct rest <alternative_outcome <
+            Output, Policy, Parser1, Parser2, Input>>
+    {
+        typedef alternative_outcome <Output, Policy, Parser1, Parser2, Input>
+            outcome_type;
+
+        Input operator() (outcome_type const & outcome) const {
+            if (auto branch_1 = boost::get <
+                    typename outcome_type::branch_1_type> (&outcome.winner))
+                return ::parse_ll::rest (branch_1->outcome);
+            else
+                return ::parse_ll::rest (boost::get <
+                    typename outcome_type::branch_2_type> (
+                        outcome.winner).outcome);
+        }
+    };
+
 } // namespace operation
 
 } // namespace parse_ll
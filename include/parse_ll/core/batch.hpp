@@ -0,0 +1,251 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a context that parses many small, independent inputs in one go.
+*/
+
+#ifndef PARSE_LL_CORE_BATCH_HPP_INCLUDED
+#define PARSE_LL_CORE_BATCH_HPP_INCLUDED
+
+#include <cstddef>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <type_traits>
+
+#include <boost/optional.hpp>
+
+#include "range/core.hpp"
+
+#include "core.hpp"
+#include "compiled_grammar.hpp"
+
+namespace parse_ll {
+
+/**
+Result of parsing one input of a batch.
+*/
+struct batch_item {
+    bool success;
+    /// The offset of the rest of the input, or 0 if the parse failed.
+    std::size_t rest;
+};
+
+namespace batch_detail {
+
+    /**
+    Storage for the outputs of a batch.
+    The optionals are reused between batches, so that outputs that hold
+    memory can reuse it when they are assigned to.
+    */
+    template <class Output> class output_storage {
+        std::vector <boost::optional <Output>> outputs_;
+    public:
+        typedef Output const & reference;
+
+        void resize (std::size_t size) { outputs_.resize (size); }
+
+        template <class Outcome>
+            void set (std::size_t index, Outcome const & outcome)
+        { outputs_ [index] = ::parse_ll::output (outcome); }
+
+        void reset (std::size_t index) { outputs_ [index] = boost::none; }
+
+        reference get (std::size_t index) const
+        { return *outputs_ [index]; }
+    };
+
+    /**
+    Storage for parsers without output: keep nothing.
+    */
+    template <> class output_storage <void> {
+    public:
+        typedef void reference;
+
+        void resize (std::size_t) {}
+
+        template <class Outcome>
+            void set (std::size_t, Outcome const & outcome)
+        { ::parse_ll::output (outcome); }
+
+        void reset (std::size_t) {}
+
+        void get (std::size_t) const {}
+    };
+
+} // namespace batch_detail
+
+/**
+Context for parsing many small inputs, each independently, with one grammar.
+
+Calling parse() on each input separately sets up the parse and the output
+anew each time.
+This instead keeps the policy and the storage for the results, and reuses
+them for every batch that it is given; parsing a batch is a tight loop over
+the inputs.
+It can also split the batch between threads.
+
+Grammar is a compiled_grammar, which can be used from many threads at the
+same time.
+It must outlive the context.
+Item is the type of each input, for example std::string.
+The range that is parsed is view (item), so that a grammar with rules that
+work on std::string can be used.
+Items must have random-access iterators, so that the offsets of the rest of
+the inputs can be found.
+
+Outputs are copied out of the outcomes, and may refer to the inputs, for
+example if they are ranges; the inputs must then outlive the outputs.
+*/
+template <class Grammar, class Item = std::string,
+    class Policy = parse_policy::direct>
+class batch_context
+{
+public:
+    typedef typename range::result_of <
+        range::callable::view (Item const &)>::type input_type;
+
+    typedef typename std::decay <typename detail::parser_output <
+            Policy const &,
+            decltype (std::declval <Grammar const &>().parser()),
+            input_type>::type>::type
+        output_type;
+
+private:
+    typedef batch_detail::output_storage <output_type> storage_type;
+
+    Grammar const & grammar_;
+    Policy policy_;
+    std::vector <batch_item> items_;
+    storage_type outputs_;
+
+public:
+    explicit batch_context (Grammar const & grammar,
+        Policy const & policy = Policy())
+    : grammar_ (grammar), policy_ (policy) {}
+
+    /**
+    Parse a batch of inputs, and replace the results of the last batch.
+    Items is a container of Item, like std::vector <Item>, that supports
+    size() and operator[].
+
+    \param thread_num
+        The number of threads to split the batch between.
+        With 1, the batch is parsed on the calling thread.
+        Threads are started for each batch, so this is only worth it for
+        batches of thousands of inputs.
+        Actors in the grammar must then be thread-safe.
+
+    If parsing any input throws an exception, the exception is passed on
+    after all threads have stopped, and the results are unspecified.
+    */
+    template <class Items>
+        void parse (Items const & items, std::size_t thread_num = 1)
+    {
+        std::size_t const size = items.size();
+        items_.resize (size);
+        outputs_.resize (size);
+
+        if (thread_num > size / 2)
+            thread_num = size / 2;
+        if (thread_num <= 1) {
+            parse_items (items, 0, size);
+            return;
+        }
+
+        std::size_t const chunk_size = (size + thread_num - 1) / thread_num;
+        std::vector <std::exception_ptr> errors (thread_num);
+        std::vector <std::thread> threads;
+        for (std::size_t thread_index = 1; thread_index != thread_num;
+            ++ thread_index)
+        {
+            std::size_t begin = std::min (size, thread_index * chunk_size);
+            std::size_t end = std::min (size, begin + chunk_size);
+            threads.emplace_back ([&, thread_index, begin, end]() {
+                try {
+                    parse_items (items, begin, end);
+                } catch (...) {
+                    errors [thread_index] = std::current_exception();
+                }
+            });
+        }
+        try {
+            parse_items (items, 0, std::min (size, chunk_size));
+        } catch (...) {
+            errors [0] = std::current_exception();
+        }
+        for (auto & thread : threads)
+            thread.join();
+
+        for (auto const & error : errors)
+            if (error)
+                std::rethrow_exception (error);
+    }
+
+    /**
+    \return The number of inputs in the last batch.
+    */
+    std::size_t size() const { return items_.size(); }
+
+    /**
+    \return The result of parsing input "index" of the last batch.
+    */
+    batch_item const & item (std::size_t index) const
+    { return items_ [index]; }
+
+    bool success (std::size_t index) const
+    { return items_ [index].success; }
+
+    std::size_t rest (std::size_t index) const
+    { return items_ [index].rest; }
+
+    /**
+    \return The output of parsing input "index" of the last batch.
+    \pre success (index).
+    */
+    typename storage_type::reference output (std::size_t index) const
+    { return outputs_.get (index); }
+
+    Policy const & policy() const { return policy_; }
+
+private:
+    template <class Items>
+        void parse_items (Items const & items,
+            std::size_t begin, std::size_t end)
+    {
+        for (std::size_t index = begin; index != end; ++ index) {
+            input_type input = range::view (items [index]);
+            auto outcome = grammar_.parse (policy_, input);
+            if (::parse_ll::success (outcome)) {
+                outputs_.set (index, outcome);
+                items_ [index].success = true;
+                items_ [index].rest = std::size_t (
+                    ::parse_ll::rest (outcome).begin() - input.begin());
+            } else {
+                outputs_.reset (index);
+                items_ [index].success = false;
+                items_ [index].rest = 0;
+            }
+        }
+    }
+};
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_BATCH_HPP_INCLUDED
@@ -37,8 +37,8 @@ template <class Match> struct char_parser
 {
     Match match;
 public:
-    char_parser() {}
-    char_parser (Match const & match) : match (match) {}
+    constexpr char_parser() : match() {}
+    constexpr char_parser (Match const & match) : match (match) {}
 };
 
 struct char_parser_tag;
@@ -104,7 +104,7 @@ struct match_any {
 template <class Char>
 struct match_one {
     Char expected;
-    match_one (Char const & expected) : expected (expected) {}
+    constexpr match_one (Char const & expected) : expected (expected) {}
     bool operator() (Char const & found) const { return found == expected; }
 };
 
@@ -120,9 +120,9 @@ as parsers.
 */
 struct any_char_parser : char_parser <match_any>
 {
-    any_char_parser() {}
+    constexpr any_char_parser() {}
 
-    template <class Char>
+    template <class Char> constexpr
         char_parser <match_one <Char> > operator() (Char const & expected) const
     {
         return char_parser <match_one <Char> > (expected);
@@ -132,7 +132,38 @@ struct any_char_parser : char_parser <match_any>
 template <> struct decayed_parser_tag <any_char_parser>
 { typedef char_parser_tag type; };
 
-static const auto char_ = any_char_parser();
+static constexpr auto char_ = any_char_parser();
+
+namespace operation {
+
+    namespace char_detail {
+
+        template <class Lowering, class Match> inline void lower_match (
+            Lowering & lowering, Match const & match, const char * description)
+        { lowering.set (match, description); }
+
+        template <class Lowering> inline void lower_match (
+            Lowering & lowering, match_any const &, const char * description)
+        { lowering.any (description); }
+
+        template <class Lowering, class Char> inline void lower_match (
+            Lowering & lowering, match_one <Char> const & match,
+            const char * description)
+        { lowering.character (match.expected, description); }
+
+    } // namespace char_detail
+
+    template <> struct lower <char_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const &,
+                Parser const & parser) const
+        {
+            char_detail::lower_match (
+                lowering, parser.match, ::parse_ll::describe (parser));
+        }
+    };
+
+} // namespace operation
 
 } // namespace parse_ll
 
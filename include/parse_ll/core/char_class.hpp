@@ -0,0 +1,142 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a set of characters, and a parser that accepts one character from a
+set and does not output anything.
+*/
+
+#ifndef PARSE_LL_CORE_CHAR_CLASS_HPP_INCLUDED
+#define PARSE_LL_CORE_CHAR_CLASS_HPP_INCLUDED
+
+#include <bitset>
+#include <string>
+
+#include "range/core.hpp"
+
+#include "fwd.hpp"
+#include "core.hpp"
+#include "outcome/failed.hpp"
+#include "outcome/explicit.hpp"
+
+namespace parse_ll {
+
+/**
+Set of characters, kept as a bitset with one bit for each value of char.
+This can be used as the Match of a char_parser.
+Characters of other types only match if they can be represented as a char.
+*/
+class char_class {
+    std::bitset <256> bits_;
+public:
+    char_class() {}
+
+    explicit char_class (std::string const & characters) {
+        for (char c : characters)
+            add (c);
+    }
+
+    /**
+    \return The class of characters c for which match (c) is true.
+    */
+    template <class Match> static char_class matching (Match const & match) {
+        char_class result;
+        for (int code = 0; code != 256; ++ code)
+            result.bits_ [code] = bool (match (static_cast <char> (code)));
+        return result;
+    }
+
+    void add (char c) { bits_.set (static_cast <unsigned char> (c)); }
+
+    bool contains (char c) const
+    { return bits_.test (static_cast <unsigned char> (c)); }
+
+    std::bitset <256> const & bits() const { return bits_; }
+
+    template <class Char> bool operator() (Char const & c) const {
+        return static_cast <Char> (static_cast <char> (c)) == c
+            && contains (static_cast <char> (c));
+    }
+
+    char_class & operator |= (char_class const & other)
+    { bits_ |= other.bits_; return *this; }
+
+    char_class & operator -= (char_class const & other)
+    { bits_ &= ~other.bits_; return *this; }
+};
+
+inline char_class operator | (char_class left, char_class const & right)
+{ return left |= right; }
+
+inline char_class operator - (char_class left, char_class const & right)
+{ return left -= right; }
+
+/**
+Parser that accepts one character from a char_class and outputs nothing.
+It is to char_parser <char_class> what literal ('a') is to char_ ('a').
+*/
+struct one_of_parser : public parser_base <one_of_parser> {
+    char_class characters;
+public:
+    explicit one_of_parser (char_class const & characters)
+    : characters (characters) {}
+};
+
+struct one_of_parser_tag;
+template <> struct decayed_parser_tag <one_of_parser>
+{ typedef one_of_parser_tag type; };
+
+/**
+\return A parser that accepts any one of characters, and outputs nothing.
+*/
+inline one_of_parser one_of (std::string const & characters)
+{ return one_of_parser (char_class (characters)); }
+
+namespace operation {
+
+    template <> struct parse <one_of_parser_tag> {
+        template <class Policy, class Input>
+        explicit_outcome <void, Input> operator() (Policy const &,
+            one_of_parser const & parser, Input const & input) const
+        {
+            if (!::range::empty (input)
+                    && parser.characters (::range::first (input)))
+                return explicit_outcome <void, Input> (::range::drop (input));
+            else
+                return failed();
+        }
+    };
+
+    template <> struct describe <one_of_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "one of"; }
+    };
+
+    template <> struct lower <one_of_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const &,
+                Parser const & parser) const
+        {
+            lowering.set (parser.characters.bits(),
+                ::parse_ll::describe (parser));
+        }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_CHAR_CLASS_HPP_INCLUDED
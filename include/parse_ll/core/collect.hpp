@@ -0,0 +1,196 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a directive that turns a repeat parser into a parser that collects the
+outputs of the sub-parser into a container, in one pass.
+*/
+
+#ifndef PARSE_LL_CORE_COLLECT_HPP_INCLUDED
+#define PARSE_LL_CORE_COLLECT_HPP_INCLUDED
+
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#include "core.hpp"
+#include "repeat.hpp"
+#include "outcome/failed.hpp"
+#include "outcome/explicit.hpp"
+
+namespace parse_ll {
+
+/**
+Parser that parses like repeat_parser <SubParser>, but collects the outputs of
+the sub-parser into a Container while it parses.
+The output is the Container.
+This is produced by collect <Container>() [repeat_parser].
+
+The output of repeat_parser is a lazy range that parses the input again every
+time it is traversed.
+This parser, on the other hand, runs the sub-parser exactly once on every
+element, and its outcome keeps the container.
+Actors in the sub-parser are therefore called during parse().
+
+Like repeat_parser, it uses the skip parser between elements, but not before
+or after them.
+*/
+template <class Container, class SubParser> struct collect_parser
+: parser_base <collect_parser <Container, SubParser>>
+{
+    typedef typename Container::allocator_type allocator_type;
+
+    SubParser sub_parser;
+    int minimum, maximum;
+    allocator_type allocator;
+    // The number of elements to reserve space for, or 0.
+    std::size_t size_hint;
+public:
+    collect_parser (repeat_parser <SubParser> const & repeat,
+        allocator_type const & allocator, std::size_t size_hint)
+    : sub_parser (repeat.sub_parser),
+        minimum (repeat.minimum), maximum (repeat.maximum),
+        allocator (allocator), size_hint (size_hint) {}
+};
+
+struct collect_parser_tag;
+template <class Container, class SubParser>
+    struct decayed_parser_tag <collect_parser <Container, SubParser>>
+{ typedef collect_parser_tag type; };
+
+/**
+Directive that turns a repeat parser into a collect_parser.
+It is normally produced by collect <Container>().
+*/
+template <class Container> class collect_directive {
+public:
+    typedef typename Container::allocator_type allocator_type;
+
+private:
+    allocator_type allocator;
+    std::size_t size_hint;
+
+public:
+    explicit collect_directive (allocator_type const & allocator,
+        std::size_t size_hint = 0)
+    : allocator (allocator), size_hint (size_hint) {}
+
+    /**
+    \return A directive that reserves space for size_hint elements in the
+    container before parsing.
+    This has an effect only if the container has a member function reserve().
+    */
+    collect_directive reserve (std::size_t size_hint) const
+    { return collect_directive (allocator, size_hint); }
+
+    template <class SubParser>
+        collect_parser <Container, SubParser>
+    operator[] (repeat_parser <SubParser> const & repeat) const {
+        return collect_parser <Container, SubParser> (
+            repeat, allocator, size_hint);
+    }
+};
+
+/**
+Collect the outputs of a repeat parser into a container of type Container.
+For example,
+    collect <std::vector <int>>() [*int_]
+outputs a std::vector <int>, and
+    collect <std::vector <int>>().reserve (1000000) [*int_]
+reserves space for a million elements first.
+Container must have a member type allocator_type, and a member function
+insert (position, element), like the standard containers.
+*/
+template <class Container> inline
+    collect_directive <Container> collect (
+        typename Container::allocator_type const & allocator
+            = typename Container::allocator_type())
+{ return collect_directive <Container> (allocator); }
+
+namespace collect_detail {
+
+    template <class Container>
+        auto reserve (Container & container, std::size_t size, int)
+    -> decltype (container.reserve (size), void())
+    { container.reserve (size); }
+
+    // Fallback for containers without reserve().
+    template <class Container>
+        void reserve (Container &, std::size_t, long) {}
+
+} // namespace collect_detail
+
+namespace operation {
+
+    template <> struct parse <collect_parser_tag> {
+        template <class Policy, class Container, class SubParser, class Input>
+            explicit_outcome <Container, Input>
+        operator() (Policy const & policy,
+            collect_parser <Container, SubParser> const & parser,
+            Input const & input) const
+        {
+            static_assert (!std::is_same <typename detail::parser_output <
+                    Policy, SubParser, Input>::type, void>::value,
+                "The sub-parser of collect must have an output.");
+
+            Container container (parser.allocator);
+            if (parser.size_hint != 0)
+                collect_detail::reserve (container, parser.size_hint, 0);
+
+            Input current = input;
+            int count = 0;
+            for (; count != parser.maximum; ++ count) {
+                auto sub_outcome = parse_ll::parse (
+                    policy, parser.sub_parser,
+                    // Only skip in between elements, not before.
+                    (count == 0) ? current : parse_ll::skip_over (
+                        policy.skip_parser(), current));
+                if (!::parse_ll::success (sub_outcome))
+                    break;
+                // Retrieve the rest first, since the output is moved out.
+                Input next = ::parse_ll::rest (sub_outcome);
+                container.insert (container.end(),
+                    ::parse_ll::output (std::move (sub_outcome)));
+                current = std::move (next);
+            }
+            if (count < parser.minimum)
+                return failed();
+            return explicit_outcome <Container, Input> (
+                std::move (container), std::move (current));
+        }
+    };
+
+    template <> struct describe <collect_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "collect"; }
+    };
+
+    // Bytecode has no output, so this is the same as a repeat.
+    template <> struct lower <collect_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        {
+            lowering.repeat (policy, parser.sub_parser,
+                parser.minimum, parser.maximum);
+        }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_COLLECT_HPP_INCLUDED
@@ -0,0 +1,97 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a grammar object that is immutable and can be shared between threads.
+*/
+
+#ifndef PARSE_LL_CORE_COMPILED_GRAMMAR_HPP_INCLUDED
+#define PARSE_LL_CORE_COMPILED_GRAMMAR_HPP_INCLUDED
+
+#include <utility>
+
+#include "utility/returns.hpp"
+
+#include "core.hpp"
+#include "optimize.hpp"
+
+namespace parse_ll {
+
+/**
+Grammar that is immutable once constructed, and that can be used by many
+threads at the same time.
+
+Parsing with it touches no shared mutable state:
+\li parse() only reads the parsers;
+\li outcomes refer to the parsers by pointer, so that rules inside the grammar
+    are not copied and their reference counts are not touched;
+\li rules do not allocate memory when they parse, and do not copy the skip
+    parser from outside.
+
+The grammar itself cannot be copied, since copying rules would touch their
+reference counts.
+Construct it once, for example as a static object, and pass it by reference.
+It can be moved.
+
+Outcomes refer to the grammar, so it must outlive them.
+Outcomes themselves are not thread-safe, since they may cache outputs; they
+should therefore not be shared between threads.
+Actors in the grammar are called from any thread that parses, so they must be
+thread-safe.
+*/
+template <class Parser> class compiled_grammar {
+    Parser parser_;
+public:
+    explicit compiled_grammar (Parser const & parser) : parser_ (parser) {}
+
+    compiled_grammar (compiled_grammar &&) = default;
+    compiled_grammar (compiled_grammar const &) = delete;
+    compiled_grammar & operator = (compiled_grammar const &) = delete;
+    compiled_grammar & operator = (compiled_grammar &&) = delete;
+
+    Parser const & parser() const { return parser_; }
+
+    /**
+    Parse input with the default policy.
+    */
+    template <class Input> auto parse (Input && input) const
+    RETURNS (::parse_ll::parse (parser_, std::forward <Input> (input)));
+
+    /**
+    Parse input with a given policy.
+    */
+    template <class Policy, class Input>
+        auto parse (Policy const & policy, Input && input) const
+    RETURNS (::parse_ll::parse (
+        policy, parser_, std::forward <Input> (input)));
+};
+
+/**
+\return A compiled_grammar that contains an optimised copy of parser, as
+returned by optimize_any_policy (parser).
+*/
+template <class Parser> inline compiled_grammar <
+    typename optimize_detail::rewrite <true, Parser>::type>
+    compile (Parser const & parser)
+{
+    return compiled_grammar <
+        typename optimize_detail::rewrite <true, Parser>::type> (
+            optimize_any_policy (parser));
+}
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_COMPILED_GRAMMAR_HPP_INCLUDED
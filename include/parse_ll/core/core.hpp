@@ -152,6 +152,16 @@ namespace callable {
 
 } // namespace callable
 
+/**
+Parse policies.
+
+Lazy outcomes keep a copy of the policy they were parsed with, and they copy
+it again for every element of a repetition, so policies must be cheap to copy.
+They are therefore handles: any state they need, like a skip parser or the
+state of a trace, lives in the parser, which must outlive the parse and its
+outcomes anyway, and the policy refers to it by pointer.
+A policy should not own containers or reference-counted pointers.
+*/
 namespace parse_policy {
 
     /**
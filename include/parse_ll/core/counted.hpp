@@ -0,0 +1,170 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a parser for length-prefixed sequences: a count followed by that many
+items.
+*/
+
+#ifndef PARSE_LL_CORE_COUNTED_HPP_INCLUDED
+#define PARSE_LL_CORE_COUNTED_HPP_INCLUDED
+
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+#include "core.hpp"
+#include "list.hpp"
+#include "outcome/failed.hpp"
+#include "outcome/explicit.hpp"
+
+namespace parse_ll {
+
+/**
+Parser that first parses a count with CountParser, and then parses exactly
+that many items with ItemParser.
+This is produced by counted (count_parser) [item_parser].
+The output of CountParser must be convertible to std::size_t.
+
+The output is a std::vector of the outputs of ItemParser, with space reserved
+for the number of items beforehand, up to 4096 items, after which the vector
+grows as usual; or void if ItemParser outputs void.
+The count is not trusted, so that a huge count in a short input does not
+cause a huge allocation.
+The parser fails as soon as an item fails to parse, or if the count is
+negative.
+
+The skip parser is used after the count and between items, but not after the
+last item.
+*/
+template <class CountParser, class ItemParser> struct counted_parser
+: parser_base <counted_parser <CountParser, ItemParser>>
+{
+    CountParser count_parser;
+    ItemParser item_parser;
+public:
+    constexpr counted_parser (
+        CountParser const & count_parser, ItemParser const & item_parser)
+    : count_parser (count_parser), item_parser (item_parser) {}
+};
+
+struct counted_parser_tag;
+template <class CountParser, class ItemParser>
+    struct decayed_parser_tag <counted_parser <CountParser, ItemParser>>
+{ typedef counted_parser_tag type; };
+
+template <class CountParser> class counted_directive {
+    CountParser count_parser;
+public:
+    constexpr explicit counted_directive (CountParser const & count_parser)
+    : count_parser (count_parser) {}
+
+    template <class ItemParser>
+        constexpr counted_parser <CountParser, ItemParser>
+            operator[] (ItemParser const & item_parser) const
+    {
+        return counted_parser <CountParser, ItemParser> (
+            count_parser, item_parser);
+    }
+};
+
+/**
+Parse a count with count_parser, and then that many items.
+For example,
+    counted (unsigned_) [int_]
+parses "3 1 2 3" (with a skip parser) into a std::vector <int>.
+*/
+template <class CountParser>
+    constexpr counted_directive <CountParser> counted (
+        CountParser const & count_parser)
+{ return counted_directive <CountParser> (count_parser); }
+
+namespace operation {
+
+    namespace counted_detail {
+
+        template <class Count> inline
+            typename std::enable_if <std::is_signed <Count>::value, bool>::type
+            is_negative (Count const & count)
+        { return count < 0; }
+
+        template <class Count> inline
+            typename std::enable_if <!std::is_signed <Count>::value, bool
+                >::type
+            is_negative (Count const &)
+        { return false; }
+
+        /// The maximum number of items that space is reserved for.
+        static const std::size_t reserve_limit = 4096;
+
+    } // namespace counted_detail
+
+    template <> struct parse <counted_parser_tag> {
+        template <class Policy, class ItemParser, class Input> struct result {
+            typedef list_detail::collector <typename std::decay <
+                    typename detail::parser_output <Policy, ItemParser, Input
+                >::type>::type> collector_type;
+            typedef decltype (std::declval <collector_type>().finish (
+                std::declval <Input>())) type;
+        };
+
+        template <class Policy, class CountParser, class ItemParser,
+            class Input>
+        typename result <Policy, ItemParser, Input>::type
+            operator() (Policy const & policy,
+                counted_parser <CountParser, ItemParser> const & parser,
+                Input const & input) const
+        {
+            auto count_outcome = parse_ll::parse (
+                policy, parser.count_parser, input);
+            if (!::parse_ll::success (count_outcome))
+                return failed();
+            auto count = ::parse_ll::output (count_outcome);
+            if (counted_detail::is_negative (count))
+                return failed();
+            std::size_t item_count = static_cast <std::size_t> (count);
+
+            typename result <Policy, ItemParser, Input>::collector_type
+                collector;
+            collector.reserve (
+                std::min (item_count, counted_detail::reserve_limit));
+
+            Input current = ::parse_ll::rest (count_outcome);
+            for (std::size_t index = 0; index != item_count; ++ index) {
+                auto item_outcome = parse_ll::parse (
+                    policy, parser.item_parser,
+                    parse_ll::skip_over (policy.skip_parser(), current));
+                if (!::parse_ll::success (item_outcome))
+                    return failed();
+                // Retrieve the rest first, since the output is moved out.
+                current = ::parse_ll::rest (item_outcome);
+                collector.add (std::move (item_outcome));
+            }
+            return collector.finish (std::move (current));
+        }
+    };
+
+    template <> struct describe <counted_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "counted"; }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_COUNTED_HPP_INCLUDED
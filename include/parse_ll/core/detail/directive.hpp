@@ -34,7 +34,7 @@ template <class SubParser, class ConvertPolicy> struct change_policy
     SubParser sub_parser;
     ConvertPolicy convert_policy;
 public:
-    change_policy (
+    constexpr change_policy (
         SubParser const & sub_parser, ConvertPolicy const & convert_policy)
     : sub_parser (sub_parser), convert_policy (convert_policy) {}
 };
@@ -44,6 +44,16 @@ template <class SubParser, class ConvertPolicy>
     struct decayed_parser_tag <change_policy <SubParser, ConvertPolicy>>
 { typedef change_policy_tag type; };
 
+template <class SubParser, class ConvertPolicy>
+    struct always_succeeds <change_policy <SubParser, ConvertPolicy>>
+: always_succeeds <SubParser> {};
+template <class SubParser, class ConvertPolicy>
+    struct never_consumes <change_policy <SubParser, ConvertPolicy>>
+: never_consumes <SubParser> {};
+template <class SubParser, class ConvertPolicy>
+    struct may_be_empty <change_policy <SubParser, ConvertPolicy>>
+: may_be_empty <SubParser> {};
+
 namespace operation {
 
     template <> struct parse <change_policy_tag> {
@@ -61,18 +71,29 @@ namespace operation {
         { return "(policy change inside)"; }
     };
 
+    template <> struct lower <change_policy_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & directive) const
+        {
+            lowering.lower (directive.convert_policy (policy),
+                directive.sub_parser);
+        }
+    };
+
 } // namespace operation
 
 template <class ConvertPolicy> struct change_policy_directive {
     ConvertPolicy convert_policy;
 public:
-    explicit change_policy_directive (): convert_policy() {}
+    constexpr explicit change_policy_directive (): convert_policy() {}
 
-    explicit change_policy_directive (ConvertPolicy const & convert_policy)
+    constexpr explicit change_policy_directive (
+        ConvertPolicy const & convert_policy)
     : convert_policy (convert_policy) {}
 
     template <class SubParser>
-        change_policy <SubParser, ConvertPolicy>
+        constexpr change_policy <SubParser, ConvertPolicy>
     operator[] (SubParser const & sub_parser) const {
         return change_policy <SubParser, ConvertPolicy> (
             sub_parser, convert_policy);
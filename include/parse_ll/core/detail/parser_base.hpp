@@ -24,35 +24,42 @@ Base classes for parser.
 #include "range/core.hpp"
 
 #include "../fwd.hpp"
+#include "../properties.hpp"
 
 namespace parse_ll {
 
 /*** parser ***/
 
 template <class Derived> struct parser_base {
-    Derived const * this_() const
+    constexpr Derived const * this_() const
     { return static_cast <Derived const *> (this); }
 
-    repeat_parser <Derived> operator* () const {
+    constexpr repeat_parser <Derived> operator* () const {
+        static_assert (!may_be_empty <Derived>::value,
+            "*p: p can succeed without consuming input, "
+            "so the repetition would never finish.");
         return repeat_parser <Derived> (*this_(), 0, -1);
     }
-    repeat_parser <Derived> operator+ () const {
+    constexpr repeat_parser <Derived> operator+ () const {
+        static_assert (!may_be_empty <Derived>::value,
+            "+p: p can succeed without consuming input, "
+            "so the repetition would never finish.");
         return repeat_parser <Derived> (*this_(), 1, -1);
     }
 
-    optional_parser <Derived> operator- () const {
+    constexpr optional_parser <Derived> operator- () const {
         return optional_parser <Derived> (*this_());
     }
 
     template <class OtherParser>
-        alternative_parser <Derived, OtherParser>
+        constexpr alternative_parser <Derived, OtherParser>
             operator| (OtherParser const & other) const
     {
         return alternative_parser <Derived, OtherParser> (*this_(), other);
     }
 
     template <class OtherParser>
-        sequence_parser <false, Derived, OtherParser>
+        constexpr sequence_parser <false, Derived, OtherParser>
             operator >> (OtherParser const & other) const
     {
         return sequence_parser <false, Derived, OtherParser> (*this_(), other);
@@ -63,21 +70,37 @@ template <class Derived> struct parser_base {
         a > b >> c and (a > b) >> c.
     */
     template <class OtherParser>
-        sequence_parser <true, Derived, OtherParser>
+        constexpr sequence_parser <true, Derived, OtherParser>
             operator > (OtherParser const & other) const
     {
         return sequence_parser <true, Derived, OtherParser> (*this_(), other);
     }
 
     template <class OtherParser>
-        difference_parser <Derived, OtherParser>
+        constexpr difference_parser <Derived, OtherParser>
             operator - (OtherParser const & other) const
     {
         return difference_parser <Derived, OtherParser> (*this_(), other);
     }
 
+    /**
+    Parse a list of one or more elements separated by "separator".
+    \sa list_parser
+    */
+    template <class Separator>
+        constexpr list_parser <Derived, Separator>
+            operator % (Separator const & separator) const
+    {
+        static_assert (!(may_be_empty <Derived>::value
+                && may_be_empty <Separator>::value),
+            "p % s: p and s can both succeed without consuming input, "
+            "so the list would never finish.");
+        return list_parser <Derived, Separator> (*this_(), separator);
+    }
+
     template <class Actor>
-    transform_parser <Derived, Actor> operator[] (Actor const & actor) const {
+    constexpr transform_parser <Derived, Actor>
+        operator[] (Actor const & actor) const {
         return transform_parser <Derived, Actor> (*this_(), actor);
     }
 };
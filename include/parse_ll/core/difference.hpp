@@ -35,7 +35,8 @@ template <class Parser1, class Parser2> struct difference_parser
     Parser1 parser_1;
     Parser2 parser_2;
 public:
-    difference_parser (Parser1 const & parser_1, Parser2 const & parser_2)
+    constexpr difference_parser (
+        Parser1 const & parser_1, Parser2 const & parser_2)
     : parser_1 (parser_1), parser_2 (parser_2) {}
 };
 
@@ -44,6 +45,10 @@ template <class Parser1, class Parser2>
     struct decayed_parser_tag <difference_parser <Parser1, Parser2>>
 { typedef difference_parser_tag type; };
 
+template <class Parser1, class Parser2>
+    struct never_consumes <difference_parser <Parser1, Parser2>>
+: never_consumes <Parser1> {};
+
 /**
 Outcome for difference_parser.
 This tries out parser_2, and if it fails, saves the outcome of parser_1.
@@ -87,6 +92,21 @@ namespace operation {
         { return "difference"; }
     };
 
+    // Parse parser_1 only if parser_2 fails.
+    template <> struct lower <difference_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        {
+            auto first = lowering.new_label();
+            lowering.choice (first);
+            lowering.lower (policy, parser.parser_2);
+            lowering.fail_twice();
+            lowering.place (first);
+            lowering.lower (policy, parser.parser_1);
+        }
+    };
+
     template <class Policy, class Parser1, class Parser2, class Input>
         struct success <difference_outcome <Policy, Parser1, Parser2, Input>>
     {
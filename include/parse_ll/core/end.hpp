@@ -30,12 +30,15 @@ Defines an "end" parser, which only succeeds at the end of the input.
 namespace parse_ll {
 
 struct end_parser : parser_base <end_parser> {};
-static const auto end = end_parser();
+static constexpr auto end = end_parser();
 
 struct end_parser_tag;
 template <> struct decayed_parser_tag <end_parser>
 { typedef end_parser_tag type; };
 
+template <> struct never_consumes <end_parser> : std::true_type {};
+template <> struct may_be_empty <end_parser> : std::true_type {};
+
 namespace operation {
 
     template <> struct parse <end_parser_tag> {
@@ -54,6 +57,13 @@ namespace operation {
         { return "end"; }
     };
 
+    template <> struct lower <end_parser_tag> {
+        template <class Lowering, class Policy> void operator() (
+            Lowering & lowering, Policy const &, end_parser const & parser)
+            const
+        { lowering.end_of_input (::parse_ll::describe (parser)); }
+    };
+
 
 } // namespace operation
 
@@ -32,13 +32,15 @@ namespace parse_ll {
 
 // Parser that always fails.
 struct fail_parser : parser_base <fail_parser> {};
-static const auto fail = fail_parser();
+static constexpr auto fail = fail_parser();
 
 struct fail_parser_tag;
 
 template <> struct decayed_parser_tag <fail_parser>
 { typedef fail_parser_tag type; };
 
+template <> struct never_consumes <fail_parser> : std::true_type {};
+
 namespace operation {
 
     template <> struct parse <fail_parser_tag> {
@@ -57,6 +59,12 @@ namespace operation {
         const char * operator() (fail_parser const &) const { return "fail"; }
     };
 
+    template <> struct lower <fail_parser_tag> {
+        template <class Lowering, class Policy> void operator() (
+            Lowering & lowering, Policy const &, fail_parser const &) const
+        { lowering.fail(); }
+    };
+
 } // namespace operation
 
 } // namespace parse_ll
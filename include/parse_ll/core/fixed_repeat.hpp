@@ -0,0 +1,211 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a parser that parses its sub-parser a number of times that is known at
+compile time, and outputs a std::array.
+*/
+
+#ifndef PARSE_LL_CORE_FIXED_REPEAT_HPP_INCLUDED
+#define PARSE_LL_CORE_FIXED_REPEAT_HPP_INCLUDED
+
+#include <cstddef>
+#include <array>
+#include <utility>
+#include <type_traits>
+
+#include "core.hpp"
+#include "outcome/failed.hpp"
+#include "outcome/explicit.hpp"
+
+namespace parse_ll {
+
+/**
+Parser that parses SubParser exactly "count" times.
+This is produced by fixed_repeat <count>() [sub_parser].
+It is equivalent to repeat (count) [sub_parser], but the count is known at
+compile time, so that the loop is unrolled and there are no bounds checks.
+The sub-parser is parsed exactly once for each element, during parse().
+The output is a std::array <SubOutput, count>, or void if the sub-parser
+outputs void.
+The elements of the array are default-constructed and then assigned the
+outputs of the sub-parser, so SubOutput must be default-constructible.
+
+Like repeat_parser, it uses the skip parser between elements, but not before
+or after them.
+*/
+template <std::size_t count, class SubParser> struct fixed_repeat_parser
+: parser_base <fixed_repeat_parser <count, SubParser>>
+{
+    SubParser sub_parser;
+public:
+    constexpr explicit fixed_repeat_parser (SubParser const & sub_parser)
+    : sub_parser (sub_parser) {}
+};
+
+struct fixed_repeat_parser_tag;
+template <std::size_t count, class SubParser>
+    struct decayed_parser_tag <fixed_repeat_parser <count, SubParser>>
+{ typedef fixed_repeat_parser_tag type; };
+
+template <std::size_t count, class SubParser>
+    struct always_succeeds <fixed_repeat_parser <count, SubParser>>
+: properties_detail::bool_ <count == 0 || always_succeeds <SubParser>::value>
+{};
+template <std::size_t count, class SubParser>
+    struct never_consumes <fixed_repeat_parser <count, SubParser>>
+: properties_detail::bool_ <count == 0 || never_consumes <SubParser>::value>
+{};
+template <std::size_t count, class SubParser>
+    struct may_be_empty <fixed_repeat_parser <count, SubParser>>
+: properties_detail::bool_ <count == 0 || may_be_empty <SubParser>::value> {};
+
+template <std::size_t count> struct fixed_repeat_parser_maker {
+    template <class SubParser>
+        constexpr fixed_repeat_parser <count, SubParser>
+            operator[] (SubParser const & sub_parser) const
+    { return fixed_repeat_parser <count, SubParser> (sub_parser); }
+};
+
+/**
+Repeat a parser exactly "count" times, where count is known at compile time.
+For example,
+    fixed_repeat <4>() [unsigned_as <unsigned char>()]
+outputs a std::array <unsigned char, 4>.
+*/
+template <std::size_t count>
+    constexpr fixed_repeat_parser_maker <count> fixed_repeat()
+{ return fixed_repeat_parser_maker <count>(); }
+
+namespace operation {
+
+    namespace fixed_repeat_detail {
+
+        /**
+        Keep the outputs of the elements.
+        */
+        template <class SubOutput, std::size_t count> struct collector {
+            typedef std::array <SubOutput, count> output_type;
+            output_type elements;
+
+            collector() : elements() {}
+
+            template <std::size_t index, class Outcome>
+                void set (Outcome && outcome)
+            {
+                std::get <index> (elements) =
+                    ::parse_ll::output (std::forward <Outcome> (outcome));
+            }
+
+            template <class Input>
+                explicit_outcome <output_type, Input> finish (Input && rest)
+            {
+                return explicit_outcome <output_type, Input> (
+                    std::move (elements), std::move (rest));
+            }
+        };
+
+        template <std::size_t count> struct collector <void, count> {
+            template <std::size_t index, class Outcome>
+                void set (Outcome &&) {}
+
+            template <class Input>
+                explicit_outcome <void, Input> finish (Input && rest)
+            { return explicit_outcome <void, Input> (std::move (rest)); }
+        };
+
+        /**
+        Parse element "index" and, recursively, the elements after it.
+        \return true iff all elements were parsed successfully.
+        */
+        template <std::size_t index, std::size_t count> struct parse_elements
+        {
+            template <class Policy, class SubParser, class Input,
+                class Collector>
+            bool operator() (Policy const & policy,
+                SubParser const & sub_parser, Input & current,
+                Collector & collector) const
+            {
+                auto sub_outcome = parse_ll::parse (policy, sub_parser,
+                    // Only skip in between elements, not before.
+                    (index == 0) ? current : parse_ll::skip_over (
+                        policy.skip_parser(), current));
+                if (!::parse_ll::success (sub_outcome))
+                    return false;
+                // Retrieve the rest first, since the output is moved out.
+                current = ::parse_ll::rest (sub_outcome);
+                collector.template set <index> (std::move (sub_outcome));
+                return parse_elements <index + 1, count>() (
+                    policy, sub_parser, current, collector);
+            }
+        };
+
+        template <std::size_t count> struct parse_elements <count, count> {
+            template <class Policy, class SubParser, class Input,
+                class Collector>
+            bool operator() (Policy const &, SubParser const &, Input &,
+                Collector &) const
+            { return true; }
+        };
+
+    } // namespace fixed_repeat_detail
+
+    template <> struct parse <fixed_repeat_parser_tag> {
+        template <class Policy, std::size_t count, class SubParser,
+            class Input> struct result
+        {
+            typedef fixed_repeat_detail::collector <typename std::decay <
+                    typename detail::parser_output <Policy, SubParser, Input
+                >::type>::type, count> collector_type;
+            typedef decltype (std::declval <collector_type>().finish (
+                std::declval <Input>())) type;
+        };
+
+        template <class Policy, std::size_t count, class SubParser,
+            class Input>
+        typename result <Policy, count, SubParser, Input>::type
+            operator() (Policy const & policy,
+                fixed_repeat_parser <count, SubParser> const & parser,
+                Input const & input) const
+        {
+            typename result <Policy, count, SubParser, Input>::collector_type
+                collector;
+            Input current = input;
+            if (!fixed_repeat_detail::parse_elements <0, count>() (
+                    policy, parser.sub_parser, current, collector))
+                return failed();
+            return collector.finish (std::move (current));
+        }
+    };
+
+    template <> struct describe <fixed_repeat_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "fixed repeat"; }
+    };
+
+    template <> struct lower <fixed_repeat_parser_tag> {
+        template <class Lowering, class Policy, std::size_t count,
+            class SubParser>
+        void operator() (Lowering & lowering, Policy const & policy,
+            fixed_repeat_parser <count, SubParser> const & parser) const
+        { lowering.repeat (policy, parser.sub_parser, count, count); }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_FIXED_REPEAT_HPP_INCLUDED
@@ -0,0 +1,175 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a directive that turns a repeat parser into a parser that accumulates
+the outputs of the sub-parser into a state, without storing them.
+*/
+
+#ifndef PARSE_LL_CORE_FOLD_HPP_INCLUDED
+#define PARSE_LL_CORE_FOLD_HPP_INCLUDED
+
+#include <utility>
+#include <type_traits>
+
+#include "core.hpp"
+#include "repeat.hpp"
+#include "outcome/failed.hpp"
+#include "outcome/explicit.hpp"
+
+namespace parse_ll {
+
+/**
+Parser that parses like repeat_parser <SubParser>, but folds the outputs of
+the sub-parser into a state while it parses.
+This is produced by fold (initial, operation) [repeat_parser].
+
+The state starts as "initial".
+For every element, it is replaced by operation (state, output), or by
+operation (state) if the sub-parser outputs void.
+The output of the parser is the final state.
+The sub-parser is run exactly once for every element, during parse(), and the
+outputs are not stored, so this uses constant memory however many elements
+there are.
+
+Like repeat_parser, it uses the skip parser between elements, but not before
+or after them.
+*/
+template <class State, class Operation, class SubParser> struct fold_parser
+: parser_base <fold_parser <State, Operation, SubParser>>
+{
+    SubParser sub_parser;
+    int minimum, maximum;
+    State initial;
+    Operation operation;
+public:
+    constexpr fold_parser (repeat_parser <SubParser> const & repeat,
+        State const & initial, Operation const & operation)
+    : sub_parser (repeat.sub_parser),
+        minimum (repeat.minimum), maximum (repeat.maximum),
+        initial (initial), operation (operation) {}
+};
+
+struct fold_parser_tag;
+template <class State, class Operation, class SubParser>
+    struct decayed_parser_tag <fold_parser <State, Operation, SubParser>>
+{ typedef fold_parser_tag type; };
+
+template <class State, class Operation> class fold_directive {
+    State initial;
+    Operation operation;
+public:
+    constexpr fold_directive (
+        State const & initial, Operation const & operation)
+    : initial (initial), operation (operation) {}
+
+    template <class SubParser>
+        constexpr fold_parser <State, Operation, SubParser>
+    operator[] (repeat_parser <SubParser> const & repeat) const {
+        return fold_parser <State, Operation, SubParser> (
+            repeat, initial, operation);
+    }
+};
+
+/**
+Fold the outputs of a repeat parser into a state.
+For example,
+    fold (0, std::plus <int>()) [*digit]
+outputs the sum of the digits.
+*/
+template <class State, class Operation>
+    constexpr fold_directive <State, Operation> fold (
+        State const & initial, Operation const & operation)
+{ return fold_directive <State, Operation> (initial, operation); }
+
+namespace operation {
+
+    namespace fold_detail {
+
+        template <class SubOutput> struct apply {
+            template <class Operation, class State, class Outcome>
+                State operator() (Operation const & operation,
+                    State && state, Outcome && outcome) const
+            {
+                return operation (std::move (state),
+                    ::parse_ll::output (std::forward <Outcome> (outcome)));
+            }
+        };
+
+        template <> struct apply <void> {
+            template <class Operation, class State, class Outcome>
+                State operator() (Operation const & operation,
+                    State && state, Outcome &&) const
+            { return operation (std::move (state)); }
+        };
+
+    } // namespace fold_detail
+
+    template <> struct parse <fold_parser_tag> {
+        template <class Policy, class State, class Operation,
+            class SubParser, class Input>
+        explicit_outcome <State, Input> operator() (Policy const & policy,
+            fold_parser <State, Operation, SubParser> const & parser,
+            Input const & input) const
+        {
+            typedef fold_detail::apply <typename detail::parser_output <
+                Policy, SubParser, Input>::type> apply;
+
+            State state = parser.initial;
+            Input current = input;
+            int count = 0;
+            for (; count != parser.maximum; ++ count) {
+                auto sub_outcome = parse_ll::parse (
+                    policy, parser.sub_parser,
+                    // Only skip in between elements, not before.
+                    (count == 0) ? current : parse_ll::skip_over (
+                        policy.skip_parser(), current));
+                if (!::parse_ll::success (sub_outcome))
+                    break;
+                // Retrieve the rest first, since the output is moved out.
+                Input next = ::parse_ll::rest (sub_outcome);
+                state = apply() (parser.operation, std::move (state),
+                    std::move (sub_outcome));
+                current = std::move (next);
+            }
+            if (count < parser.minimum)
+                return failed();
+            return explicit_outcome <State, Input> (
+                std::move (state), std::move (current));
+        }
+    };
+
+    template <> struct describe <fold_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "fold"; }
+    };
+
+    // Bytecode has no output, so this is the same as a repeat.
+    template <> struct lower <fold_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        {
+            lowering.repeat (policy, parser.sub_parser,
+                parser.minimum, parser.maximum);
+        }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_FOLD_HPP_INCLUDED
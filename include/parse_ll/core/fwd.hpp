@@ -26,6 +26,10 @@ template <class Parser, class Enable = void> struct decayed_parser_tag;
 template <class Parser, class Enable = void> struct parser_tag;
 template <class Parser> struct is_parser;
 
+template <class Parser, class Enable = void> struct always_succeeds;
+template <class Parser, class Enable = void> struct never_consumes;
+template <class Parser, class Enable = void> struct may_be_empty;
+
 // These are required for core.hpp
 struct nothing_parser;
 template <class Derived> struct parser_base;
@@ -35,6 +39,7 @@ template <class SubParser> struct optional_parser;
 template <class Parser1, class Parser2> struct alternative_parser;
 template <bool Expect, class Parser1, class Parser2> struct sequence_parser;
 template <class Parser1, class Parser2> struct difference_parser;
+template <class Element, class Separator> struct list_parser;
 
 // These are useful for other programs.
 template <class Input, class Output = void, class SkipParser = void>
@@ -54,6 +59,7 @@ namespace operation {
     template <class ParserTag, typename Enable = void> struct parse;
     template <class ParserTag, typename Enable = void> struct skip_over;
     template <class ParserTag, typename Enable = void> struct describe;
+    template <class ParserTag, typename Enable = void> struct lower;
     template <class Outcome, typename Enable = void> struct success;
     template <class Outcome, typename Enable = void> struct output;
     template <class Outcome, typename Enable = void> struct rest;
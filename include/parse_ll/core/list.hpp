@@ -0,0 +1,187 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a list parser, which parses one or more elements separated by a
+separator.
+*/
+
+#ifndef PARSE_LL_CORE_LIST_HPP_INCLUDED
+#define PARSE_LL_CORE_LIST_HPP_INCLUDED
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include "core.hpp"
+#include "outcome/failed.hpp"
+#include "outcome/explicit.hpp"
+
+namespace parse_ll {
+
+/**
+Parser that parses one or more Element separated by Separator.
+This is produced by element % separator.
+It is equivalent to element >> *(separator >> element), but the elements and
+separators are parsed exactly once, during parse().
+The output is a std::vector of the outputs of the element parser, or void if
+the element parser outputs void.
+The output of the separator is ignored.
+
+The skip parser is used before and after each separator, but not before the
+first or after the last element.
+A separator that is not followed by an element is not consumed.
+
+If the element and the separator can both succeed without consuming input,
+the list would never finish, so element % separator is rejected at compile
+time, as far as may_be_empty can tell.
+*/
+template <class Element, class Separator> struct list_parser
+: parser_base <list_parser <Element, Separator>>
+{
+    Element element;
+    Separator separator;
+public:
+    constexpr list_parser (Element const & element, Separator const & separator)
+    : element (element), separator (separator) {}
+};
+
+struct list_parser_tag;
+template <class Element, class Separator>
+    struct decayed_parser_tag <list_parser <Element, Separator>>
+{ typedef list_parser_tag type; };
+
+// The list succeeds if and only if the first element does.
+template <class Element, class Separator>
+    struct always_succeeds <list_parser <Element, Separator>>
+: always_succeeds <Element> {};
+template <class Element, class Separator>
+    struct never_consumes <list_parser <Element, Separator>>
+: properties_detail::both_never_consume <Element, Separator> {};
+template <class Element, class Separator>
+    struct may_be_empty <list_parser <Element, Separator>>
+: may_be_empty <Element> {};
+
+namespace operation {
+
+    namespace list_detail {
+
+        /**
+        Collect the outputs of the elements.
+        */
+        template <class ElementOutput> struct collector {
+            typedef std::vector <ElementOutput> output_type;
+            output_type elements;
+
+            void reserve (std::size_t size) { elements.reserve (size); }
+
+            template <class Outcome> void add (Outcome && outcome) {
+                elements.push_back (
+                    ::parse_ll::output (std::forward <Outcome> (outcome)));
+            }
+
+            template <class Input>
+                explicit_outcome <output_type, Input> finish (Input && rest)
+            {
+                return explicit_outcome <output_type, Input> (
+                    std::move (elements), std::move (rest));
+            }
+        };
+
+        // If the elements have no output, nothing needs to be kept.
+        template <> struct collector <void> {
+            void reserve (std::size_t) {}
+
+            template <class Outcome> void add (Outcome &&) {}
+
+            template <class Input>
+                explicit_outcome <void, Input> finish (Input && rest)
+            { return explicit_outcome <void, Input> (std::move (rest)); }
+        };
+
+    } // namespace list_detail
+
+    template <> struct parse <list_parser_tag> {
+        template <class Policy, class Element, class Input> struct result {
+            typedef typename detail::parser_output <Policy, Element, Input
+                >::type element_output_type;
+            typedef list_detail::collector <typename std::decay <
+                element_output_type>::type> collector_type;
+            typedef decltype (std::declval <collector_type>().finish (
+                std::declval <Input>())) type;
+        };
+
+        template <class Policy, class Element, class Separator, class Input>
+            typename result <Policy, Element, Input>::type
+        operator() (Policy const & policy,
+            list_parser <Element, Separator> const & parser,
+            Input const & input) const
+        {
+            typename result <Policy, Element, Input>::collector_type collector;
+
+            auto first_outcome = parse_ll::parse (
+                policy, parser.element, input);
+            if (!::parse_ll::success (first_outcome))
+                return failed();
+            // Retrieve the rest first, since the output is moved out.
+            Input current = ::parse_ll::rest (first_outcome);
+            collector.add (std::move (first_outcome));
+
+            while (true) {
+                auto separator_outcome = parse_ll::parse (
+                    policy, parser.separator,
+                    parse_ll::skip_over (policy.skip_parser(), current));
+                if (!::parse_ll::success (separator_outcome))
+                    break;
+                auto element_outcome = parse_ll::parse (
+                    policy, parser.element, parse_ll::skip_over (
+                        policy.skip_parser(),
+                        ::parse_ll::rest (separator_outcome)));
+                if (!::parse_ll::success (element_outcome))
+                    break;
+                current = ::parse_ll::rest (element_outcome);
+                collector.add (std::move (element_outcome));
+            }
+            return collector.finish (std::move (current));
+        }
+    };
+
+    template <> struct describe <list_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "list"; }
+    };
+
+    template <> struct lower <list_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        {
+            lowering.repeat (1, -1,
+                [&] {
+                    lowering.skip (policy);
+                    lowering.lower (policy, parser.separator);
+                    lowering.skip (policy);
+                },
+                [&] { lowering.lower (policy, parser.element); });
+        }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_LIST_HPP_INCLUDED
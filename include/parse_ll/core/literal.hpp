@@ -22,6 +22,7 @@ Define a parser that accepts a literal and does not output anything.
 #define PARSE_LL_LITERAL_HPP_INCLUDED
 
 #include <string>
+#include <type_traits>
 
 #include "range/core.hpp"
 
@@ -33,16 +34,18 @@ Define a parser that accepts a literal and does not output anything.
 namespace parse_ll {
 
 /**
-Literal must be a range.
+Literal must be a range, or a single character.
 It can only be a view if the underlying range is guaranteed to stay in memory
 throughout the lifetime of the literal_parser object.
+A literal_parser <char> does not allocate memory, so that it can be
+constructed in a constant expression.
 */
 template <class Literal> struct literal_parser
 : public parser_base <literal_parser <Literal> >
 {
     Literal literal;
 public:
-    literal_parser (Literal const & literal) : literal (literal) {}
+    constexpr literal_parser (Literal const & literal) : literal (literal) {}
 };
 
 struct literal_parser_tag;
@@ -50,9 +53,19 @@ struct literal_parser_tag;
 template <class Literal> struct decayed_parser_tag <literal_parser <Literal>>
 { typedef literal_parser_tag type; };
 
-inline literal_parser <std::string> literal (char c) {
-    return literal_parser <std::string> (std::string (1, c));
-}
+constexpr literal_parser <char> literal (char c)
+{ return literal_parser <char> (c); }
+
+/**
+\return A parser that matches one code point, for input that produces code
+points, like range::utf8_range.
+This only accepts a char32_t, so that literal (0x41) still means
+literal (char (0x41)).
+*/
+template <class Char, class Enable = typename
+    std::enable_if <std::is_same <Char, char32_t>::value>::type>
+constexpr literal_parser <char32_t> literal (Char c)
+{ return literal_parser <char32_t> (c); }
 
 inline literal_parser <std::string> literal (std::string const & s) {
     return literal_parser <std::string> (s);
@@ -79,6 +92,28 @@ namespace operation {
             else
                 return failed();
         }
+
+        template <class Policy, class Input>
+        explicit_outcome <void, Input> operator() (Policy const &,
+            literal_parser <char> const & parser, Input input) const
+        {
+            if (!::range::empty (input)
+                    && ::range::first (input) == parser.literal)
+                return explicit_outcome <void, Input> (::range::drop (input));
+            else
+                return failed();
+        }
+
+        template <class Policy, class Input>
+        explicit_outcome <void, Input> operator() (Policy const &,
+            literal_parser <char32_t> const & parser, Input input) const
+        {
+            if (!::range::empty (input)
+                    && ::range::first (input) == parser.literal)
+                return explicit_outcome <void, Input> (::range::drop (input));
+            else
+                return failed();
+        }
     };
 
     template <> struct describe <literal_parser_tag> {
@@ -86,6 +121,13 @@ namespace operation {
         { return "literal"; }
     };
 
+    template <> struct lower <literal_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const &,
+                Parser const & parser) const
+        { lowering.string (parser.literal, ::parse_ll::describe (parser)); }
+    };
+
 } // namespace operation
 
 } // namespace parse_ll
@@ -46,6 +46,24 @@ template <class Parser> struct decayed_parser_tag <Parser,
     typename boost::enable_if <std::is_base_of <named_parser, Parser>>::type>
 { typedef named_parser_tag type; };
 
+namespace named_detail {
+
+    template <class Parser> struct implementation
+    : std::decay <decltype (std::declval <Parser const &>().implementation())>
+    {};
+
+} // namespace named_detail
+
+template <class Parser> struct always_succeeds <Parser,
+    typename boost::enable_if <std::is_base_of <named_parser, Parser>>::type>
+: always_succeeds <typename named_detail::implementation <Parser>::type> {};
+template <class Parser> struct never_consumes <Parser,
+    typename boost::enable_if <std::is_base_of <named_parser, Parser>>::type>
+: never_consumes <typename named_detail::implementation <Parser>::type> {};
+template <class Parser> struct may_be_empty <Parser,
+    typename boost::enable_if <std::is_base_of <named_parser, Parser>>::type>
+: may_be_empty <typename named_detail::implementation <Parser>::type> {};
+
 namespace operation {
     template <> struct parse <named_parser_tag> {
         template <class Policy, class Parser, class Input>
@@ -58,27 +76,57 @@ namespace operation {
         template <class Parser> auto operator() (Parser const & parser) const
         RETURNS (parser.description());
     };
+
+    // Describe what the named parser contains with its name.
+    template <> struct lower <named_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        {
+            lowering.push_name (parser.description());
+            lowering.lower (policy, parser.implementation());
+            lowering.pop_name();
+        }
+    };
 }
 
 } // namespace parse_ll
 
 /**
-\todo Test separately.
-
-Define a named parser type that wraps the parser expression in the dots.
+\internal
+Define a named parser type with a default constructor declared with
+"specifiers".
 */
-#define PARSE_LL_DEFINE_NAMED_PARSER_TYPE(name, type_name, ...) \
+#define PARSE_LL_DEFINE_NAMED_PARSER_TYPE_WITH(specifiers, name, type_name, \
+    ...) \
 struct type_name \
 : ::parse_ll::parser_base <type_name>, ::parse_ll::named_parser { \
     typedef decltype (__VA_ARGS__) implementation_type; \
     implementation_type implementation_; \
-    type_name() : implementation_ (__VA_ARGS__) {} \
+    specifiers type_name() : implementation_ (__VA_ARGS__) {} \
     implementation_type const & implementation() const { \
         return implementation_; \
     } \
     const char * description() const { return name; } \
 }
 
+/**
+\todo Test separately.
+
+Define a named parser type that wraps the parser expression in the dots.
+*/
+#define PARSE_LL_DEFINE_NAMED_PARSER_TYPE(name, type_name, ...) \
+PARSE_LL_DEFINE_NAMED_PARSER_TYPE_WITH (, name, type_name, __VA_ARGS__)
+
+/**
+Define a named parser type that wraps the parser expression in the dots, and
+that can be constructed in a constant expression.
+The parser expression must be a constant expression.
+*/
+#define PARSE_LL_DEFINE_CONSTEXPR_NAMED_PARSER_TYPE(name, type_name, ...) \
+PARSE_LL_DEFINE_NAMED_PARSER_TYPE_WITH (constexpr, name, type_name, \
+    __VA_ARGS__)
+
 /**
 Define a named parser type "name_parser" that wraps the parser expression in the
 dots, and a static const variable "name" of type "name_parser".
@@ -87,9 +135,21 @@ dots, and a static const variable "name" of type "name_parser".
 PARSE_LL_DEFINE_NAMED_PARSER_TYPE (#name, name##_parser, __VA_ARGS__); \
 static name##_parser const name = name##_parser();
 
+/**
+Like PARSE_LL_DEFINE_NAMED_PARSER, but define "name" as constexpr, so that it
+is initialised at compile time and can be used in other constexpr parsers.
+The parser expression must be a constant expression.
+*/
+#define PARSE_LL_DEFINE_CONSTEXPR_NAMED_PARSER(name, ...) \
+PARSE_LL_DEFINE_CONSTEXPR_NAMED_PARSER_TYPE (#name, name##_parser, \
+    __VA_ARGS__); \
+static constexpr name##_parser name = name##_parser();
+
 /**
 Define a named parser type that wraps the parser expression in the dots and has
 one template parameter "template_parameter".
+The constructor is constexpr if the parser expression is a constant expression
+for the template argument.
 */
 #define PARSE_LL_DEFINE_NAMED_PARSER_TEMPLATE( \
     name, type_name, template_parameter, ...) \
@@ -99,11 +159,11 @@ template <typename template_parameter> struct type_name \
 { \
     typedef decltype (__VA_ARGS__) implementation_type; \
     implementation_type implementation_; \
-    type_name() : implementation_ (__VA_ARGS__) {} \
+    constexpr type_name() : implementation_ (__VA_ARGS__) {} \
     implementation_type const & implementation() const { \
         return implementation_; \
     } \
-    const char * description() const { return #name; } \
+    const char * description() const { return name; } \
 }
 
 #endif  // PARSE_LL_BASE_NAMED_HPP_INCLUDED
@@ -89,7 +89,8 @@ public:
     { return convert (original_policy); }
 };
 
-static const auto no_skip = change_policy_directive <convert_policy_no_skip> ();
+static constexpr auto no_skip =
+    change_policy_directive <convert_policy_no_skip> ();
 
 } // namespace parse_ll
 
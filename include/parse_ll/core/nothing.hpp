@@ -30,13 +30,16 @@ namespace parse_ll {
 
 // Parser that does not parse any input but is always successful.
 struct nothing_parser : parser_base <nothing_parser> {};
-static const auto nothing = nothing_parser();
+static constexpr auto nothing = nothing_parser();
 
 struct nothing_parser_tag;
 
 template <> struct decayed_parser_tag <nothing_parser>
 { typedef nothing_parser_tag type; };
 
+template <> struct always_succeeds <nothing_parser> : std::true_type {};
+template <> struct never_consumes <nothing_parser> : std::true_type {};
+
 namespace operation {
 
     template <> struct parse <nothing_parser_tag> {
@@ -50,6 +53,11 @@ namespace operation {
         const char * operator() (nothing_parser const &) const
         { return "nothing"; }
     };
+
+    template <> struct lower <nothing_parser_tag> {
+        template <class Lowering, class Policy> void operator() (
+            Lowering &, Policy const &, nothing_parser const &) const {}
+    };
 } // namespace operation
 
 } // namespace parse_ll
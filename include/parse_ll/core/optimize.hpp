@@ -0,0 +1,481 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Rewrite parser expressions into equivalent ones that are faster to parse with.
+
+The rewrites are done at compile time, on the types of the parsers, and at
+run time only the data in the parsers is combined.
+They are:
+\li adjacent literals in a sequence are merged into one literal, if no skip
+    parser can be active between them;
+\li alternatives of parsers that each accept one character from a set are
+    merged into one parser that looks the character up in a char_class;
+\li a difference between a char_parser and a parser that accepts one
+    character from a set becomes a char_parser that looks characters that
+    fit in a char up in a char_class, and passes other characters to the
+    original match;
+\li a transform_parser directly around another transform_parser becomes one
+    transform_parser with a composed actor.
+
+The output types of the parsers do not change, so the result can be used in
+exactly the same places.
+Rules and named parsers are left alone.
+The rewrites also hold for input with wider characters, like std::wstring or
+utf8_range: parsers that accept one character from a set never accept
+characters that do not fit in a char, and neither does a char_class.
+*/
+
+#ifndef PARSE_LL_CORE_OPTIMIZE_HPP_INCLUDED
+#define PARSE_LL_CORE_OPTIMIZE_HPP_INCLUDED
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/utility/enable_if.hpp>
+
+#include "utility/returns.hpp"
+
+#include "core.hpp"
+#include "char.hpp"
+#include "char_class.hpp"
+#include "literal.hpp"
+#include "sequence.hpp"
+#include "alternative.hpp"
+#include "difference.hpp"
+#include "optional.hpp"
+#include "repeat.hpp"
+#include "list.hpp"
+#include "transform.hpp"
+#include "skip.hpp"
+#include "no_skip.hpp"
+
+namespace parse_ll {
+
+/**
+Match that looks up characters that fit in a char in a char_class, and passes
+any other characters to Match.
+This is the result of optimising a char_parser minus a set of characters,
+which cannot contain characters that do not fit in a char.
+*/
+template <class Match> struct char_class_fallback {
+    char_class narrow;
+    Match match;
+public:
+    char_class_fallback (char_class const & narrow, Match const & match)
+    : narrow (narrow), match (match) {}
+
+    template <class Char> bool operator() (Char const & c) const {
+        if (static_cast <Char> (static_cast <char> (c)) == c)
+            return narrow.contains (static_cast <char> (c));
+        else
+            return bool (match (c));
+    }
+};
+
+namespace optimize_detail {
+
+    /**
+    Actor that passes the result of actor first to actor second.
+    If first returns void, then second is called without arguments.
+    */
+    template <class First, class Second> struct composed_actor;
+
+    struct call_composed {
+        template <class First, class Second, class ... Arguments>
+            auto operator() (std::false_type, First const & first,
+                Second const & second, Arguments && ... arguments) const
+        RETURNS (second (first (std::forward <Arguments> (arguments)...)));
+
+        template <class First, class Second, class ... Arguments>
+            auto operator() (std::true_type, First const & first,
+                Second const & second, Arguments && ... arguments) const
+            -> decltype (second())
+        {
+            first (std::forward <Arguments> (arguments)...);
+            return second();
+        }
+    };
+
+    template <class First, class Second> struct composed_actor {
+        First first;
+        Second second;
+    public:
+        composed_actor (First const & first, Second const & second)
+        : first (first), second (second) {}
+
+        template <class ... Arguments>
+            auto operator() (Arguments && ... arguments) const
+        RETURNS (call_composed() (
+            std::is_void <decltype (std::declval <First const &>() (
+                std::forward <Arguments> (arguments)...))>(),
+            first, second, std::forward <Arguments> (arguments)...));
+    };
+
+    /**
+    Describe parsers that accept exactly one character from a set.
+    outputs_char is true if they output the character, and false if their
+    output is void.
+    */
+    template <class Parser> struct single_char : std::false_type {};
+
+    template <> struct single_char <literal_parser <char>>
+    : std::true_type {
+        typedef std::false_type outputs_char;
+        static char_class characters (literal_parser <char> const & parser) {
+            char_class result;
+            result.add (parser.literal);
+            return result;
+        }
+    };
+
+    template <> struct single_char <one_of_parser> : std::true_type {
+        typedef std::false_type outputs_char;
+        static char_class characters (one_of_parser const & parser)
+        { return parser.characters; }
+    };
+
+    template <> struct single_char <char_parser <match_one <char>>>
+    : std::true_type {
+        typedef std::true_type outputs_char;
+        static char_class characters (
+            char_parser <match_one <char>> const & parser)
+        {
+            char_class result;
+            result.add (parser.match.expected);
+            return result;
+        }
+    };
+
+    template <> struct single_char <char_parser <char_class>>
+    : std::true_type {
+        typedef std::true_type outputs_char;
+        static char_class characters (
+            char_parser <char_class> const & parser)
+        { return parser.match; }
+    };
+
+    /**
+    Parser that accepts one character from a set and outputs it, or not.
+    */
+    template <bool outputs_char> struct char_class_parser;
+    template <> struct char_class_parser <false> {
+        typedef one_of_parser type;
+        static type make (char_class const & characters)
+        { return one_of_parser (characters); }
+    };
+    template <> struct char_class_parser <true> {
+        typedef char_parser <char_class> type;
+        static type make (char_class const & characters)
+        { return type (characters); }
+    };
+
+    template <class Parser> struct is_char_parser : std::false_type {};
+    template <class Match> struct is_char_parser <char_parser <Match>>
+    : std::true_type {};
+    template <> struct is_char_parser <any_char_parser> : std::true_type {};
+
+    template <class Parser> struct is_literal : std::false_type {};
+    template <> struct is_literal <literal_parser <char>> : std::true_type {};
+    template <> struct is_literal <literal_parser <std::string>>
+    : std::true_type {};
+
+    inline std::string literal_text (literal_parser <char> const & parser)
+    { return std::string (1, parser.literal); }
+
+    inline std::string const & literal_text (
+        literal_parser <std::string> const & parser)
+    { return parser.literal; }
+
+    /* Combining two parsers that have already been rewritten. */
+
+    template <bool skipping, bool expect, class Parser1, class Parser2,
+        class Enable = void>
+    struct merge_sequence {
+        typedef sequence_parser <expect, Parser1, Parser2> type;
+        static type apply (Parser1 const & parser_1, Parser2 const & parser_2)
+        { return type (parser_1, parser_2); }
+    };
+
+    // Without a skip parser, literal ("ab") >> literal ('c') is equivalent to
+    // literal ("abc").
+    // With an expectation, the error position would be different.
+    template <class Parser1, class Parser2>
+        struct merge_sequence <false, false, Parser1, Parser2,
+            typename boost::enable_if_c <is_literal <Parser1>::value
+                && is_literal <Parser2>::value>::type>
+    {
+        typedef literal_parser <std::string> type;
+        static type apply (Parser1 const & parser_1, Parser2 const & parser_2)
+        { return type (literal_text (parser_1) + literal_text (parser_2)); }
+    };
+
+    template <class Parser1, class Parser2, class Enable = void>
+        struct merge_alternative
+    {
+        typedef alternative_parser <Parser1, Parser2> type;
+        static type apply (Parser1 const & parser_1, Parser2 const & parser_2)
+        { return type (parser_1, parser_2); }
+    };
+
+    // Both parsers must have the same output type for the alternative to be
+    // replaced by one parser.
+    template <class Parser1, class Parser2>
+        struct merge_alternative <Parser1, Parser2,
+            typename boost::enable_if_c <single_char <Parser1>::value
+                && single_char <Parser2>::value
+                && single_char <Parser1>::outputs_char::value
+                    == single_char <Parser2>::outputs_char::value>::type>
+    {
+        typedef char_class_parser <
+            single_char <Parser1>::outputs_char::value> make;
+        typedef typename make::type type;
+        static type apply (Parser1 const & parser_1, Parser2 const & parser_2)
+        {
+            return make::make (single_char <Parser1>::characters (parser_1)
+                | single_char <Parser2>::characters (parser_2));
+        }
+    };
+
+    template <class Parser1, class Parser2, class Enable = void>
+        struct merge_difference
+    {
+        typedef difference_parser <Parser1, Parser2> type;
+        static type apply (Parser1 const & parser_1, Parser2 const & parser_2)
+        { return type (parser_1, parser_2); }
+    };
+
+    template <class Parser1, class Parser2>
+        struct merge_difference <Parser1, Parser2,
+            typename boost::enable_if_c <is_char_parser <Parser1>::value
+                && single_char <Parser2>::value>::type>
+    {
+        typedef typename std::decay <decltype (std::declval <Parser1>().match)
+            >::type match_type;
+        typedef char_parser <char_class_fallback <match_type>> type;
+        static type apply (Parser1 const & parser_1, Parser2 const & parser_2)
+        {
+            return type (char_class_fallback <match_type> (
+                char_class::matching (parser_1.match)
+                    - single_char <Parser2>::characters (parser_2),
+                parser_1.match));
+        }
+    };
+
+    // A char_class only contains characters that fit in a char, so no
+    // fallback is needed.
+    template <class Parser2>
+        struct merge_difference <char_parser <char_class>, Parser2,
+            typename boost::enable_if_c <single_char <Parser2>::value>::type>
+    {
+        typedef char_parser <char_class> type;
+        static type apply (char_parser <char_class> const & parser_1,
+            Parser2 const & parser_2)
+        {
+            return type (parser_1.match
+                - single_char <Parser2>::characters (parser_2));
+        }
+    };
+
+    template <class SubParser, class Actor> struct merge_transform {
+        typedef transform_parser <SubParser, Actor> type;
+        static type apply (SubParser const & sub_parser, Actor const & actor)
+        { return type (sub_parser, actor); }
+    };
+
+    template <class SubParser, class Actor1, class Actor2>
+        struct merge_transform <transform_parser <SubParser, Actor1>, Actor2>
+    {
+        typedef composed_actor <Actor1, Actor2> actor_type;
+        typedef transform_parser <SubParser, actor_type> type;
+        static type apply (transform_parser <SubParser, Actor1> const & inner,
+            Actor2 const & actor)
+        { return type (inner.sub_parser, actor_type (inner.actor, actor)); }
+    };
+
+    /**
+    Rewrite Parser.
+    \tparam skipping
+        Whether a skip parser may be active when Parser is used.
+    */
+    template <bool skipping, class Parser> struct rewrite {
+        typedef Parser type;
+        static type apply (Parser const & parser) { return parser; }
+    };
+
+    template <bool skipping, bool expect, class Parser1, class Parser2>
+        struct rewrite <skipping, sequence_parser <expect, Parser1, Parser2>>
+    {
+        typedef rewrite <skipping, Parser1> rewrite_1;
+        typedef rewrite <skipping, Parser2> rewrite_2;
+        typedef merge_sequence <skipping, expect,
+            typename rewrite_1::type, typename rewrite_2::type> merge;
+        typedef typename merge::type type;
+
+        static type apply (
+            sequence_parser <expect, Parser1, Parser2> const & parser)
+        {
+            return merge::apply (rewrite_1::apply (parser.parser_1),
+                rewrite_2::apply (parser.parser_2));
+        }
+    };
+
+    template <bool skipping, class Parser1, class Parser2>
+        struct rewrite <skipping, alternative_parser <Parser1, Parser2>>
+    {
+        typedef rewrite <skipping, Parser1> rewrite_1;
+        typedef rewrite <skipping, Parser2> rewrite_2;
+        typedef merge_alternative <
+            typename rewrite_1::type, typename rewrite_2::type> merge;
+        typedef typename merge::type type;
+
+        static type apply (alternative_parser <Parser1, Parser2> const & parser)
+        {
+            return merge::apply (rewrite_1::apply (parser.parser_1),
+                rewrite_2::apply (parser.parser_2));
+        }
+    };
+
+    template <bool skipping, class Parser1, class Parser2>
+        struct rewrite <skipping, difference_parser <Parser1, Parser2>>
+    {
+        typedef rewrite <skipping, Parser1> rewrite_1;
+        typedef rewrite <skipping, Parser2> rewrite_2;
+        typedef merge_difference <
+            typename rewrite_1::type, typename rewrite_2::type> merge;
+        typedef typename merge::type type;
+
+        static type apply (difference_parser <Parser1, Parser2> const & parser)
+        {
+            return merge::apply (rewrite_1::apply (parser.parser_1),
+                rewrite_2::apply (parser.parser_2));
+        }
+    };
+
+    template <bool skipping, class SubParser, class Actor>
+        struct rewrite <skipping, transform_parser <SubParser, Actor>>
+    {
+        typedef rewrite <skipping, SubParser> rewrite_sub;
+        typedef merge_transform <typename rewrite_sub::type, Actor> merge;
+        typedef typename merge::type type;
+
+        static type apply (transform_parser <SubParser, Actor> const & parser)
+        { return merge::apply (rewrite_sub::apply (parser.sub_parser),
+            parser.actor); }
+    };
+
+    template <bool skipping, class SubParser>
+        struct rewrite <skipping, optional_parser <SubParser>>
+    {
+        typedef rewrite <skipping, SubParser> rewrite_sub;
+        typedef optional_parser <typename rewrite_sub::type> type;
+
+        static type apply (optional_parser <SubParser> const & parser)
+        { return type (rewrite_sub::apply (parser.sub_parser)); }
+    };
+
+    template <bool skipping, class SubParser>
+        struct rewrite <skipping, repeat_parser <SubParser>>
+    {
+        typedef rewrite <skipping, SubParser> rewrite_sub;
+        typedef repeat_parser <typename rewrite_sub::type> type;
+
+        static type apply (repeat_parser <SubParser> const & parser) {
+            return type (rewrite_sub::apply (parser.sub_parser),
+                parser.minimum, parser.maximum);
+        }
+    };
+
+    template <bool skipping, class Element, class Separator>
+        struct rewrite <skipping, list_parser <Element, Separator>>
+    {
+        typedef rewrite <skipping, Element> rewrite_element;
+        typedef rewrite <skipping, Separator> rewrite_separator;
+        typedef list_parser <typename rewrite_element::type,
+            typename rewrite_separator::type> type;
+
+        static type apply (list_parser <Element, Separator> const & parser) {
+            return type (rewrite_element::apply (parser.element),
+                rewrite_separator::apply (parser.separator));
+        }
+    };
+
+    // Inside skip_inside, the skip parser is active; the skip parser itself
+    // is used without skipping.
+    template <bool skipping, class SubParser, class SkipParser, bool pad>
+        struct rewrite <skipping, skip_inside <SubParser, SkipParser, pad>>
+    {
+        typedef rewrite <true, SubParser> rewrite_sub;
+        typedef rewrite <false, SkipParser> rewrite_skip;
+        typedef skip_inside <typename rewrite_sub::type,
+            typename rewrite_skip::type, pad> type;
+
+        static type apply (
+            skip_inside <SubParser, SkipParser, pad> const & parser)
+        {
+            return type (rewrite_sub::apply (parser.sub_parser),
+                rewrite_skip::apply (parser.skip_parser));
+        }
+    };
+
+    // Any other policy might introduce a skip parser.
+    template <class ConvertPolicy> struct skipping_inside
+    { template <bool skipping> struct apply : std::true_type {}; };
+
+    template <> struct skipping_inside <convert_policy_no_skip>
+    { template <bool skipping> struct apply : std::false_type {}; };
+
+    template <bool skipping, class SubParser, class ConvertPolicy>
+        struct rewrite <skipping, change_policy <SubParser, ConvertPolicy>>
+    {
+        typedef rewrite <skipping_inside <ConvertPolicy>::template apply <
+            skipping>::value, SubParser> rewrite_sub;
+        typedef change_policy <typename rewrite_sub::type, ConvertPolicy> type;
+
+        static type apply (change_policy <SubParser, ConvertPolicy> const &
+            parser)
+        {
+            return type (rewrite_sub::apply (parser.sub_parser),
+                parser.convert_policy);
+        }
+    };
+
+} // namespace optimize_detail
+
+/**
+\return A parser that is equivalent to parser when it is used with a policy
+without a skip parser, as parse (parser, input) does, but may be faster.
+Outside skip [] directives, adjacent literals are merged.
+*/
+template <class Parser> inline
+    typename optimize_detail::rewrite <false, Parser>::type
+    optimize (Parser const & parser)
+{ return optimize_detail::rewrite <false, Parser>::apply (parser); }
+
+/**
+\return A parser that is equivalent to parser with any policy, but may be
+faster.
+Adjacent literals are merged only inside no_skip [] directives.
+*/
+template <class Parser> inline
+    typename optimize_detail::rewrite <true, Parser>::type
+    optimize_any_policy (Parser const & parser)
+{ return optimize_detail::rewrite <true, Parser>::apply (parser); }
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_OPTIMIZE_HPP_INCLUDED
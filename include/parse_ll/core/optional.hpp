@@ -23,9 +23,10 @@ Define an optional parser, which parses something zero or one time.
 
 #include <cassert>
 #include <type_traits>
-#include <boost/mpl/if.hpp>
 #include <boost/optional.hpp>
 
+#include "rime/core.hpp"
+
 #include "fwd.hpp"
 #include "core.hpp"
 
@@ -39,28 +40,16 @@ This is consistent with the objective of translating the input to an output
 type as opposed to returning some information about whether a parser matched
 or not.
 
-\todo Currently, parse() returns an object of class successful<>.
-This implementation is simple.
-However, if the underlying parser is successful, output() is always called.
-This can be prevented by introducing a class optional_outcome<>.
-It would keep a copy of the sub-outcome and call it when necessary.
-It that does require explicit handling of void.
-Also, either the input range should be saved, but preferably only if the
-underlying parser is unsuccessful, because otherwise it'll hold the rest of
-the input anyway.
-So you'd imagine a variant<sub_outcome, Input> (and maybe void?) but even that
-duplicates information: sub_outcome contains information about whether it was
-successful, whereas in this context the variant already indicates that.
-So maybe the current implementation should be used if the sub_parser's outcome
-is explicit_outcome and the new implementation otherwise?
-Or outcomes could be asserted successful and shed some of their weight...?
+parse() returns an optional_outcome<>, which keeps the sub-outcome, so that the
+output of the sub-parser is only produced when output() is called.
 */
 template <class SubParser> struct optional_parser
     : public parser_base <optional_parser <SubParser> >
 {
     SubParser sub_parser;
 public:
-    optional_parser (SubParser const & sub_parser) : sub_parser (sub_parser) {}
+    constexpr optional_parser (SubParser const & sub_parser)
+    : sub_parser (sub_parser) {}
 };
 
 struct optional_parser_tag;
@@ -69,35 +58,48 @@ template <class SubParser>
     struct decayed_parser_tag <optional_parser <SubParser>>
 { typedef optional_parser_tag type; };
 
+template <class SubParser> struct always_succeeds <optional_parser <SubParser>>
+: std::true_type {};
+template <class SubParser> struct never_consumes <optional_parser <SubParser>>
+: never_consumes <SubParser> {};
+
+/**
+Outcome of optional_parser, which is always successful.
+It keeps the outcome of the sub-parser, and calls output() on it only when the
+output is required.
+If the sub-parser was unsuccessful, the input is saved, since it is also the
+rest.
+Whether input is set therefore indicates whether the sub-parser was successful,
+so that success() on the sub-outcome, which can be expensive, is called only
+once.
+*/
+template <class Policy, class SubParser, class Input> struct optional_outcome {
+    typedef typename detail::parser_outcome <Policy, SubParser, Input>::type
+        sub_outcome_type;
+    sub_outcome_type sub_outcome;
+    // Iff !success (sub_outcome):
+    boost::optional <Input> input;
+public:
+    optional_outcome (Policy const & policy, SubParser const & sub_parser,
+        Input const & input)
+    : sub_outcome (parse (policy, sub_parser, input))
+    {
+        if (!success (sub_outcome))
+            this->input = input;
+    }
+};
+
 namespace operation {
 
     template <> struct parse <optional_parser_tag> {
-        template <class Policy, class SubParser, class Input> struct result {
-            typedef typename std::decay <Input>::type bare_input_type;
-            typedef typename detail::parser_outcome <Policy, SubParser,
-                bare_input_type>::type sub_outcome_type;
-            typedef typename detail::outcome_output <sub_outcome_type>::type
-                sub_output_type;
-            typedef typename boost::mpl::if_ <
-                std::is_same <sub_output_type, void>,
-                void, boost::optional <sub_output_type>>::type output_type;
-
-            typedef successful <output_type, bare_input_type> type;
-        };
-
         template <class Policy, class SubParser, class Input>
-            typename result <Policy, SubParser, Input>::type
+            optional_outcome <Policy, SubParser, Input>
         operator() (Policy const & policy,
-            optional_parser <SubParser> const & parser, Input && input) const
+            optional_parser <SubParser> const & parser, Input const & input)
+            const
         {
-            auto sub_outcome = parse_ll::parse (policy,
-                parser.sub_parser, std::forward <Input> (input));
-            if (::parse_ll::success (sub_outcome))
-                return sub_outcome;
-            else
-                // Default-construct the output type, i.e. an empty
-                // boost::optional <...>, or a void.
-                return typename result <Policy, SubParser, Input>::type (input);
+            return optional_outcome <Policy, SubParser, Input> (
+                policy, parser.sub_parser, input);
         }
     };
 
@@ -105,9 +107,79 @@ namespace operation {
         template <class Parser> const char * operator() (Parser const &) const
         { return "optional"; }
     };
+
+    template <> struct lower <optional_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        {
+            auto done = lowering.new_label();
+            lowering.choice (done);
+            lowering.lower (policy, parser.sub_parser);
+            lowering.commit (done);
+            lowering.place (done);
+        }
+    };
+
+    template <class Policy, class SubParser, class Input>
+        struct success <optional_outcome <Policy, SubParser, Input>>
+    {
+        rime::true_type operator() (
+            optional_outcome <Policy, SubParser, Input> const &) const
+        { return rime::true_; }
+    };
+
+    namespace optional_detail {
+
+        template <class Outcome, class SubOutput> struct output {
+            typedef boost::optional <SubOutput> result_type;
+
+            result_type operator() (Outcome const & outcome) const {
+                if (outcome.input)
+                    return result_type();
+                else
+                    return result_type (
+                        ::parse_ll::output (outcome.sub_outcome));
+            }
+
+            result_type operator() (Outcome && outcome) const {
+                if (outcome.input)
+                    return result_type();
+                else
+                    return result_type (
+                        ::parse_ll::output (std::move (outcome.sub_outcome)));
+            }
+        };
+
+        // void output: not implemented since this should never be called.
+        template <class Outcome> struct output <Outcome, void>
+        { void operator() (Outcome const &) const; };
+
+    } // namespace optional_detail
+
+    template <class Policy, class SubParser, class Input>
+        struct output <optional_outcome <Policy, SubParser, Input>>
+    : optional_detail::output <optional_outcome <Policy, SubParser, Input>,
+        typename std::decay <typename detail::outcome_output <
+            typename optional_outcome <Policy, SubParser, Input
+                >::sub_outcome_type const &>::type>::type> {};
+
+    template <class Policy, class SubParser, class Input>
+        struct rest <optional_outcome <Policy, SubParser, Input>>
+    {
+        Input operator() (optional_outcome <Policy, SubParser, Input>
+            const & outcome) const
+        {
+            if (outcome.input)
+                return *outcome.input;
+            else
+                return ::parse_ll::rest (outcome.sub_outcome);
+        }
+    };
+
 } // namespace operation
 
 } // namespace parse_ll
 
-#endif // PARSE_LL_BASE_REPEAT_HPP_INCLUDED
+#endif // PARSE_LL_BASE_OPTIONAL_HPP_INCLUDED
 
@@ -135,6 +135,20 @@ static const auto success = callable::success();
 static const auto output = callable::output();
 static const auto rest = callable::rest();
 
+namespace detail {
+
+    /**
+    Stand-in for an outcome of which nothing needs to be kept, for example
+    because it is known to be successful and its output is void.
+    Constructing it from an outcome does not move from that outcome.
+    */
+    struct discarded_outcome {
+        discarded_outcome() {}
+        template <class Outcome> explicit discarded_outcome (Outcome &&) {}
+    };
+
+} // namespace detail
+
 } // namespace parse_ll
 
 #endif // PARSE_LL_CORE_OUTCOME_CORE_HPP_INCLUDED
@@ -111,8 +111,7 @@ namespace operation {
             const
         { return ::parse_ll::output (outcome.result.get()); }
 
-        Output operator() (explicit_outcome <Output, Input> const && outcome)
-            const
+        Output operator() (explicit_outcome <Output, Input> && outcome) const
         { return ::parse_ll::output (std::move (outcome.result.get())); }
     };
     template <class Input> struct output <explicit_outcome <void, Input>>
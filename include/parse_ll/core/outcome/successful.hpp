@@ -75,10 +75,12 @@ public:
     Construct from other outcome.
     output (other) must be convertible to Output.
     If Output is void, the type of output (other) is irrelevant.
+    If other is an rvalue, its output is moved out before its rest is
+    retrieved, so output() on an rvalue outcome must leave rest() intact.
     \pre success (other)
     */
     template <class OtherOutcome> successful (OtherOutcome && other)
-    : output (::parse_ll::output (other)),
+    : output (::parse_ll::output (std::forward <OtherOutcome> (other))),
         rest (::parse_ll::rest (std::forward <OtherOutcome> (other)))
     {
         // This assertion is almost never triggered, because output (other)
@@ -0,0 +1,90 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Compile-time properties of parsers.
+
+Combinators use these to leave out checks and storage that can never make a
+difference, and to reject repetitions that would never finish.
+A property is std::true_type only if it is known to hold whatever the input
+and whatever the policy; std::false_type means only that it is not known to
+hold.
+Properties are specialised next to the parsers they are about, on decayed
+parser types.
+*/
+
+#ifndef PARSE_LL_CORE_PROPERTIES_HPP_INCLUDED
+#define PARSE_LL_CORE_PROPERTIES_HPP_INCLUDED
+
+#include <type_traits>
+
+#include "fwd.hpp"
+
+namespace parse_ll {
+
+/**
+Whether Parser never fails.
+(It may still throw, for example if it contains an expectation.)
+*/
+template <class Parser, class Enable /* = void */> struct always_succeeds
+: std::false_type {};
+
+/**
+Whether the rest of the input after Parser has succeeded is always the input
+that it was given.
+*/
+template <class Parser, class Enable /* = void */> struct never_consumes
+: std::false_type {};
+
+/**
+Whether Parser can succeed without consuming any input.
+A repetition of such a parser would go on forever.
+A parser that always succeeds must succeed on empty input, so that it may be
+empty.
+*/
+template <class Parser, class Enable /* = void */> struct may_be_empty
+: always_succeeds <Parser> {};
+
+namespace properties_detail {
+
+    template <bool value> struct bool_ : std::integral_constant <bool, value>
+    {};
+
+    template <class Parser1, class Parser2> struct both_always_succeed
+    : bool_ <always_succeeds <Parser1>::value
+        && always_succeeds <Parser2>::value> {};
+
+    template <class Parser1, class Parser2> struct both_never_consume
+    : bool_ <never_consumes <Parser1>::value
+        && never_consumes <Parser2>::value> {};
+
+    template <class Parser1, class Parser2> struct both_may_be_empty
+    : bool_ <may_be_empty <Parser1>::value
+        && may_be_empty <Parser2>::value> {};
+
+    template <class Parser1, class Parser2> struct either_always_succeeds
+    : bool_ <always_succeeds <Parser1>::value
+        || always_succeeds <Parser2>::value> {};
+
+    template <class Parser1, class Parser2> struct either_may_be_empty
+    : bool_ <may_be_empty <Parser1>::value
+        || may_be_empty <Parser2>::value> {};
+
+} // namespace properties_detail
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_PROPERTIES_HPP_INCLUDED
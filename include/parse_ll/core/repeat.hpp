@@ -25,6 +25,7 @@ It outputs a sequence of sub-parser outputs.
 #include <cassert>
 
 #include <boost/optional.hpp>
+#include <boost/compressed_pair.hpp>
 
 #include "range/core.hpp"
 
@@ -48,7 +49,8 @@ template <class SubParser> struct repeat_parser
     SubParser sub_parser;
     int minimum, maximum;
 public:
-    repeat_parser (SubParser const & sub_parser, int minimum, int maximum)
+    constexpr repeat_parser (
+        SubParser const & sub_parser, int minimum, int maximum)
     : sub_parser (sub_parser), minimum (minimum), maximum (maximum) {}
 };
 
@@ -56,38 +58,49 @@ struct repeat_parser_tag;
 template <class SubParser> struct decayed_parser_tag <repeat_parser <SubParser>>
 { typedef repeat_parser_tag type; };
 
+// The minimum is only known at run time, so neither always_succeeds nor
+// may_be_empty can be derived.
+template <class SubParser> struct never_consumes <repeat_parser <SubParser>>
+: never_consumes <SubParser> {};
+
 class repeat_parser_maker_bounds {
     int minimum, maximum;
 public:
-    repeat_parser_maker_bounds (int minimum, int maximum)
+    constexpr repeat_parser_maker_bounds (int minimum, int maximum)
     : minimum (minimum), maximum (maximum) {}
 
     template <class SubParser>
-        repeat_parser <SubParser>
+        constexpr repeat_parser <SubParser>
             operator[] (SubParser const & sub_parser) const
     { return repeat_parser <SubParser> (sub_parser, minimum, maximum); }
 };
 
 struct repeat_parser_maker {
     template <class SubParser>
-        repeat_parser <SubParser>
+        constexpr repeat_parser <SubParser>
             operator[] (SubParser const & sub_parser) const
-    { return repeat_parser <SubParser> (sub_parser, 0, -1); }
+    {
+        static_assert (!may_be_empty <SubParser>::value,
+            "repeat [p]: p can succeed without consuming input, "
+            "so the repetition would never finish.");
+        return repeat_parser <SubParser> (sub_parser, 0, -1);
+    }
 
-    repeat_parser_maker_bounds operator() (int count) const
+    constexpr repeat_parser_maker_bounds operator() (int count) const
     { return repeat_parser_maker_bounds (count, count); }
 
-    repeat_parser_maker_bounds operator() (int minimum, int maximum) const
+    constexpr repeat_parser_maker_bounds
+        operator() (int minimum, int maximum) const
     { return repeat_parser_maker_bounds (minimum, maximum); }
 
-    repeat_parser_maker_bounds at_least (int minimum) const
+    constexpr repeat_parser_maker_bounds at_least (int minimum) const
     { return repeat_parser_maker_bounds (minimum, -1); }
 
-    repeat_parser_maker_bounds at_most (int maximum) const
+    constexpr repeat_parser_maker_bounds at_most (int maximum) const
     { return repeat_parser_maker_bounds (0, maximum); }
 };
 
-static const auto repeat = repeat_parser_maker();
+static constexpr auto repeat = repeat_parser_maker();
 
 /**
 Implementations that are optimal in different scenarios.
@@ -134,6 +147,16 @@ namespace operation {
         { return "repeat"; }
     };
 
+    template <> struct lower <repeat_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        {
+            lowering.repeat (policy, parser.sub_parser,
+                parser.minimum, parser.maximum);
+        }
+    };
+
 } // namespace operation
 
 /**** Implementation: lazy ****/
@@ -147,21 +170,26 @@ the minimum number of sub-parses succeed.
 When actually producing the output, the sub-parses are regenerated.
 This may be faster in one case and slower in another.
 
-\todo
-It would be great if this would cause a static assertion failure in cases where
-the sub-parser always succeeds.
-Even I got caught out by this in writing test cases.
+The policy is kept in a compressed pair, so that it takes up no space if it is
+empty, as parse_policy::direct is.
+
+*p and +p cause a static assertion failure if p may succeed without consuming
+input (see may_be_empty), since the repetition would then never finish.
 */
 template <class Policy, class SubParser, class Input>
     struct repeat_outcome <Policy, SubParser, Input, repeat_type::lazy>
 {
-    Policy policy;
-    repeat_parser <SubParser> const * parser;
+    boost::compressed_pair <Policy, repeat_parser <SubParser> const *>
+        policy_and_parser;
     Input input;
 public:
     repeat_outcome (Policy const & policy,
         repeat_parser <SubParser> const & parser, Input const & input)
-    : policy (policy), parser (&parser), input (input) {}
+    : policy_and_parser (policy, &parser), input (input) {}
+
+    Policy const & policy() const { return policy_and_parser.first(); }
+    repeat_parser <SubParser> const & parser() const
+    { return *policy_and_parser.second(); }
 };
 
 namespace operation {
@@ -177,12 +205,12 @@ namespace operation {
             // Check whether the minimum number of parses of the sub-parser
             // can be obtained.
             Input current = outcome.input;
-            for (int count = 0; count < outcome.parser->minimum; ++ count) {
+            for (int count = 0; count < outcome.parser().minimum; ++ count) {
                 if (count != 0)
                     current = parse_ll::skip_over (
-                        outcome.policy.skip_parser(), current);
+                        outcome.policy().skip_parser(), current);
                 auto sub_outcome = parse_ll::parse (
-                    outcome.policy, outcome.parser->sub_parser, current);
+                    outcome.policy(), outcome.parser().sub_parser, current);
                 if (!::parse_ll::success (sub_outcome))
                     return false;
                 current = parse_ll::rest (sub_outcome);
@@ -215,8 +243,8 @@ namespace operation {
         {
             assert (::parse_ll::success (outcome));
             return repeat_output <Policy, SubParser, Input, repeat_type::lazy>
-                (outcome.policy,
-                    *outcome.parser, outcome.parser->maximum, outcome.input);
+                (outcome.policy(),
+                    outcome.parser(), outcome.parser().maximum, outcome.input);
         }
     };
 
@@ -231,17 +259,17 @@ namespace operation {
             assert (::parse_ll::success (outcome));
             // Run the sub_parser through the input.
             Input current = outcome.input;
-            for (int count = 0; count != outcome.parser->maximum; ++ count) {
+            for (int count = 0; count != outcome.parser().maximum; ++ count) {
                 auto sub_outcome = parse_ll::parse (
-                    outcome.policy, outcome.parser->sub_parser,
+                    outcome.policy(), outcome.parser().sub_parser,
                     // Only skip in between elements, not before.
                     (count == 0) ? current : parse_ll::skip_over (
-                        outcome.policy.skip_parser(), current));
+                        outcome.policy().skip_parser(), current));
                 // If the parser has failed, current is still at rest() applied
                 // to the sub-parser that last succeeded: the skip parser has
                 // not been applied.
                 if (! ::parse_ll::success (sub_outcome)) {
-                    assert (count >= outcome.parser->minimum);
+                    assert (count >= outcome.parser().minimum);
                     return current;
                 }
                 current = ::parse_ll::rest (sub_outcome);
@@ -265,9 +293,9 @@ drop() uses the rest of sub_outcome.
 template <class Policy, class SubParser, class Input>
     struct repeat_output <Policy, SubParser, Input, repeat_type::lazy>
 {
-    Policy policy;
-    // If this were a reference, the class could not be copy-assigned.
-    repeat_parser <SubParser> const * parser;
+    // If the parser were a reference, the class could not be copy-assigned.
+    boost::compressed_pair <Policy, repeat_parser <SubParser> const *>
+        policy_and_parser;
     int maximum;
     typedef typename detail::parser_outcome <Policy, SubParser, Input>::type
         sub_outcome_type;
@@ -276,9 +304,13 @@ public:
     repeat_output (Policy const & policy,
         repeat_parser <SubParser> const & parser,
         int maximum, Input const & input)
-    : policy (policy), parser (&parser), maximum (maximum),
+    : policy_and_parser (policy, &parser), maximum (maximum),
         sub_outcome (parse_ll::parse (policy, parser.sub_parser, input)) {}
 
+    Policy const & policy() const { return policy_and_parser.first(); }
+    repeat_parser <SubParser> const & parser() const
+    { return *policy_and_parser.second(); }
+
 private:
     friend class range::helper::member_access;
 
@@ -299,8 +331,8 @@ private:
     repeat_output drop_one (direction::front) const {
         assert (!empty (range::front));
         auto next_range = parse_ll::skip_over (
-            policy.skip_parser(), ::parse_ll::rest (sub_outcome));
-        return repeat_output (policy, *parser, maximum - 1, next_range);
+            policy().skip_parser(), ::parse_ll::rest (sub_outcome));
+        return repeat_output (policy(), parser(), maximum - 1, next_range);
     }
 };
 
@@ -50,6 +50,26 @@ Alternatively, SkipParser can be set to rule_explicit_skip_parser.
 In that case, the rule inside must provide a skip parser for itself, for example
 with skip (..) [...] or no_skip [], otherwise a compile error is generated.
 
+The code for the parser that a rule is initialised with is generated only in
+the source file where that happens.
+To compile a large grammar only once, therefore, initialise the rule in one
+source file, and declare a function that returns it in a header:
+\code
+// grammar.hpp
+parse_ll::rule <input_type, int> const & number_list();
+
+// grammar.cpp
+parse_ll::rule <input_type, int> const & number_list() {
+    static parse_ll::rule <input_type, int> const rule = ...;
+    return rule;
+}
+\endcode
+Other source files then only generate code for the virtual call.
+
+To be lowered into bytecode, a rule must be initialised with
+bytecode::lowerable (parser), from "bytecode/rule.hpp", so that the code for
+lowering is generated only for rules that need it.
+
 \internal
 This class works by keeping a pointer to an object of a virtual base class,
 detail::polymorphic_parser.
@@ -61,32 +81,117 @@ compilation unit, but used in other compilation units.
 */
 template <class Input, class Output, class SkipParser> struct rule;
 
-class rule_explicit_skip_parser;
+class rule_explicit_skip_parser : parse_policy::direct {
+public:
+    template <class OriginalPolicy>
+        rule_explicit_skip_parser (OriginalPolicy const &) {}
+
+    // This is not supposed to be called.
+    void skip_parser();
+};
 
 namespace detail {
 
+    /**
+    Non-owning reference to a skip parser of any type.
+    This is a parser with output void that parses with the skip parser it
+    refers to.
+    Like rule, it uses a function call that cannot be inlined, but unlike rule
+    it does not allocate memory or touch a reference count.
+    The skip parser referred to must outlive this object.
+    */
+    template <class Input> class skip_parser_reference
+    : public parser_base <skip_parser_reference <Input>>
+    {
+        typedef explicit_outcome <void, Input> (* parse_function_type) (
+            void const *, Input const &);
+
+        void const * skip_parser;
+        parse_function_type parse_function;
+
+        template <class SkipParser> static explicit_outcome <void, Input>
+            parse_with (void const * skip_parser, Input const & input)
+        {
+            return explicit_outcome <void, Input> (::parse_ll::parse (
+                *static_cast <SkipParser const *> (skip_parser), input));
+        }
+
+    public:
+        template <class SkipParser>
+            explicit skip_parser_reference (SkipParser const & skip_parser)
+        : skip_parser (&skip_parser),
+            parse_function (&parse_with <SkipParser>) {}
+
+        explicit_outcome <void, Input> parse (Input const & input) const
+        { return parse_function (skip_parser, input); }
+    };
+
     /**
     \return An appropriate proxy type for the skip parser.
     If SkipParser is non-void, this is just the skip parser itself.
-    If SkipParser is void, this is a rule.
+    If SkipParser is void, this is a skip_parser_reference.
     */
     template <class Input, class SkipParser> struct skip_parser_proxy
     { typedef SkipParser type; };
 
     template <class Input> struct skip_parser_proxy <Input, void>
-    { typedef rule <Input, void, fail_parser> type; };
+    { typedef skip_parser_reference <Input> type; };
+
+    /**
+    Refer to the skip parser of the original policy without copying it.
+    */
+    template <class Input, class SkipParser> class skip_parser_holder {
+        SkipParser const * skip_parser;
+    public:
+        explicit skip_parser_holder (SkipParser const & skip_parser)
+        : skip_parser (&skip_parser) {}
+
+        SkipParser const & get() const { return *skip_parser; }
+    };
+
+    template <class Input> class skip_parser_holder <Input, void> {
+        skip_parser_reference <Input> skip_parser;
+    public:
+        template <class SkipParser>
+            explicit skip_parser_holder (SkipParser const & skip_parser)
+        : skip_parser (skip_parser) {}
+
+        skip_parser_reference <Input> const & get() const
+        { return skip_parser; }
+    };
+
+    // rule_explicit_skip_parser is empty and must not be used, so keep it by
+    // value instead of referring to a temporary.
+    template <class Input>
+        class skip_parser_holder <Input, rule_explicit_skip_parser>
+    {
+        rule_explicit_skip_parser skip_parser;
+    public:
+        template <class SkipParser>
+            explicit skip_parser_holder (SkipParser const & skip_parser)
+        : skip_parser (skip_parser) {}
+
+        rule_explicit_skip_parser const & get() const { return skip_parser; }
+    };
+
+    template <class Input, class SkipParser> class opaque_policy;
 
     /**
     Polymorphic policy.
-    If SkipParser is non-void, this will have copied the skip parser from the
-    original policy, and no actual polymorphism is needed.
+    This refers to the skip parser of the original policy without copying it,
+    so it must only be used while the original policy exists.
+    This is the case in rule, since the outcome of the implementation is
+    converted into an explicit_outcome before it is returned.
+    If SkipParser is non-void, no actual polymorphism is needed.
     */
     template <class Input, class SkipParser> class polymorphic_policy
     : public parse_policy::direct
     {
         typedef typename skip_parser_proxy <Input, SkipParser>::type
             skip_parser_type;
-        skip_parser_type skip_parser_;
+        skip_parser_holder <Input, SkipParser> skip_parser_;
+
+        friend class opaque_policy <Input, SkipParser>;
     protected:
         // No copying unless the derived class is happy with it.
         polymorphic_policy (polymorphic_policy const &) = default;
@@ -95,7 +200,8 @@ namespace detail {
             polymorphic_policy (OriginalPolicy const & original_policy)
         : skip_parser_ (original_policy.skip_parser()) {}
 
-        skip_parser_type const & skip_parser() const { return skip_parser_; }
+        skip_parser_type const & skip_parser() const
+        { return skip_parser_.get(); }
     };
 
     /**
@@ -116,27 +222,29 @@ namespace detail {
     /**
     A policy with an implementation opaque to the caller.
     This class is copyable.
+    It keeps the actual policy by value: it is small, and this way, parsing a
+    rule does not allocate memory or touch a reference count, so that one
+    rule can be used from many threads at once without contention.
     */
     template <class Input, class SkipParser> class opaque_policy {
         typedef polymorphic_policy <Input, SkipParser> actual_policy_type;
-        std::shared_ptr <actual_policy_type> actual_policy;
+        actual_policy_type actual_policy;
 
         typedef typename skip_parser_proxy <Input, SkipParser>::type
             skip_parser_type;
     public:
         template <class OriginalPolicy>
             opaque_policy (OriginalPolicy const & original_policy)
-        : actual_policy (
-            std::make_shared <actual_policy_type> (original_policy)) {}
+        : actual_policy (original_policy) {}
 
         template <class Apply, class Policy, class Parser, class ActualInput>
             auto apply_parse (Policy const & policy, Parser const & parser,
                 ActualInput && input) const
-        RETURNS (actual_policy->template apply_parse <Apply> (
+        RETURNS (actual_policy.template apply_parse <Apply> (
             policy, parser, std::forward <ActualInput> (input)));
 
         skip_parser_type const & skip_parser() const
-        { return actual_policy->skip_parser(); }
+        { return actual_policy.skip_parser(); }
     };
 
     /**
@@ -159,6 +267,7 @@ namespace detail {
         class polymorphic_parser_implementation
     : public polymorphic_parser <Input, Output, SkipParser>
     {
+    protected:
         Parser parser;
     public:
         polymorphic_parser_implementation (Parser const & parser)
@@ -178,6 +287,23 @@ namespace detail {
         }
     };
 
+    /**
+    Create the implementation of a rule from the parser it is initialised
+    with.
+    This can be specialised for wrappers around parsers for which the
+    implementation must do more, like bytecode::lowerable.
+    */
+    template <class Input, class Output, class SkipParser, class Parser>
+        struct make_polymorphic_parser
+    {
+        static polymorphic_parser <Input, Output, SkipParser> * apply (
+            Parser const & parser)
+        {
+            return new polymorphic_parser_implementation <
+                Input, Output, SkipParser, Parser> (parser);
+        }
+    };
+
 } // namespace detail
 
 template <class Input, class Output, class SkipParser> struct rule
@@ -190,8 +316,8 @@ public:
     rule() {}
 
     template <class Parser> rule (Parser const & parser)
-    : implementation (new detail::polymorphic_parser_implementation <
-        Input, Output, SkipParser, Parser> (parser)) {}
+    : implementation (detail::make_polymorphic_parser <
+        Input, Output, SkipParser, Parser>::apply (parser)) {}
 };
 
 struct rule_tag;
@@ -199,6 +325,11 @@ template <class Input, class Output, class SkipParser>
     struct decayed_parser_tag <rule <Input, Output, SkipParser>>
 { typedef rule_tag type; };
 
+struct skip_parser_reference_tag;
+template <class Input>
+    struct decayed_parser_tag <detail::skip_parser_reference <Input>>
+{ typedef skip_parser_reference_tag type; };
+
 namespace operation {
 
     template <> struct parse <rule_tag> {
@@ -224,16 +355,25 @@ namespace operation {
         { return "rule (opaque)"; }
     };
 
-} // namespace operation
+    template <> struct parse <skip_parser_reference_tag> {
+        template <class Policy, class Input, class ActualInput>
+            explicit_outcome <void, ActualInput> operator() (Policy const &,
+                detail::skip_parser_reference <Input> const & parser,
+                ActualInput const & input) const
+        {
+            static_assert (std::is_same <Input, ActualInput>::value,
+                "The skip parser of a rule can only parse with the rule's "
+                "Input type");
+            return parser.parse (input);
+        }
+    };
 
-class rule_explicit_skip_parser : parse_policy::direct {
-public:
-    template <class OriginalPolicy>
-        rule_explicit_skip_parser (OriginalPolicy const &) {}
+    template <> struct describe <skip_parser_reference_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "skip parser (opaque)"; }
+    };
 
-    // This is not supposed to be called.
-    void skip_parser();
-};
+} // namespace operation
 
 } // namespace parse_ll
 
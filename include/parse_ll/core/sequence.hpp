@@ -25,9 +25,13 @@ Define a sequence parser, which parses two inputs after one another
 #include "core.hpp"
 #include "error.hpp"
 
+#include <cassert>
 // For std::tuple
 #include <utility>
 
+#include <type_traits>
+
+#include <boost/mpl/if.hpp>
 #include <boost/optional.hpp>
 #include <boost/utility/typed_in_place_factory.hpp>
 
@@ -39,7 +43,8 @@ template <bool expect, class Parser1, class Parser2> struct sequence_parser
     Parser1 parser_1;
     Parser2 parser_2;
 public:
-    sequence_parser (Parser1 const & parser_1, Parser2 const & parser_2)
+    constexpr sequence_parser (
+        Parser1 const & parser_1, Parser2 const & parser_2)
     : parser_1 (parser_1), parser_2 (parser_2) {}
 };
 
@@ -48,6 +53,16 @@ template <bool expect, class Parser1, class Parser2>
     struct decayed_parser_tag <sequence_parser <expect, Parser1, Parser2>>
 { typedef sequence_parser_tag type; };
 
+template <bool expect, class Parser1, class Parser2>
+    struct always_succeeds <sequence_parser <expect, Parser1, Parser2>>
+: properties_detail::both_always_succeed <Parser1, Parser2> {};
+template <bool expect, class Parser1, class Parser2>
+    struct never_consumes <sequence_parser <expect, Parser1, Parser2>>
+: properties_detail::both_never_consume <Parser1, Parser2> {};
+template <bool expect, class Parser1, class Parser2>
+    struct may_be_empty <sequence_parser <expect, Parser1, Parser2>>
+: properties_detail::both_may_be_empty <Parser1, Parser2> {};
+
 template <bool expect, class Policy, class Parser1, class Parser2, class Input,
     class Output1 = typename detail::parser_output <Policy, Parser1, Input
         >::type,
@@ -74,10 +89,17 @@ With a proper range library, it should probably be implemented with a variadic
 sequence of parsers.
 
 \note
-All outcomes are currently kept in memory.
-However, outcomes may be large-ish, and include redundant input ranges.
-It may be possible to keep a reduced version of the parses, that is asserted
-to have been successful and does not keep the input. Laborious.
+Outcomes may be large-ish, and include redundant input ranges, so only what
+success(), output() and rest() need is kept.
+outcome_2 is set if and only if outcome_1 was successful, so success
+(outcome_1) never needs to be recomputed.
+If the output of the first parser is void, its outcome is discarded once the
+second parser has been started.
+If the first parser always succeeds, outcome_2 is always set, so it is not
+kept in a boost::optional.
+If the second parser always succeeds, or in the expect parser variant,
+success() does not need to look at outcome_2.
+If both parsers always succeed, success() returns rime::true_type.
 
 \todo
 The lazy version of sequence_parser should roughly correspond to the one for
@@ -98,10 +120,6 @@ One of three options must be chosen:
 3.  >> following > will return a different error type, which contains both
     input ranges
 
-\todo
-When Rime gets used, it will be possible to automatically turn "expect" on
-if parser_2.success() is always true.
-
 \todo It would be good to get rid of Output1 and Output2, which might lead to
 horribly long compiler errors.
 However, in the recursive version of this, this makes operation::output very
@@ -116,27 +134,92 @@ struct sequence_outcome
         outcome_1_type;
     typedef typename detail::parser_outcome <Policy, Parser2, Input>::type
         outcome_2_type;
-    outcome_1_type outcome_1;
-    // If success (outcome_1):
-    boost::optional <outcome_2_type> outcome_2;
-    // If !success (outcome_1):
-    boost::optional <Input> input;
+    // If Output1 is void, outcome_1 is only needed to start parser_2.
+    typedef typename boost::mpl::if_ <std::is_same <Output1, void>,
+        detail::discarded_outcome, outcome_1_type>::type stored_outcome_1_type;
+
+    typedef always_succeeds <Parser1> parser_1_always_succeeds;
+    typedef typename boost::mpl::if_ <parser_1_always_succeeds,
+        outcome_2_type, boost::optional <outcome_2_type>>::type
+        stored_outcome_2_type;
+
+    stored_outcome_1_type outcome_1;
+    // Iff success (outcome_1):
+    stored_outcome_2_type outcome_2;
+
+private:
+    sequence_outcome (Policy const & policy, Parser2 const & parser_2,
+        outcome_1_type && first_outcome)
+    : outcome_1 (std::move (first_outcome)),
+        outcome_2 (parse_2 (parser_1_always_succeeds(), policy, parser_2,
+            kept_outcome_1 (this->outcome_1, first_outcome))) {}
+
+    static outcome_1_type const & kept_outcome_1 (
+        outcome_1_type const & stored, outcome_1_type const &)
+    { return stored; }
+    // discarded_outcome has not moved from first_outcome.
+    static outcome_1_type const & kept_outcome_1 (
+        detail::discarded_outcome const &, outcome_1_type const & original)
+    { return original; }
+
+    static boost::optional <outcome_2_type> parse_2 (std::false_type,
+        Policy const & policy, Parser2 const & parser_2,
+        outcome_1_type const & outcome_1)
+    {
+        if (!success (outcome_1))
+            return boost::optional <outcome_2_type>();
+        // The in-place factory makes sure that operator= is not needed.
+        boost::optional <outcome_2_type> outcome_2 (
+            boost::in_place <outcome_2_type, outcome_2_type> (
+                parse (policy, parser_2,
+                    skip_over (policy.skip_parser(), rest (outcome_1)))));
+        // For an expect parser, outcome_2 must succeed if outcome_1 does.
+        if (expect && !success (*outcome_2))
+            // Otherwise, construction fails.
+            throw error() << error_at <Input> (rest (outcome_1));
+        return outcome_2;
+    }
+
+    static outcome_2_type parse_2 (std::true_type,
+        Policy const & policy, Parser2 const & parser_2,
+        outcome_1_type const & outcome_1)
+    {
+        assert (success (outcome_1));
+        outcome_2_type outcome_2 = parse (policy, parser_2,
+            skip_over (policy.skip_parser(), rest (outcome_1)));
+        if (expect && !success (outcome_2))
+            throw error() << error_at <Input> (rest (outcome_1));
+        return outcome_2;
+    }
+
+    static bool is_set (boost::optional <outcome_2_type> const & outcome_2)
+    { return bool (outcome_2); }
+    static rime::true_type is_set (outcome_2_type const &)
+    { return rime::true_; }
+
+    static outcome_2_type const & get (
+        boost::optional <outcome_2_type> const & outcome_2)
+    { return *outcome_2; }
+    static outcome_2_type const & get (outcome_2_type const & outcome_2)
+    { return outcome_2; }
+
 public:
     sequence_outcome (Policy const & policy, Parser1 const & parser_1,
         Parser2 const & parser_2, Input const & input)
-    : outcome_1 (parse (policy, parser_1, input)) {
-        if (success (outcome_1)) {
-            // The in-place factory makes sure that operator= is not needed.
-            outcome_2 = boost::in_place <outcome_2_type, outcome_2_type> (
-                parse (policy, parser_2,
-                    skip_over (policy.skip_parser(), rest (outcome_1))));
-            // For an expect parser, outcome_2 must succeed if outcome_1 does.
-            if (expect && !success (*outcome_2))
-                // Otherwise, construction fails.
-                throw error() << error_at <Input> (rest (outcome_1));
-        } else
-            this->input = input;
-    }
+    : sequence_outcome (policy, parser_2, parse (policy, parser_1, input)) {}
+
+    /**
+    \return Whether the first parser succeeded, as a bool, or as
+    rime::true_type if it always succeeds.
+    */
+    auto has_outcome_2() const
+    -> decltype (is_set (std::declval <stored_outcome_2_type const &>()))
+    { return is_set (outcome_2); }
+
+    /**
+    \pre has_outcome_2().
+    */
+    outcome_2_type const & get_outcome_2() const { return get (outcome_2); }
 };
 
 namespace operation {
@@ -158,24 +241,70 @@ namespace operation {
         { return "sequence"; }
     };
 
+    template <> struct lower <sequence_parser_tag> {
+        template <class Lowering, class Policy, class Parser1, class Parser2>
+            void operator() (Lowering & lowering, Policy const & policy,
+                sequence_parser <false, Parser1, Parser2> const & parser) const
+        {
+            lowering.lower (policy, parser.parser_1);
+            lowering.skip (policy);
+            lowering.lower (policy, parser.parser_2);
+        }
+
+        // If parser_2 fails, throw an error at the end of parser_1.
+        template <class Lowering, class Policy, class Parser1, class Parser2>
+            void operator() (Lowering & lowering, Policy const & policy,
+                sequence_parser <true, Parser1, Parser2> const & parser) const
+        {
+            auto error = lowering.new_label();
+            auto done = lowering.new_label();
+            lowering.lower (policy, parser.parser_1);
+            lowering.choice (error);
+            lowering.skip (policy);
+            lowering.lower (policy, parser.parser_2);
+            lowering.commit (done);
+            lowering.place (error);
+            lowering.expect (::parse_ll::describe (parser.parser_2));
+            lowering.place (done);
+        }
+    };
+
+    namespace sequence_detail {
+
+        // Only whether outcome_2 is set matters.
+        template <class HasOutcome2, class Outcome>
+            HasOutcome2 success (std::true_type, HasOutcome2 has_outcome_2,
+                Outcome const &)
+        { return has_outcome_2; }
+
+        // outcome_2 is only set if outcome_1 succeeded.
+        template <class Outcome> bool success (std::false_type,
+            bool has_outcome_2, Outcome const & outcome)
+        {
+            return has_outcome_2
+                && ::parse_ll::success (outcome.get_outcome_2());
+        }
+
+        template <class Outcome> auto success (std::false_type,
+            rime::true_type, Outcome const & outcome)
+        RETURNS (::parse_ll::success (outcome.get_outcome_2()));
+
+    } // namespace sequence_detail
+
     template <bool except, class Policy,
             class Parser1, class Parser2, class Input>
         struct success <
             sequence_outcome <except, Policy, Parser1, Parser2, Input>>
     {
-        bool operator() (
-            sequence_outcome <false, Policy, Parser1, Parser2, Input>
-            const & outcome) const
-        {
-            return ::parse_ll::success (outcome.outcome_1)
-                && ::parse_ll::success (*outcome.outcome_2);
-        }
-        bool operator() (sequence_outcome <true, Policy, Parser1, Parser2, Input
-            > const & outcome) const
-        {
-            // If the first parser succeeds, the next must do too.
-            return ::parse_ll::success (outcome.outcome_1);
-        }
+        // If the first parser succeeds, the second must do too if this is
+        // an expect parser, or if the second parser always succeeds.
+        typedef std::integral_constant <bool,
+            except || always_succeeds <Parser2>::value> only_first;
+
+        auto operator() (sequence_outcome <except, Policy, Parser1, Parser2,
+            Input> const & outcome) const
+        RETURNS (sequence_detail::success (
+            only_first(), outcome.has_outcome_2(), outcome));
     };
 
     // something1 + someting2 -> tuple <something1, something2>
@@ -190,7 +319,7 @@ namespace operation {
         {
             return std::tuple <Output1, Output2> (
                 ::parse_ll::output (outcome.outcome_1),
-                ::parse_ll::output (*outcome.outcome_2));
+                ::parse_ll::output (outcome.get_outcome_2()));
         }
     };
     //*** Special case type 1: void
@@ -229,7 +358,7 @@ namespace operation {
                 Input> const & outcome) const
         {
             return std::tuple <Output2> (
-                ::parse_ll::output (*outcome.outcome_2));
+                ::parse_ll::output (outcome.get_outcome_2()));
         }
     };
     //*** Special case type 2: Parser1 is a sequence_parser.
@@ -245,7 +374,8 @@ namespace operation {
                 Input> const & outcome) const
         {
             return std::tuple_cat (::parse_ll::output (outcome.outcome_1),
-                std::tuple <Output2> (::parse_ll::output (*outcome.outcome_2)));
+                std::tuple <Output2> (
+                    ::parse_ll::output (outcome.get_outcome_2())));
         }
     };
     // tuple <something...> (from sequence_parser) + void
@@ -269,7 +399,7 @@ namespace operation {
     {
         Input operator() (sequence_outcome <except, Policy, Parser1, Parser2,
             Input> const & outcome) const
-        { return ::parse_ll::rest (*outcome.outcome_2); }
+        { return ::parse_ll::rest (outcome.get_outcome_2()); }
     };
 
 } // namespace operation
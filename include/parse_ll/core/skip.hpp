@@ -41,6 +41,17 @@ template <class SubParser, class SkipParser, bool pad>
     struct decayed_parser_tag <skip_inside <SubParser, SkipParser, pad>>
 { typedef skip_inside_tag type; };
 
+// With padding, the skip parser may consume input around the sub-parser.
+template <class SubParser, class SkipParser, bool pad>
+    struct always_succeeds <skip_inside <SubParser, SkipParser, pad>>
+: always_succeeds <SubParser> {};
+template <class SubParser, class SkipParser, bool pad>
+    struct never_consumes <skip_inside <SubParser, SkipParser, pad>>
+: properties_detail::bool_ <!pad && never_consumes <SubParser>::value> {};
+template <class SubParser, class SkipParser, bool pad>
+    struct may_be_empty <skip_inside <SubParser, SkipParser, pad>>
+: may_be_empty <SubParser> {};
+
 /**
 Create a parser that uses a specific skip parser inside the sub-parser.
 This is used as, for example, skip (whitespace) [sub_parser].
@@ -50,14 +61,15 @@ The expression skip (whitespace) constructs a skip_inside_directive.
 Calling its operator[] produces a skip_inside.
 skip_inside then changes the parse policy for its sub-parser.
 */
-template <class SkipParser> auto skip (SkipParser const & skip_parser)
+template <class SkipParser> constexpr auto skip (SkipParser const & skip_parser)
     RETURNS (skip_inside_directive <SkipParser, false> (skip_parser));
 /**
 Create a parser that uses a specific skip parser before, inside, and after the
 sub-parser.
 This is used as, for example, skip_pad (whitespace) [sub_parser].
 */
-template <class SkipParser> auto skip_pad (SkipParser const & skip_parser)
+template <class SkipParser>
+    constexpr auto skip_pad (SkipParser const & skip_parser)
     RETURNS (skip_inside_directive <SkipParser, true> (skip_parser));
 
 namespace parse_policy {
@@ -67,30 +79,60 @@ namespace parse_policy {
     /**
     Parse policy that uses a different skip parser that the original parser
     does.
+    The skip parser is not copied, so that copying the policy (which lazy
+    outcomes do) does not copy, say, rules in the skip parser.
+    Like the parser it is used with, the skip parser must outlive the policy
+    and the outcomes it is used in.
     */
     template <class SkipParser, class OriginalPolicy> struct skip_policy
     : public OriginalPolicy
     {
-        SkipParser skip_parser_;
+        SkipParser const * skip_parser_;
     public:
         skip_policy (SkipParser const & skip_parser_,
             OriginalPolicy const & original_policy)
-        : OriginalPolicy (original_policy), skip_parser_ (skip_parser_) {}
+        : OriginalPolicy (original_policy), skip_parser_ (&skip_parser_) {}
 
-        SkipParser const & skip_parser() const { return skip_parser_; }
+        SkipParser const & skip_parser() const { return *skip_parser_; }
 
         OriginalPolicy const & original_policy() const { return *this; }
     };
 
+    /**
+    The skip_policy that skip_inside uses inside.
+    If the original policy is itself a skip_policy, its skip parser would be
+    replaced anyway, so its original policy is wrapped instead.
+    This keeps the type of the policy from growing in a recursive grammar
+    (see static_rule) that uses skip [] inside the recursion.
+    */
+    template <class SkipParser, class OriginalPolicy> struct skip_policy_for {
+        typedef skip_policy <SkipParser, OriginalPolicy> type;
+        static type make (SkipParser const & skip_parser,
+            OriginalPolicy const & original_policy)
+        { return type (skip_parser, original_policy); }
+    };
+
+    template <class SkipParser, class OtherSkipParser, class OriginalPolicy>
+        struct skip_policy_for <SkipParser,
+            skip_policy <OtherSkipParser, OriginalPolicy>>
+    {
+        typedef skip_policy <SkipParser, OriginalPolicy> type;
+        static type make (SkipParser const & skip_parser,
+            skip_policy <OtherSkipParser, OriginalPolicy> const &
+                original_policy)
+        { return type (skip_parser, original_policy.original_policy()); }
+    };
+
 } // namespace parse_policy
 
 template <class SkipParser, bool pad> class skip_inside_directive {
     SkipParser skip_parser;
 public:
-    explicit skip_inside_directive (SkipParser const & skip_parser)
+    constexpr explicit skip_inside_directive (SkipParser const & skip_parser)
     : skip_parser (skip_parser) {}
 
-    template <class SubParser> skip_inside <SubParser, SkipParser, pad>
+    template <class SubParser>
+        constexpr skip_inside <SubParser, SkipParser, pad>
         operator[] (SubParser const & sub_parser) const {
         return skip_inside <SubParser, SkipParser, pad> (
             sub_parser, skip_parser);
@@ -107,7 +149,8 @@ template <class SubParser, class SkipParser, bool pad> struct skip_inside
     SubParser sub_parser;
     SkipParser skip_parser;
 public:
-    skip_inside (SubParser const & sub_parser, SkipParser const & skip_parser)
+    constexpr skip_inside (
+        SubParser const & sub_parser, SkipParser const & skip_parser)
     : sub_parser (sub_parser), skip_parser (skip_parser) {}
 };
 
@@ -147,7 +190,7 @@ namespace operation {
             Input const & input) const
             // Produce new policy function that wraps original_policy.
         RETURNS (parse_ll::parse (
-            parse_policy::skip_policy <SkipParser, OriginalPolicy> (
+            parse_policy::skip_policy_for <SkipParser, OriginalPolicy>::make (
                 parser.skip_parser, original_policy),
             parser.sub_parser, input));
 
@@ -157,10 +200,11 @@ namespace operation {
         auto operator() (OriginalPolicy const & original_policy,
             skip_inside <SubParser, SkipParser, true> const &
                 parser, Input const & input) const
-        RETURNS (skip_inside_pad_outcome <
-                parse_policy::skip_policy <SkipParser, OriginalPolicy>,
+        RETURNS (skip_inside_pad_outcome <typename
+                parse_policy::skip_policy_for <SkipParser, OriginalPolicy
+                    >::type,
                 SubParser, Input> (
-            parse_policy::skip_policy <SkipParser, OriginalPolicy> (
+            parse_policy::skip_policy_for <SkipParser, OriginalPolicy>::make (
                 parser.skip_parser, original_policy),
             parser.sub_parser, input));
     };
@@ -170,14 +214,32 @@ namespace operation {
         { return "(change skip parser used inside)"; }
     };
 
+    template <> struct lower <skip_inside_tag> {
+        template <class Lowering, class OriginalPolicy,
+            class SubParser, class SkipParser, bool pad>
+        void operator() (Lowering & lowering,
+            OriginalPolicy const & original_policy,
+            skip_inside <SubParser, SkipParser, pad> const & parser) const
+        {
+            auto policy = parse_policy::skip_policy_for <
+                SkipParser, OriginalPolicy>::make (
+                    parser.skip_parser, original_policy);
+            if (pad)
+                lowering.skip (policy);
+            lowering.lower (policy, parser.sub_parser);
+            if (pad)
+                lowering.skip (policy);
+        }
+    };
+
     // Handling skip_inside_pad_outcome:
     // success() propagates from the internal parser.
     template <class Policy, class SubParser, class Input>
         struct success <skip_inside_pad_outcome <Policy, SubParser, Input>>
     {
-        bool operator() (skip_inside_pad_outcome <Policy, SubParser, Input>
+        auto operator() (skip_inside_pad_outcome <Policy, SubParser, Input>
             const & outcome) const
-        { return ::parse_ll::success (outcome.outcome); }
+        RETURNS (::parse_ll::success (outcome.outcome));
     };
 
     // output() propagates from the internal parser.
@@ -0,0 +1,200 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define static_rule, a rule that is bound to its definition at compile time, so
+that recursive grammars can be written without type erasure.
+*/
+
+#ifndef PARSE_LL_CORE_STATIC_RULE_HPP_INCLUDED
+#define PARSE_LL_CORE_STATIC_RULE_HPP_INCLUDED
+
+#include <utility>
+#include <type_traits>
+
+#include <boost/utility/enable_if.hpp>
+
+#include "core.hpp"
+#include "outcome/explicit.hpp"
+
+namespace parse_ll {
+
+struct static_rule_base {};
+
+/**
+Rule whose definition is found at compile time.
+
+Unlike rule, a static_rule does not contain a parser.
+It is an empty class, derived from with CRTP, that names a definition which
+is bound to it with PARSE_LL_DEFINE_STATIC_RULE.
+The class can therefore be used before its definition is known, which is what
+recursive grammars need:
+\code
+struct list : parse_ll::static_rule <list> {};
+PARSE_LL_DEFINE_STATIC_RULE (list,
+    literal ('(') >> *(letter | list()) >> literal (')'))
+\endcode
+
+The definition is parsed with the same policy and input type as the
+static_rule, so no virtual function is called, the input type is not fixed,
+and the compiler can inline across the recursion.
+To keep the types of outcomes finite, the outcome of the definition is
+converted to an explicit_outcome <Output, Input>.
+Like rule, a static_rule therefore parses eagerly, and its output must be
+convertible to Output.
+To compile the rule in only one source file, see
+PARSE_LL_EXTERN_STATIC_RULE.
+rule is only needed where the parser is chosen at run time.
+
+The definition is constructed the first time it is needed, and it lives until
+the end of the program, so that outcomes can refer to it.
+
+\tparam Derived The class that derives from this.
+\tparam Output The output type.
+*/
+template <class Derived, class Output = void> struct static_rule
+: parser_base <Derived>, static_rule_base
+{
+    typedef Output output_type;
+};
+
+/**
+Bind a definition to a static_rule.
+Use this in the namespace of name, after name has been declared.
+The definition can refer to name and to any other static_rule, also ones that
+have not been defined yet.
+*/
+#define PARSE_LL_DEFINE_STATIC_RULE(name, ...) \
+    inline auto parse_ll_static_rule_definition (name const &) \
+    -> decltype (__VA_ARGS__) \
+    { return __VA_ARGS__; }
+
+/**
+Declare that a static_rule is instantiated for a policy and an input type in
+another source file, with PARSE_LL_INSTANTIATE_STATIC_RULE.
+Use this at global scope, in the header that declares the rule.
+Source files that include the header then do not need the definition of the
+rule, and do not compile it again.
+Policy and Input must be type names without commas, so use typedefs for
+template instantiations.
+\code
+// grammar.hpp
+namespace grammar { struct list : parse_ll::static_rule <list, int> {}; }
+PARSE_LL_EXTERN_STATIC_RULE (grammar::list,
+    parse_ll::parse_policy::direct, input_type)
+
+// grammar.cpp
+namespace grammar { PARSE_LL_DEFINE_STATIC_RULE (list, ...) }
+PARSE_LL_INSTANTIATE_STATIC_RULE (grammar::list,
+    parse_ll::parse_policy::direct, input_type)
+\endcode
+Parsing the rule with any other policy (for example, inside skip [])
+requires the definition, so declare and instantiate every combination that
+is used.
+*/
+#define PARSE_LL_EXTERN_STATIC_RULE(name, Policy, Input) \
+    extern template ::parse_ll::explicit_outcome <name::output_type, Input> \
+    parse_ll::static_rule_detail::parse_definition <name> ( \
+        Policy const &, Input const &);
+
+/**
+Instantiate a static_rule for a policy and an input type.
+Use this at global scope, in one source file, after the definition of the
+rule.
+*/
+#define PARSE_LL_INSTANTIATE_STATIC_RULE(name, Policy, Input) \
+    template ::parse_ll::explicit_outcome <name::output_type, Input> \
+    parse_ll::static_rule_detail::parse_definition <name> ( \
+        Policy const &, Input const &);
+
+struct static_rule_tag;
+template <class Rule> struct decayed_parser_tag <Rule, typename
+    boost::enable_if <std::is_base_of <static_rule_base, Rule>>::type>
+{ typedef static_rule_tag type; };
+
+namespace static_rule_detail {
+
+    /**
+    The definition of Rule, found through argument-dependent lookup.
+    */
+    template <class Rule> struct definition {
+        typedef decltype (parse_ll_static_rule_definition (
+            std::declval <Rule const &>())) type;
+
+        static type const & get() {
+            static type const value = parse_ll_static_rule_definition (Rule());
+            return value;
+        }
+    };
+
+    /**
+    Parse the definition of Rule.
+    This is not declared inline, so that PARSE_LL_EXTERN_STATIC_RULE can
+    prevent it from being instantiated.
+    */
+    template <class Rule, class Policy, class Input>
+        explicit_outcome <typename Rule::output_type, Input>
+        parse_definition (Policy const & policy, Input const & input);
+
+    template <class Rule, class Policy, class Input>
+        explicit_outcome <typename Rule::output_type, Input>
+        parse_definition (Policy const & policy, Input const & input)
+    {
+        typedef explicit_outcome <typename Rule::output_type, Input>
+            outcome_type;
+        auto outcome = ::parse_ll::parse (policy,
+            static_rule_detail::definition <Rule>::get(), input);
+        return outcome_type (std::move (outcome));
+    }
+
+} // namespace static_rule_detail
+
+namespace operation {
+
+    template <> struct parse <static_rule_tag> {
+        template <class Policy, class Rule, class Input>
+            explicit_outcome <typename Rule::output_type, Input> operator() (
+                Policy const & policy, Rule const &, Input const & input) const
+        { return static_rule_detail::parse_definition <Rule> (policy, input); }
+    };
+
+    template <> struct describe <static_rule_tag> {
+        template <class Rule> const char * operator() (Rule const &) const
+        { return "static rule"; }
+    };
+
+    /**
+    Lower a static_rule into a subroutine, once for every skip parser it is
+    used with, so that recursion becomes recursive calls.
+    */
+    template <> struct lower <static_rule_tag> {
+        template <class Lowering, class Policy, class Rule>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Rule const &) const
+        {
+            auto const & definition
+                = static_rule_detail::definition <Rule>::get();
+            lowering.call (&definition,
+                lowering.skip_label (policy.skip_parser()),
+                [&] { lowering.lower (policy, definition); });
+        }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_CORE_STATIC_RULE_HPP_INCLUDED
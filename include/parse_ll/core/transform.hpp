@@ -21,6 +21,11 @@ Define a parser wrapper that transforms the output of the parser.
 #ifndef PARSE_LL_BASE_TRANSFORM_HPP_INCLUDED
 #define PARSE_LL_BASE_TRANSFORM_HPP_INCLUDED
 
+#include <utility>
+#include <type_traits>
+
+#include <boost/optional.hpp>
+
 #include "utility/returns.hpp"
 
 #include "fwd.hpp"
@@ -36,7 +41,8 @@ template <class SubParser, class Actor> struct transform_parser
     SubParser sub_parser;
     Actor actor;
 public:
-    transform_parser (SubParser const & sub_parser, Actor const & actor)
+    constexpr transform_parser (
+        SubParser const & sub_parser, Actor const & actor)
     : sub_parser (sub_parser), actor (actor) {}
 };
 
@@ -45,21 +51,120 @@ template <class SubParser, class Actor>
     struct decayed_parser_tag <transform_parser <SubParser, Actor>>
 { typedef transform_parser_tag type; };
 
+template <class SubParser, class Actor>
+    struct always_succeeds <transform_parser <SubParser, Actor>>
+: always_succeeds <SubParser> {};
+template <class SubParser, class Actor>
+    struct never_consumes <transform_parser <SubParser, Actor>>
+: never_consumes <SubParser> {};
+template <class SubParser, class Actor>
+    struct may_be_empty <transform_parser <SubParser, Actor>>
+: may_be_empty <SubParser> {};
+
 template <class Parser, class Actor>
-    inline transform_parser <Parser, Actor> transform (
+    constexpr transform_parser <Parser, Actor> transform (
         Parser const & parser, Actor const & actor)
 {
     return transform_parser <Parser, Actor> (parser, actor);
 }
 
+/**
+Actor that ignores the output of the parser and returns a fixed value.
+This does the same as boost::phoenix::val, but can be constructed in a
+constant expression, so that parsers that use it can be constexpr.
+*/
+template <class Value> struct constant_actor {
+    Value value;
+public:
+    constexpr explicit constant_actor (Value const & value) : value (value) {}
+
+    template <class ... Arguments>
+        Value operator() (Arguments const & ...) const
+    { return value; }
+};
+
+/**
+\return An actor that returns value whatever it is called with.
+For example, literal ('-') [constant (-1)].
+*/
+template <class Value>
+    constexpr constant_actor <Value> constant (Value const & value)
+{ return constant_actor <Value> (value); }
+
+namespace transform_detail {
+
+    /**
+    Call the actor with the output of the sub-outcome, or with no arguments if
+    the output of the sub-outcome is void.
+    If the sub-outcome is an rvalue, so is its output, so that the actor can
+    move from it.
+    */
+    template <class SubOutput> struct call_actor {
+        template <class Actor, class SubOutcome>
+            auto operator() (Actor const & actor, SubOutcome && sub_outcome)
+            const
+        RETURNS (actor (::parse_ll::output (
+            std::forward <SubOutcome> (sub_outcome))));
+    };
+
+    template <> struct call_actor <void> {
+        template <class Actor, class SubOutcome>
+            auto operator() (Actor const & actor, SubOutcome &&) const
+        RETURNS (actor());
+    };
+
+    template <class Actor, class SubOutput> struct actor_result
+    : std::decay <decltype (std::declval <Actor const &>() (
+        std::declval <SubOutput>()))> {};
+
+    template <class Actor> struct actor_result <Actor, void>
+    : std::decay <decltype (std::declval <Actor const &>() ())> {};
+
+    /**
+    Outputs that cannot be copied out of a cache, like std::unique_ptr, are
+    not cached.
+    */
+    template <class Output> struct is_cached
+    : std::is_copy_constructible <Output> {};
+
+    template <> struct is_cached <void> : std::false_type {};
+
+    struct no_output_cache {};
+
+    template <class Output, bool Cached = is_cached <Output>::value>
+        struct output_cache
+    { typedef boost::optional <Output> type; };
+
+    template <class Output> struct output_cache <Output, false>
+    { typedef no_output_cache type; };
+
+} // namespace transform_detail
+
+/**
+Outcome of transform_parser.
+The output is computed by calling the actor the first time output() is called
+on an lvalue, and then cached, so that the actor is called at most once.
+The output type must therefore be move-assignable.
+If the output type cannot be copied, it is not cached, and the actor is called
+every time output() is called.
+If output() is called on an rvalue, the output of the sub-outcome is passed to
+the actor as an rvalue, so that the actor can move from it.
+The cache is not thread-safe, but outcomes are not normally shared between
+threads.
+*/
 template <class Policy, class SubParser, class Actor, class Input,
     class SubOutput = typename
         detail::parser_output <Policy, SubParser, Input>::type>
 struct transform_outcome {
     typedef typename detail::parser_outcome <Policy, SubParser, Input>::type
         sub_outcome_type;
+    typedef typename transform_detail::actor_result <Actor, SubOutput>::type
+        output_type;
+
     sub_outcome_type sub_outcome;
     Actor const * actor;
+    mutable typename transform_detail::output_cache <output_type>::type
+        output_cache;
 public:
     transform_outcome (Policy const & policy, SubParser const & sub_parser,
         Input const & input, Actor const & actor)
@@ -82,29 +187,78 @@ namespace operation {
         { return "transform"; }
     };
 
+    // Bytecode has no output, so the actor can be ignored.
+    template <> struct lower <transform_parser_tag> {
+        template <class Lowering, class Policy, class Parser>
+            void operator() (Lowering & lowering, Policy const & policy,
+                Parser const & parser) const
+        { lowering.lower (policy, parser.sub_parser); }
+    };
+
     template <class Policy, class SubParser, class Actor, class Input>
         struct success <transform_outcome <Policy, SubParser, Actor, Input>> {
-        bool operator() (transform_outcome <Policy, SubParser, Actor, Input>
+        auto operator() (transform_outcome <Policy, SubParser, Actor, Input>
             const & outcome) const
-        { return ::parse_ll::success (outcome.sub_outcome); }
+        RETURNS (::parse_ll::success (outcome.sub_outcome));
     };
 
+    namespace transform_detail {
+
+        template <class Outcome, class SubOutput, class Output,
+            bool Cached = parse_ll::transform_detail::is_cached <Output>::value>
+        struct output {
+            typedef parse_ll::transform_detail::call_actor <SubOutput>
+                call_actor;
+
+            // Return a copy, so that the output type does not become a
+            // reference into the outcome.
+            Output operator() (Outcome const & outcome) const {
+                if (!outcome.output_cache)
+                    outcome.output_cache =
+                        call_actor() (*outcome.actor, outcome.sub_outcome);
+                return *outcome.output_cache;
+            }
+
+            Output operator() (Outcome && outcome) const {
+                if (outcome.output_cache)
+                    return std::move (*outcome.output_cache);
+                else
+                    return call_actor() (
+                        *outcome.actor, std::move (outcome.sub_outcome));
+            }
+        };
+
+        // Output that is not cached: call the actor every time.
+        template <class Outcome, class SubOutput, class Output>
+            struct output <Outcome, SubOutput, Output, false>
+        {
+            typedef parse_ll::transform_detail::call_actor <SubOutput>
+                call_actor;
+
+            Output operator() (Outcome const & outcome) const
+            { return call_actor() (*outcome.actor, outcome.sub_outcome); }
+
+            Output operator() (Outcome && outcome) const {
+                return call_actor() (
+                    *outcome.actor, std::move (outcome.sub_outcome));
+            }
+        };
+
+        // void output: not implemented since this should never be called.
+        template <class Outcome, class SubOutput>
+            struct output <Outcome, SubOutput, void, false>
+        { void operator() (Outcome const &) const; };
+
+    } // namespace transform_detail
+
     template <class Policy, class SubParser, class Actor, class Input,
             typename SubOutput>
         struct output <transform_outcome <
-            Policy, SubParser, Actor, Input, SubOutput>> {
-        auto operator() (transform_outcome <Policy, SubParser, Actor, Input>
-            const & outcome) const
-        RETURNS ((*outcome.actor) (::parse_ll::output (outcome.sub_outcome)));
-    };
-    template <class Policy, class SubParser, class Actor, class Input>
-        struct output <
-            transform_outcome <Policy, SubParser, Actor, Input, void>>
-    {
-        auto operator() (transform_outcome <Policy, SubParser, Actor, Input>
-            const & outcome) const
-        RETURNS ((*outcome.actor)());
-    };
+            Policy, SubParser, Actor, Input, SubOutput>>
+    : transform_detail::output <
+        transform_outcome <Policy, SubParser, Actor, Input, SubOutput>,
+        SubOutput, typename transform_outcome <
+            Policy, SubParser, Actor, Input, SubOutput>::output_type> {};
 
     template <class Policy, class SubParser, class Actor, class Input>
         struct rest <transform_outcome <Policy, SubParser, Actor, Input>> {
@@ -32,18 +32,19 @@ Define whitespace parsers.
 namespace parse_ll {
 
 // horizontal_space
-static const auto space = literal (' ');
-static const auto tab = literal ('\t');
-static const auto one_horizontal_space = (space | tab);
-static const auto horizontal_space = *one_horizontal_space;
-
-static const auto line_feed = literal ('\n');
-static const auto carriage_return = literal ('\r');
-static const auto newline = line_feed | (carriage_return >> -line_feed);
-static const auto vertical_space = *(line_feed | carriage_return); // *newline
-
-static const auto one_whitespace = one_horizontal_space | newline;
-static const auto whitespace = *(space | tab | line_feed | carriage_return);
+static constexpr auto space = literal (' ');
+static constexpr auto tab = literal ('\t');
+static constexpr auto one_horizontal_space = (space | tab);
+static constexpr auto horizontal_space = *one_horizontal_space;
+
+static constexpr auto line_feed = literal ('\n');
+static constexpr auto carriage_return = literal ('\r');
+static constexpr auto newline = line_feed | (carriage_return >> -line_feed);
+// *newline
+static constexpr auto vertical_space = *(line_feed | carriage_return);
+
+static constexpr auto one_whitespace = one_horizontal_space | newline;
+static constexpr auto whitespace = *(space | tab | line_feed | carriage_return);
 
 } // namespace parse_ll
 
@@ -25,8 +25,10 @@ Observer that prints the trace out to a std::ostream.
 #include <iomanip>
 // For std::cout, which is a default parameter for ostream_observer.
 #include <iostream>
+#include <algorithm>
 
 #include "parse_ll/support/text_location_range.hpp"
+#include "parse_ll/support/utf8_range.hpp"
 
 namespace parse_ll {
 
@@ -71,6 +73,29 @@ class ostream_observer {
         print_input (start, finish);
     }
 
+    /**
+    Print UTF-8 text byte by byte, so that it shows as text, not code points.
+    */
+    void describe_consumed (range::utf8_range const & start,
+        range::utf8_range const & finish) const
+    {
+        *stream << " (" << finish.offset() << ")";
+        print_utf8 (start.position(), finish.position());
+    }
+
+    void print_utf8 (char const * start, char const * finish) const {
+        std::size_t length = std::min <std::size_t> (finish - start, 60);
+        // Do not split a multi-byte sequence.
+        while (length != std::size_t (finish - start)
+                && (start [length] & 0xc0) == 0x80)
+            -- length;
+        *stream << " \"";
+        stream->write (start, length);
+        *stream << "\"";
+        if (start + length != finish)
+            *stream << "...";
+    }
+
     template <class Input> void
         describe_start_input (range::text_location_range <Input> const & start)
         const
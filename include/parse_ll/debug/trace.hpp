@@ -21,7 +21,7 @@ Trace the steps inside parsers while parsing.
 #ifndef PARSE_LL_DEBUG_TRACE_HPP_INCLUDED
 #define PARSE_LL_DEBUG_TRACE_HPP_INCLUDED
 
-#include <cassert>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -33,6 +33,51 @@ namespace parse_ll {
 
 namespace parse_policy {
 
+    /**
+    State of a trace that is shared by all copies of a trace_policy.
+    It is kept in wrap_trace, which is part of the parser, so that it lives
+    as long as parsing is happening.
+
+    frames contains the trace_policy::apply_parse calls that are active, in
+    the order in which they were started; each has a serial number, which is
+    never reused, and a depth.
+    The root, with serial 0 and depth -1, is implicit.
+    */
+    template <class Observer, class Stop> struct trace_state {
+        struct frame {
+            std::size_t serial;
+            int depth;
+        };
+
+        Observer observer;
+        Stop stop;
+        std::size_t last_serial;
+        std::vector <frame> frames;
+
+        trace_state (Observer const & observer, Stop const & stop)
+        : observer (observer), stop (stop), last_serial (0) {}
+
+        bool active (std::size_t serial) const {
+            if (serial == 0)
+                return true;
+            for (auto current = frames.rbegin(); current != frames.rend();
+                    ++ current)
+            {
+                if (current->serial == serial)
+                    return true;
+                if (current->serial < serial)
+                    return false;
+            }
+            return false;
+        }
+
+        std::size_t top_serial() const
+        { return frames.empty() ? 0 : frames.back().serial; }
+
+        int top_depth() const
+        { return frames.empty() ? -1 : frames.back().depth; }
+    };
+
     /**
     This parse function policy that notifies an observer every time something
     is parsed and somthing is returned.
@@ -47,67 +92,45 @@ namespace parse_policy {
     To prevent these, this class needs to detect when it should and when it
     shouldn't generate trace messages.
 
-    It therefore keeps a list of parser depths as shared_ptr's.
-    It also keeps a weak_ptr to the greatest depth of the "parent" if it is
-    copy-constructed.
-    When the "parent" finishes at that depth, it releases the corresponding
-    shared_ptr.
-    Its copy can detect this by checking whether its parent_depth is expired.
+    The policy is only a handle to a trace_state, plus the serial number of
+    the call to apply_parse that was active when it was copied, its "parent",
+    and a flag that is set inside parsers that Stop selects.
+    Copying it therefore costs a few words on top of copying the original
+    policy.
+    When the parent finishes, the copy can detect this because the parent is
+    no longer in the list of active frames.
     In that case, it is being called as part of a lazy parse and can be ignored.
 
-    It is not turtles all the way down: wrap_trace (which is in the parse, so
-    it must be kept alive as long as parsing is happening) holds the root
-    pointer to symbolic depth -1.
-
     To get a complete parse, succeed() and rest() are always called explicitly.
     This may still yield some spurious not.
+
+    The trace_state is shared and not protected, so a parser with a trace in it
+    must not be used from more than one thread at the same time.
     */
     template <class OriginalPolicy, class Observer, class Stop>
         struct trace_policy
     : public OriginalPolicy
     {
-        Observer observer;
-        Stop stop;
-
+        typedef trace_state <Observer, Stop> state_type;
+        state_type * state;
+        std::size_t parent;
         mutable bool inhibit;
-        std::weak_ptr <int> parent_depth;
-        mutable std::vector <std::shared_ptr <int>> depths;
 
-        bool inhibited() const { return inhibit || parent_depth.expired(); }
-
-        int current_depth() const {
-            assert (!inhibited());
-            if (depths.empty())
-                return *parent_depth.lock();
-            else
-                return *depths.back();
-        }
+        bool inhibited() const
+        { return inhibit || !state->active (parent); }
 
     public:
         explicit trace_policy (OriginalPolicy const & original_policy_,
-            Observer const & observer, Stop const & stop,
-            std::shared_ptr <int> const & root_depth)
-        : OriginalPolicy (original_policy_), observer (observer), stop (stop),
-            inhibit (false), parent_depth (root_depth) {}
+            state_type & state)
+        : OriginalPolicy (original_policy_), state (&state),
+            parent (state.top_serial()), inhibit (false) {}
 
         trace_policy (trace_policy const & other)
-        : OriginalPolicy (other), observer (other.observer), stop (other.stop),
-          inhibit (other.inhibit) {
-            if (other.depths.empty())
-                // Simple copy
-                parent_depth = other.parent_depth;
-            else
-                // Dependent copy
-                parent_depth = other.depths.back();
-        }
-
-        ~trace_policy() {
-            /*
-            I'm not sure this assertion can never be triggered normally.
-            It can be triggered during exception unwinding, which is confusing.
-            */
-            // assert (parent_depth.expired() || depths.empty());
-        }
+        : OriginalPolicy (other), state (other.state),
+            // A copy made while other is active depends on the innermost
+            // active call, so that it is inhibited when that call finishes.
+            parent (other.inhibited() ? other.parent : state->top_serial()),
+            inhibit (other.inhibit) {}
 
         template <class Apply, class Policy, class Parser, class Input>
             auto apply_parse (
@@ -122,33 +145,46 @@ namespace parse_policy {
                 return original_policy().template apply_parse <Apply> (
                     policy, parser, input);
             else {
-                int depth = current_depth() + 1;
-                depths.push_back (std::make_shared <int> (depth));
-                // Notify observer.
-                observer.start_parse (depth, parser, input);
-
-                if (stop (parser))
-                    inhibit = true;
-
-                // Call the original policy.
-                auto outcome = original_policy().template apply_parse <Apply> (
-                    policy, parser, input);
-
-                if (inhibit)
+                int depth = state->top_depth() + 1;
+                std::size_t serial = ++ state->last_serial;
+                state->frames.push_back (
+                    typename state_type::frame {serial, depth});
+                try {
+                    // Notify observer.
+                    state->observer.start_parse (depth, parser, input);
+
+                    if (state->stop (parser))
+                        inhibit = true;
+
+                    // Call the original policy.
+                    auto outcome = original_policy().template
+                        apply_parse <Apply> (policy, parser, input);
+
+                    if (inhibit)
+                        inhibit = false;
+
+                    // Notify observer.
+                    if (success (outcome)) {
+                        // Run sub-parsers through the input once.
+                        Input remaining = rest (outcome);
+                        // Inhibit any further notifications.
+                        state->frames.pop_back();
+                        state->observer.success (
+                            depth, parser, input, remaining, outcome);
+                    } else {
+                        state->frames.pop_back();
+                        state->observer.no_success (depth, parser, input);
+                    }
+                    return std::move (outcome);
+                } catch (...) {
+                    // Remove the frame, so that later parses with the same
+                    // parser start at the right depth.
+                    if (!state->frames.empty()
+                            && state->frames.back().serial == serial)
+                        state->frames.pop_back();
                     inhibit = false;
-
-                // Notify observer.
-                if (success (outcome)) {
-                    // Run sub-parsers through the input once.
-                    Input remaining = rest (outcome);
-                    // Inhibit any further notifications.
-                    depths.pop_back();
-                    observer.success (depth, parser, input, remaining, outcome);
-                } else {
-                    depths.pop_back();
-                    observer.no_success (depth, parser, input);
+                    throw;
                 }
-                return std::move (outcome);
             }
         }
 
@@ -156,18 +192,16 @@ namespace parse_policy {
     };
 
     template <class Observer, class Stop> struct wrap_trace {
-        Observer observer;
-        Stop stop;
-        std::shared_ptr <int> root_depth;
+        std::shared_ptr <trace_state <Observer, Stop>> state;
     public:
         wrap_trace (Observer const & observer, Stop const & stop)
-        : observer (observer), stop (stop),
-            root_depth (std::make_shared <int> (-1)) {}
+        : state (std::make_shared <trace_state <Observer, Stop>> (
+            observer, stop)) {}
 
         template <class OriginalPolicy> auto
         operator() (OriginalPolicy const & original_policy) const
         RETURNS (trace_policy <OriginalPolicy, Observer, Stop> (
-            original_policy, observer, stop, root_depth));
+            original_policy, *state));
     };
 
     struct no_stop {
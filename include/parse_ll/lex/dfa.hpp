@@ -0,0 +1,460 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define a deterministic finite automaton that finds the longest match of a set
+of patterns.
+*/
+
+#ifndef PARSE_LL_LEX_DFA_HPP_INCLUDED
+#define PARSE_LL_LEX_DFA_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "range/core.hpp"
+
+#include "../core/error.hpp"
+#include "../core/char_class.hpp"
+
+#include "pattern.hpp"
+
+namespace parse_ll {
+
+namespace lex {
+
+/**
+Exception that is thrown when a lexer or a DFA cannot be built, or when a
+lexer finds text that no token matches.
+In the latter case, it contains a lex_offset.
+*/
+struct lex_error
+: public virtual boost::exception, public virtual std::exception {};
+
+typedef boost::error_info <struct lex_offset_tag, std::size_t> lex_offset;
+
+namespace dfa_detail {
+
+    /**
+    Nondeterministic finite automaton, built from patterns with Thompson's
+    construction.
+    Every state has at most one transition on a character class, and any
+    number of transitions on the empty string.
+    */
+    struct nfa {
+        struct state {
+            std::vector <std::size_t> empty_transitions;
+            // If next is not no_state, the transition on characters.
+            char_class characters;
+            std::size_t next;
+            // The index of the pattern that this state accepts, or -1.
+            int accepts;
+
+            state() : next (no_state), accepts (-1) {}
+        };
+
+        static const std::size_t no_state = std::size_t (-1);
+
+        std::vector <state> states;
+
+        std::size_t add_state() {
+            states.push_back (state());
+            return states.size() - 1;
+        }
+
+        void add_empty (std::size_t from, std::size_t to)
+        { states [from].empty_transitions.push_back (to); }
+
+        /**
+        Add states so that a path from "from" to "to" matches pattern p.
+        */
+        void add (pattern const & p, std::size_t from, std::size_t to) {
+            switch (p.type()) {
+            case pattern::kind::characters:
+                states [from].characters = p.characters();
+                states [from].next = to;
+                return;
+
+            case pattern::kind::sequence:
+                {
+                    std::size_t current = from;
+                    for (pattern const & element : p.children()) {
+                        std::size_t next = add_state();
+                        add (element, current, next);
+                        current = next;
+                    }
+                    add_empty (current, to);
+                    return;
+                }
+
+            case pattern::kind::alternative:
+                for (pattern const & option : p.children()) {
+                    std::size_t option_from = add_state();
+                    std::size_t option_to = add_state();
+                    add_empty (from, option_from);
+                    add (option, option_from, option_to);
+                    add_empty (option_to, to);
+                }
+                return;
+
+            case pattern::kind::repeat:
+                {
+                    pattern const & element = p.children().front();
+                    std::size_t current = from;
+                    for (int i = 0; i != p.minimum(); ++ i) {
+                        std::size_t next = add_state();
+                        add (element, current, next);
+                        current = next;
+                    }
+                    if (p.maximum() == pattern::unbounded) {
+                        std::size_t loop = add_state();
+                        std::size_t element_from = add_state();
+                        std::size_t element_to = add_state();
+                        add_empty (current, loop);
+                        add_empty (loop, element_from);
+                        add (element, element_from, element_to);
+                        add_empty (element_to, loop);
+                        add_empty (loop, to);
+                    } else {
+                        for (int i = p.minimum(); i < p.maximum(); ++ i) {
+                            std::size_t next = add_state();
+                            add_empty (current, to);
+                            add (element, current, next);
+                            current = next;
+                        }
+                        add_empty (current, to);
+                    }
+                    return;
+                }
+            }
+        }
+
+        /**
+        Extend "set" with all states reachable from it through transitions
+        on the empty string, and sort it.
+        */
+        void close (std::vector <std::size_t> & set) const {
+            std::vector <bool> in_set (states.size(), false);
+            for (std::size_t s : set)
+                in_set [s] = true;
+            for (std::size_t i = 0; i != set.size(); ++ i) {
+                for (std::size_t next : states [set [i]].empty_transitions) {
+                    if (!in_set [next]) {
+                        in_set [next] = true;
+                        set.push_back (next);
+                    }
+                }
+            }
+            std::sort (set.begin(), set.end());
+        }
+    };
+
+} // namespace dfa_detail
+
+/**
+Deterministic finite automaton that matches a list of patterns at once.
+It is built with the subset construction, and kept as a table with a row for
+every state and a column for every class of bytes that all patterns treat
+the same way.
+Finding a match therefore takes two table lookups per byte.
+
+If more than one pattern matches the same text, the one that comes first in
+the list is reported.
+State 0 is the dead state, from which no pattern can match.
+
+The subset construction can produce a number of states that is exponential
+in the size of the patterns, for example for [ab]*a[ab]{20}, so the number
+of states is limited.
+*/
+class dfa {
+public:
+    typedef std::uint32_t state_type;
+
+    static const state_type dead = 0;
+
+    /// The default maximum number of states, before minimisation.
+    static const std::size_t default_max_states = 1 << 14;
+
+    /**
+    Result of longest_match.
+    */
+    struct match {
+        // The number of characters that were matched.
+        std::size_t length;
+        // The index of the pattern that was matched, or -1 if none was.
+        int pattern;
+    };
+
+private:
+    unsigned char byte_class_ [256];
+    std::size_t class_num_;
+    state_type start_;
+    std::vector <state_type> table_;
+    std::vector <int> accepts_;
+
+    /**
+    Merge equivalent states, by refining a partition of the states until
+    states in the same block accept the same pattern and move to the same
+    blocks (Moore's algorithm).
+    The dead state stays state 0.
+    */
+    void minimise() {
+        std::size_t state_num = accepts_.size();
+        std::vector <state_type> block (accepts_.begin(), accepts_.end());
+        std::size_t block_num = 0;
+        while (true) {
+            std::map <std::vector <state_type>, state_type> signatures;
+            // Make sure the dead state is in block 0.
+            std::vector <state_type> new_block (state_num);
+            for (std::size_t state = 0; state != state_num; ++ state) {
+                std::vector <state_type> signature (1, block [state]);
+                for (std::size_t c = 0; c != class_num_; ++ c)
+                    signature.push_back (
+                        block [table_ [state * class_num_ + c]]);
+                new_block [state] = signatures.insert (std::make_pair (
+                    signature, state_type (signatures.size())))
+                    .first->second;
+            }
+            block = std::move (new_block);
+            if (signatures.size() == block_num)
+                break;
+            block_num = signatures.size();
+        }
+
+        std::vector <state_type> table (block_num * class_num_);
+        std::vector <int> accepts (block_num);
+        for (std::size_t state = 0; state != state_num; ++ state) {
+            accepts [block [state]] = accepts_ [state];
+            for (std::size_t c = 0; c != class_num_; ++ c)
+                table [block [state] * class_num_ + c]
+                    = block [table_ [state * class_num_ + c]];
+        }
+        start_ = block [start_];
+        table_ = std::move (table);
+        accepts_ = std::move (accepts);
+    }
+
+    /**
+    Merge classes of bytes that lead to the same state from every state.
+    Different patterns can cut up the same bytes differently (for example,
+    [a-z] | [A-Z] and [a-zA-Z]), so this makes the table smaller.
+    */
+    void merge_classes() {
+        std::size_t state_num = accepts_.size();
+        std::map <std::vector <state_type>, unsigned char> columns;
+        std::vector <unsigned char> new_class (class_num_);
+        std::vector <std::size_t> kept;
+        for (std::size_t c = 0; c != class_num_; ++ c) {
+            std::vector <state_type> column;
+            for (std::size_t state = 0; state != state_num; ++ state)
+                column.push_back (table_ [state * class_num_ + c]);
+            auto inserted = columns.insert (std::make_pair (
+                column, static_cast <unsigned char> (kept.size())));
+            if (inserted.second)
+                kept.push_back (c);
+            new_class [c] = inserted.first->second;
+        }
+
+        std::vector <state_type> table;
+        for (std::size_t state = 0; state != state_num; ++ state)
+            for (std::size_t c : kept)
+                table.push_back (table_ [state * class_num_ + c]);
+        for (unsigned char & byte_class : byte_class_)
+            byte_class = new_class [byte_class];
+        table_ = std::move (table);
+        class_num_ = kept.size();
+    }
+
+public:
+    /**
+    Construct a DFA that matches nothing.
+    */
+    dfa() : class_num_ (1), start_ (dead), table_ (1, state_type (dead)),
+        accepts_ (1, -1)
+    { std::fill (byte_class_, byte_class_ + 256, 0); }
+
+    /**
+    \throw lex_error if the subset construction produces more than
+        max_states states.
+    */
+    explicit dfa (std::vector <pattern> const & patterns,
+        std::size_t max_states = default_max_states)
+    {
+        dfa_detail::nfa automaton;
+        std::size_t nfa_start = automaton.add_state();
+        for (std::size_t index = 0; index != patterns.size(); ++ index) {
+            std::size_t from = automaton.add_state();
+            std::size_t to = automaton.add_state();
+            automaton.add_empty (nfa_start, from);
+            automaton.add (patterns [index], from, to);
+            automaton.states [to].accepts = int (index);
+        }
+
+        // Put bytes in the same class if every transition treats them the
+        // same way.
+        std::vector <char_class> transition_classes;
+        for (auto const & state : automaton.states)
+            if (state.next != dfa_detail::nfa::no_state)
+                transition_classes.push_back (state.characters);
+        std::map <std::vector <bool>, unsigned char> signatures;
+        std::vector <unsigned char> representatives;
+        for (int byte = 0; byte != 256; ++ byte) {
+            std::vector <bool> signature;
+            signature.reserve (transition_classes.size());
+            for (char_class const & characters : transition_classes)
+                signature.push_back (
+                    characters.contains (static_cast <char> (byte)));
+            auto inserted = signatures.insert (std::make_pair (
+                signature, static_cast <unsigned char> (signatures.size())));
+            if (inserted.second)
+                representatives.push_back (static_cast <unsigned char> (byte));
+            byte_class_ [byte] = inserted.first->second;
+        }
+        class_num_ = representatives.size();
+
+        // Subset construction.
+        std::map <std::vector <std::size_t>, state_type> state_numbers;
+        std::vector <std::vector <std::size_t>> sets;
+        auto number = [&] (std::vector <std::size_t> set) -> state_type {
+            automaton.close (set);
+            auto found = state_numbers.find (set);
+            if (found != state_numbers.end())
+                return found->second;
+            if (sets.size() == max_states) {
+                throw lex_error() << error_description (
+                    "The automaton for the patterns has too many states");
+            }
+            state_type result = state_type (sets.size());
+            state_numbers [set] = result;
+            sets.push_back (std::move (set));
+            return result;
+        };
+        number (std::vector <std::size_t>());
+        start_ = number (std::vector <std::size_t> (1, nfa_start));
+
+        for (std::size_t current = 0; current != sets.size(); ++ current) {
+            // number() may add to sets, so copy this one.
+            std::vector <std::size_t> const set = sets [current];
+            int accepts = -1;
+            for (std::size_t s : set) {
+                int state_accepts = automaton.states [s].accepts;
+                if (state_accepts != -1
+                        && (accepts == -1 || state_accepts < accepts))
+                    accepts = state_accepts;
+            }
+            accepts_.push_back (accepts);
+
+            for (unsigned char byte : representatives) {
+                std::vector <std::size_t> next;
+                for (std::size_t s : set) {
+                    auto const & state = automaton.states [s];
+                    if (state.next != dfa_detail::nfa::no_state
+                            && state.characters.contains (
+                                static_cast <char> (byte)))
+                        next.push_back (state.next);
+                }
+                state_type next_number = number (std::move (next));
+                table_.push_back (next_number);
+            }
+        }
+
+        minimise();
+        merge_classes();
+    }
+
+    /**
+    \return The number of states, including the dead state.
+    */
+    std::size_t state_num() const { return accepts_.size(); }
+
+    /**
+    \return The number of classes of bytes.
+    */
+    std::size_t class_num() const { return class_num_; }
+
+    state_type start() const { return start_; }
+
+    state_type next (state_type state, char c) const {
+        return table_ [state * class_num_
+            + byte_class_ [static_cast <unsigned char> (c)]];
+    }
+
+    /**
+    \return The index of the pattern that is matched in state, or -1.
+    */
+    int accepts (state_type state) const { return accepts_ [state]; }
+
+    /**
+    Find the longest prefix of [begin, end) that matches one of the patterns.
+    This is the inner loop of the lexer.
+    */
+    match longest_match (char const * begin, char const * end) const {
+        match result = {0, accepts_ [start_]};
+        state_type const * table = table_.data();
+        int const * accepts = accepts_.data();
+        std::size_t const class_num = class_num_;
+        state_type state = start_;
+        for (char const * current = begin; current != end; ++ current) {
+            state = table [state * class_num
+                + byte_class_ [static_cast <unsigned char> (*current)]];
+            if (state == dead)
+                break;
+            if (accepts [state] != -1) {
+                result.length = std::size_t (current - begin) + 1;
+                result.pattern = accepts [state];
+            }
+        }
+        return result;
+    }
+
+    /**
+    Find the longest prefix of input that matches one of the patterns.
+    input can be any range of char.
+    \return The match, and the rest of the input after it.
+    */
+    template <class Input>
+        std::pair <match, Input> longest_match (Input input) const
+    {
+        match result = {0, accepts_ [start_]};
+        Input rest = input;
+        std::size_t length = 0;
+        state_type state = start_;
+        while (!::range::empty (input)) {
+            state = next (state, ::range::first (input));
+            if (state == dead)
+                break;
+            input = ::range::drop (input);
+            ++ length;
+            if (accepts_ [state] != -1) {
+                result.length = length;
+                result.pattern = accepts_ [state];
+                rest = input;
+            }
+        }
+        return std::make_pair (result, rest);
+    }
+};
+
+} // namespace lex
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_LEX_DFA_HPP_INCLUDED
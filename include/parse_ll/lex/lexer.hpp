@@ -0,0 +1,167 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define a lexer, which turns text into a sequence of tokens in one pass, with
+a DFA.
+*/
+
+#ifndef PARSE_LL_LEX_LEXER_HPP_INCLUDED
+#define PARSE_LL_LEX_LEXER_HPP_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+#include "range/core.hpp"
+
+#include "../core/error.hpp"
+
+#include "pattern.hpp"
+#include "dfa.hpp"
+
+namespace parse_ll {
+
+namespace lex {
+
+/**
+Token produced by a lexer: the kind of token, and the text it spans.
+The text is not copied, so it must outlive the token.
+*/
+struct token {
+    int kind;
+    char const * begin;
+    char const * end;
+
+    std::size_t size() const { return std::size_t (end - begin); }
+    std::string text() const { return std::string (begin, end); }
+
+    bool operator == (token const & other) const
+    { return kind == other.kind && begin == other.begin && end == other.end; }
+    bool operator != (token const & other) const
+    { return !(*this == other); }
+};
+
+/**
+Kind for tokens that the lexer drops, for example whitespace and comments.
+*/
+static const int ignore = -1;
+
+/**
+Definition of one kind of token for a lexer.
+*/
+struct token_definition {
+    int kind;
+    lex::pattern pattern;
+
+    token_definition (int kind, lex::pattern const & pattern)
+    : kind (kind), pattern (pattern) {}
+};
+
+/**
+Lexer that splits text into tokens.
+It is defined by a list of token definitions, which are compiled into one
+DFA:
+\code
+enum kind { identifier, number, plus };
+auto letter = lex::between ('a', 'z');
+auto digit = lex::between ('0', '9');
+lex::lexer lexer ({
+    {identifier, letter >> *(letter | digit)},
+    {number, +digit},
+    {plus, lex::literal ('+')},
+    {lex::ignore, +lex::one_of (" \t\n")}});
+std::vector <lex::token> tokens = lexer.tokenize (text);
+\endcode
+At every position, the lexer takes the longest token that matches.
+If more than one definition matches the same text, the first one wins, so
+keywords should be defined before identifiers.
+Tokens with kind lex::ignore are dropped, so that the parser never sees, for
+example, whitespace.
+
+The tokens can then be parsed with token() parsers, by passing
+range::view (tokens) as input.
+*/
+class lexer {
+    std::vector <int> kinds_;
+    lex::dfa dfa_;
+
+    static std::vector <lex::pattern> patterns (
+        std::vector <token_definition> const & definitions)
+    {
+        std::vector <lex::pattern> result;
+        for (token_definition const & definition : definitions) {
+            if (definition.kind < ignore)
+                throw lex_error() << error_description (
+                    "Token kinds must not be negative");
+            if (definition.pattern.matches_empty())
+                throw lex_error() << error_description (
+                    "A token definition matches the empty string");
+            result.push_back (definition.pattern);
+        }
+        return result;
+    }
+
+public:
+    /**
+    \throw lex_error if a definition matches the empty string, or its kind
+    is negative and not lex::ignore, or if the DFA has too many states.
+    */
+    explicit lexer (std::vector <token_definition> const & definitions)
+    : dfa_ (patterns (definitions)) {
+        for (token_definition const & definition : definitions)
+            kinds_.push_back (definition.kind);
+    }
+
+    lexer (std::initializer_list <token_definition> definitions)
+    : lexer (std::vector <token_definition> (definitions)) {}
+
+    lex::dfa const & dfa() const { return dfa_; }
+
+    /**
+    Split [begin, end) into tokens.
+    \throw lex_error with a lex_offset if no token matches at some point.
+    */
+    std::vector <token> tokenize (char const * begin, char const * end) const
+    {
+        std::vector <token> tokens;
+        char const * current = begin;
+        while (current != end) {
+            auto match = dfa_.longest_match (current, end);
+            if (match.pattern == -1)
+                throw lex_error() << error_description ("No token matches")
+                    << lex_offset (std::size_t (current - begin));
+            int kind = kinds_ [match.pattern];
+            if (kind != ignore) {
+                token t = {kind, current, current + match.length};
+                tokens.push_back (t);
+            }
+            current += match.length;
+        }
+        return tokens;
+    }
+
+    std::vector <token> tokenize (std::string const & text) const
+    { return tokenize (text.data(), text.data() + text.size()); }
+};
+
+} // namespace lex
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_LEX_LEXER_HPP_INCLUDED
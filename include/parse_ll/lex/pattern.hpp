@@ -0,0 +1,232 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define regular patterns, from which a lexer is built.
+*/
+
+#ifndef PARSE_LL_LEX_PATTERN_HPP_INCLUDED
+#define PARSE_LL_LEX_PATTERN_HPP_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "../core/char_class.hpp"
+
+namespace parse_ll {
+
+namespace lex {
+
+/**
+Regular pattern over bytes.
+Patterns are built from literal(), one_of(), none_of(), between() and any(),
+and combined as parsers are: with >> for sequences, | for alternatives, and
+prefix *, + and - for repetition and optional patterns.
+Unlike parsers, patterns do not backtrack: alternatives are not ordered, and
+repetitions are not greedy.
+Instead, the lexer or regex_parser that uses them finds the longest match.
+
+A pattern is cheap to copy: it shares its sub-patterns.
+*/
+class pattern {
+public:
+    enum class kind { characters, sequence, alternative, repeat };
+
+    /**
+    Value of maximum() that indicates that there is no maximum.
+    */
+    static const int unbounded = -1;
+
+private:
+    struct node {
+        kind type;
+        char_class characters;
+        std::vector <pattern> children;
+        int minimum, maximum;
+
+        node (kind type, char_class const & characters,
+            std::vector <pattern> children, int minimum, int maximum)
+        : type (type), characters (characters),
+            children (std::move (children)),
+            minimum (minimum), maximum (maximum) {}
+    };
+
+    std::shared_ptr <node const> node_;
+
+    pattern (kind type, char_class const & characters,
+        std::vector <pattern> children, int minimum, int maximum)
+    : node_ (std::make_shared <node const> (type, characters,
+        std::move (children), minimum, maximum)) {}
+
+public:
+    /**
+    Construct a pattern that matches one character from characters.
+    */
+    explicit pattern (char_class const & characters)
+    : pattern (kind::characters, characters, std::vector <pattern>(), 1, 1)
+    {}
+
+    /**
+    \return A pattern that matches the patterns in elements one after the
+    other.
+    If elements is empty, the pattern matches the empty string.
+    */
+    static pattern sequence (std::vector <pattern> elements) {
+        return pattern (kind::sequence, char_class(), std::move (elements),
+            1, 1);
+    }
+
+    /**
+    \return A pattern that matches any of the patterns in options.
+    If options is empty, the pattern matches nothing.
+    */
+    static pattern alternative (std::vector <pattern> options) {
+        return pattern (kind::alternative, char_class(), std::move (options),
+            1, 1);
+    }
+
+    /**
+    \return A pattern that matches sub_pattern at least minimum and at most
+    maximum times.
+    maximum can be pattern::unbounded.
+    */
+    static pattern repeat (pattern const & sub_pattern,
+        int minimum, int maximum = unbounded)
+    {
+        return pattern (kind::repeat, char_class(),
+            std::vector <pattern> (1, sub_pattern), minimum, maximum);
+    }
+
+    kind type() const { return node_->type; }
+
+    /**
+    \return For kind::characters, the characters that are matched.
+    */
+    char_class const & characters() const { return node_->characters; }
+
+    /**
+    \return For kind::sequence and kind::alternative, the sub-patterns.
+    For kind::repeat, a vector with the one sub-pattern.
+    */
+    std::vector <pattern> const & children() const
+    { return node_->children; }
+
+    int minimum() const { return node_->minimum; }
+    int maximum() const { return node_->maximum; }
+
+    /**
+    \return true iff the pattern matches the empty string.
+    */
+    bool matches_empty() const {
+        switch (type()) {
+        case kind::characters:
+            return false;
+        case kind::sequence:
+            for (pattern const & child : children())
+                if (!child.matches_empty())
+                    return false;
+            return true;
+        case kind::alternative:
+            for (pattern const & child : children())
+                if (child.matches_empty())
+                    return true;
+            return false;
+        default:
+            return minimum() == 0 || children().front().matches_empty();
+        }
+    }
+};
+
+/**
+\return A pattern that matches text.
+*/
+inline pattern literal (std::string const & text) {
+    std::vector <pattern> characters;
+    for (char c : text) {
+        char_class one;
+        one.add (c);
+        characters.emplace_back (one);
+    }
+    if (characters.size() == 1)
+        return characters.front();
+    return pattern::sequence (std::move (characters));
+}
+
+inline pattern literal (char c) { return literal (std::string (1, c)); }
+
+/**
+\return A pattern that matches any one of characters.
+*/
+inline pattern one_of (std::string const & characters)
+{ return pattern (char_class (characters)); }
+
+/**
+\return A pattern that matches any one character that is not in characters.
+*/
+inline pattern none_of (std::string const & characters) {
+    char_class excluded (characters);
+    char_class result;
+    for (int c = 0; c != 256; ++ c)
+        if (!excluded.contains (static_cast <char> (c)))
+            result.add (static_cast <char> (c));
+    return pattern (result);
+}
+
+/**
+\return A pattern that matches one character between first and last,
+inclusive, as unsigned char.
+*/
+inline pattern between (char first, char last) {
+    char_class characters;
+    for (int c = static_cast <unsigned char> (first);
+            c <= static_cast <unsigned char> (last); ++ c)
+        characters.add (static_cast <char> (c));
+    return pattern (characters);
+}
+
+/**
+\return A pattern that matches any one character.
+*/
+inline pattern any() {
+    char_class all;
+    for (int c = 0; c != 256; ++ c)
+        all.add (static_cast <char> (c));
+    return pattern (all);
+}
+
+inline pattern operator >> (pattern const & first, pattern const & second)
+{ return pattern::sequence ({first, second}); }
+
+inline pattern operator | (pattern const & first, pattern const & second)
+{ return pattern::alternative ({first, second}); }
+
+inline pattern operator * (pattern const & sub_pattern)
+{ return pattern::repeat (sub_pattern, 0); }
+
+inline pattern operator + (pattern const & sub_pattern)
+{ return pattern::repeat (sub_pattern, 1); }
+
+inline pattern operator - (pattern const & sub_pattern)
+{ return pattern::repeat (sub_pattern, 0, 1); }
+
+} // namespace lex
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_LEX_PATTERN_HPP_INCLUDED
@@ -0,0 +1,510 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define a parser that matches a regular expression, by compiling it into a
+DFA.
+*/
+
+#ifndef PARSE_LL_LEX_REGEX_HPP_INCLUDED
+#define PARSE_LL_LEX_REGEX_HPP_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "range/core.hpp"
+
+#include "../core/core.hpp"
+#include "../core/error.hpp"
+#include "../core/outcome/failed.hpp"
+#include "../core/outcome/explicit.hpp"
+
+#include "pattern.hpp"
+#include "dfa.hpp"
+#include "lexer.hpp"
+
+namespace parse_ll {
+
+namespace lex {
+
+namespace regex_detail {
+
+    /**
+    The maximum number of copies of single characters that a pattern may
+    expand into when repetitions are written out, as the DFA construction
+    does.
+    This limits the size of nested repetitions like (a{1000}){1000}.
+    */
+    static const std::size_t max_expanded_size = 1 << 16;
+
+    /**
+    \return The number of copies of single characters that p expands into,
+    or max_expanded_size + 1 if it is greater.
+    */
+    inline std::size_t expanded_size (pattern const & p) {
+        static const std::size_t too_large = max_expanded_size + 1;
+        std::size_t result = 0;
+        switch (p.type()) {
+        case pattern::kind::characters:
+            return 1;
+        case pattern::kind::sequence:
+        case pattern::kind::alternative:
+            for (pattern const & child : p.children()) {
+                result += expanded_size (child);
+                if (result >= too_large)
+                    return too_large;
+            }
+            return result;
+        case pattern::kind::repeat:
+            {
+                std::size_t copies = p.maximum() == pattern::unbounded
+                    ? std::size_t (p.minimum()) + 1
+                    : std::size_t (p.maximum());
+                result = expanded_size (p.children().front());
+                if (copies != 0 && result > max_expanded_size / copies)
+                    return too_large;
+                return result * copies;
+            }
+        }
+        return result;
+    }
+
+    /**
+    Recursive-descent reader for regular expressions.
+    */
+    class reader {
+        std::string const & expression;
+        std::size_t position;
+
+        lex_error error (std::string const & description) const {
+            return lex_error() << error_description (description)
+                << lex_offset (position);
+        }
+
+        bool at_end() const { return position == expression.size(); }
+        char peek() const { return expression [position]; }
+
+        static char_class digits() {
+            char_class result;
+            for (char c = '0'; c <= '9'; ++ c)
+                result.add (c);
+            return result;
+        }
+
+        static char_class word() {
+            char_class result = digits();
+            for (char c = 'a'; c <= 'z'; ++ c)
+                result.add (c);
+            for (char c = 'A'; c <= 'Z'; ++ c)
+                result.add (c);
+            result.add ('_');
+            return result;
+        }
+
+        static char_class space() { return char_class (" \t\n\r\f\v"); }
+
+        static char_class complement (char_class const & characters) {
+            char_class result;
+            for (int c = 0; c != 256; ++ c)
+                if (!characters.contains (static_cast <char> (c)))
+                    result.add (static_cast <char> (c));
+            return result;
+        }
+
+        static char_class single (char c) {
+            char_class result;
+            result.add (c);
+            return result;
+        }
+
+        static int hex_value (char c) {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+
+        /**
+        Read an escape sequence, after the backslash.
+        \return The class of characters that it matches.
+        */
+        char_class escape() {
+            if (at_end())
+                throw error ("Unexpected end of expression after \\");
+            char c = expression [position ++];
+            switch (c) {
+            case 'd': return digits();
+            case 'D': return complement (digits());
+            case 'w': return word();
+            case 'W': return complement (word());
+            case 's': return space();
+            case 'S': return complement (space());
+            case 'n': return single ('\n');
+            case 't': return single ('\t');
+            case 'r': return single ('\r');
+            case 'f': return single ('\f');
+            case 'v': return single ('\v');
+            case '0': return single ('\0');
+            case 'x':
+                {
+                    if (expression.size() - position < 2
+                            || hex_value (expression [position]) == -1
+                            || hex_value (expression [position + 1]) == -1)
+                        throw error ("Expected two hexadecimal digits");
+                    int value = hex_value (expression [position]) * 16
+                        + hex_value (expression [position + 1]);
+                    position += 2;
+                    return single (static_cast <char> (value));
+                }
+            default:
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+                        || (c >= '0' && c <= '9'))
+                {
+                    -- position;
+                    throw error (std::string ("Unsupported escape \\") + c);
+                }
+                return single (c);
+            }
+        }
+
+        /**
+        Read one character or escape inside [...].
+        \return The class it matches.
+        If it matches only one character, set "is_single" to true and
+        "character" to that character.
+        */
+        char_class class_element (bool & is_single, char & character) {
+            if (at_end())
+                throw error ("Character class is not terminated");
+            char c = expression [position ++];
+            char_class result = (c == '\\') ? escape() : single (c);
+            is_single = (result.bits().count() == 1);
+            if (is_single) {
+                for (int code = 0; code != 256; ++ code)
+                    if (result.contains (static_cast <char> (code)))
+                        character = static_cast <char> (code);
+            }
+            return result;
+        }
+
+        /**
+        Read a character class, after the [.
+        */
+        char_class character_class() {
+            bool negate = false;
+            if (!at_end() && peek() == '^') {
+                negate = true;
+                ++ position;
+            }
+            char_class result;
+            bool first = true;
+            while (true) {
+                if (at_end())
+                    throw error ("Character class is not terminated");
+                if (peek() == ']' && !first) {
+                    ++ position;
+                    break;
+                }
+                first = false;
+                bool is_single;
+                char low;
+                char_class element = class_element (is_single, low);
+                if (is_single && !at_end() && peek() == '-'
+                        && position + 1 < expression.size()
+                        && expression [position + 1] != ']')
+                {
+                    ++ position;
+                    bool is_single_high;
+                    char high;
+                    class_element (is_single_high, high);
+                    if (!is_single_high)
+                        throw error ("Invalid character range");
+                    if (static_cast <unsigned char> (high)
+                            < static_cast <unsigned char> (low))
+                        throw error ("Character range is reversed");
+                    for (int code = static_cast <unsigned char> (low);
+                            code <= static_cast <unsigned char> (high);
+                            ++ code)
+                        result.add (static_cast <char> (code));
+                } else
+                    result |= element;
+            }
+            return negate ? complement (result) : result;
+        }
+
+        /**
+        Read a number in a {n,m} quantifier.
+        \return The number, or -1 if there are no digits.
+        */
+        int number() {
+            int result = -1;
+            while (!at_end() && peek() >= '0' && peek() <= '9') {
+                result = (result == -1 ? 0 : result * 10) + (peek() - '0');
+                if (result > 1000)
+                    throw error ("Repetition count is too large");
+                ++ position;
+            }
+            return result;
+        }
+
+        pattern atom() {
+            if (at_end())
+                throw error ("Expected an expression");
+            char c = expression [position ++];
+            switch (c) {
+            case '(':
+                {
+                    if (expression.compare (position, 2, "?:") == 0)
+                        position += 2;
+                    else if (!at_end() && peek() == '?')
+                        throw error ("Unsupported group");
+                    pattern result = alternative();
+                    if (at_end() || peek() != ')')
+                        throw error ("Expected )");
+                    ++ position;
+                    return result;
+                }
+            case '[':
+                return pattern (character_class());
+            case '.':
+                return pattern (complement (single ('\n')));
+            case '\\':
+                return pattern (escape());
+            case '^':
+            case '$':
+                -- position;
+                throw error ("Anchors are not supported");
+            case ')':
+            case ']':
+            case '{':
+            case '}':
+            case '*':
+            case '+':
+            case '?':
+            case '|':
+                -- position;
+                throw error (std::string ("Unexpected character: ") + c);
+            default:
+                return pattern (single (c));
+            }
+        }
+
+        pattern quantified() {
+            pattern result = atom();
+            while (!at_end()) {
+                char c = peek();
+                int minimum, maximum;
+                if (c == '*') {
+                    minimum = 0;
+                    maximum = pattern::unbounded;
+                } else if (c == '+') {
+                    minimum = 1;
+                    maximum = pattern::unbounded;
+                } else if (c == '?') {
+                    minimum = 0;
+                    maximum = 1;
+                } else if (c == '{') {
+                    ++ position;
+                    minimum = number();
+                    if (minimum == -1)
+                        throw error ("Expected a number");
+                    maximum = minimum;
+                    if (!at_end() && peek() == ',') {
+                        ++ position;
+                        maximum = number();
+                        if (maximum == -1)
+                            maximum = pattern::unbounded;
+                        else if (maximum < minimum)
+                            throw error ("Repetition range is reversed");
+                    }
+                    if (at_end() || peek() != '}')
+                        throw error ("Expected }");
+                } else
+                    break;
+                ++ position;
+                if (!at_end() && peek() == '?')
+                    throw error ("Lazy quantifiers are not supported");
+                result = pattern::repeat (result, minimum, maximum);
+                if (expanded_size (result) > max_expanded_size)
+                    throw error ("Repetitions are nested too deeply");
+            }
+            return result;
+        }
+
+        pattern sequence() {
+            std::vector <pattern> elements;
+            while (!at_end() && peek() != '|' && peek() != ')')
+                elements.push_back (quantified());
+            if (elements.size() == 1)
+                return elements.front();
+            return pattern::sequence (std::move (elements));
+        }
+
+        pattern alternative() {
+            std::vector <pattern> options (1, sequence());
+            while (!at_end() && peek() == '|') {
+                ++ position;
+                options.push_back (sequence());
+            }
+            if (options.size() == 1)
+                return options.front();
+            return pattern::alternative (std::move (options));
+        }
+
+    public:
+        explicit reader (std::string const & expression)
+        : expression (expression), position (0) {}
+
+        pattern read() {
+            pattern result = alternative();
+            if (!at_end())
+                throw error ("Unmatched )");
+            if (expanded_size (result) > max_expanded_size)
+                throw error ("Expression is too long");
+            return result;
+        }
+    };
+
+} // namespace regex_detail
+
+/**
+Read a regular expression into a pattern.
+
+The syntax is a subset of the usual one:
+\li a character matches itself, except for the special characters
+    \\ . [ ] ( ) { } | * + ? ^ $;
+\li . matches any character except a newline;
+\li [a-z_] matches one character in a class; [^...] one character not in it;
+\li \\d, \\w, \\s, and \\D, \\W, \\S match digits, word characters and
+    whitespace, and the characters that are not;
+\li \\n, \\t, \\r, \\f, \\v, \\0 and \\xHH match one character, and a
+    backslash followed by a punctuation character matches that character;
+\li (...) and (?:...) group;
+\li | separates alternatives;
+\li *, +, ?, {n}, {n,} and {n,m} repeat.
+Anchors, back-references, lazy quantifiers and look-around are not
+supported: the expression must describe a regular language, and a DFA always
+finds the longest match.
+
+\throw lex_error with a lex_offset if the expression cannot be read, or if,
+    with its repetitions written out, it is too long, which can happen with
+    nested repetitions.
+*/
+inline pattern read_regex (std::string const & expression)
+{ return regex_detail::reader (expression).read(); }
+
+} // namespace lex
+
+/**
+Part of the input that a parser has matched.
+It does not copy the input.
+*/
+template <class Input> struct span {
+    // The input from the start of the span.
+    Input input;
+    // The number of elements in the span.
+    std::size_t size;
+
+    span (Input const & input, std::size_t size)
+    : input (input), size (size) {}
+
+    /**
+    \return A copy of the elements in the span.
+    */
+    std::string str() const {
+        std::string result;
+        result.reserve (size);
+        Input current = input;
+        for (std::size_t i = 0; i != size; ++ i) {
+            result.push_back (::range::first (current));
+            current = ::range::drop (current);
+        }
+        return result;
+    }
+};
+
+/**
+Parser that matches a regular expression, and outputs the span of the input
+that it matched.
+The expression, in the syntax of lex::read_regex(), is compiled into a DFA
+when the parser is constructed, and the DFA is shared between copies.
+Parsing then takes one table-driven pass over the input, without
+backtracking, and finds the longest match.
+
+This does not use the skip parser.
+\todo C++11 constexpr is not powerful enough to build the DFA at compile
+time.
+*/
+class regex_parser : public parser_base <regex_parser> {
+    std::shared_ptr <lex::dfa const> dfa_;
+    std::string expression_;
+public:
+    /**
+    \throw lex::lex_error if the expression cannot be read, or if the DFA
+        for it has too many states.
+    */
+    explicit regex_parser (std::string const & expression)
+    : dfa_ (std::make_shared <lex::dfa const> (std::vector <lex::pattern> (
+        1, lex::read_regex (expression)))),
+        expression_ (expression) {}
+
+    lex::dfa const & dfa() const { return *dfa_; }
+    std::string const & expression() const { return expression_; }
+};
+
+struct regex_parser_tag;
+template <> struct decayed_parser_tag <regex_parser>
+{ typedef regex_parser_tag type; };
+
+/**
+\return A parser that matches the regular expression "expression", and
+outputs the span of the input it matched.
+\throw lex::lex_error if the expression cannot be read.
+*/
+inline regex_parser regex (std::string const & expression)
+{ return regex_parser (expression); }
+
+namespace operation {
+
+    template <> struct parse <regex_parser_tag> {
+        template <class Policy, class Input>
+            explicit_outcome <span <Input>, Input> operator() (Policy const &,
+                regex_parser const & parser, Input const & input) const
+        {
+            auto match = parser.dfa().longest_match (input);
+            if (match.first.pattern == -1)
+                return failed();
+            return explicit_outcome <span <Input>, Input> (
+                span <Input> (input, match.first.length), match.second);
+        }
+    };
+
+    template <> struct describe <regex_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "regex"; }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_LEX_REGEX_HPP_INCLUDED
@@ -0,0 +1,86 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/** \file
+Define a parser that matches one token of a given kind.
+*/
+
+#ifndef PARSE_LL_LEX_TOKEN_HPP_INCLUDED
+#define PARSE_LL_LEX_TOKEN_HPP_INCLUDED
+
+#include <type_traits>
+
+#include "range/core.hpp"
+
+#include "../core/core.hpp"
+#include "../core/outcome/failed.hpp"
+#include "../core/outcome/explicit.hpp"
+
+namespace parse_ll {
+
+/**
+Parser that matches one token of a given kind, and outputs the token.
+The input must be a range of tokens with a member "kind", for example
+range::view (tokens) where tokens is produced by lex::lexer.
+The lexer has dropped whitespace already, so grammars over tokens need no
+skip parser.
+*/
+struct token_parser : public parser_base <token_parser> {
+    int kind;
+public:
+    explicit constexpr token_parser (int kind) : kind (kind) {}
+};
+
+struct token_parser_tag;
+template <> struct decayed_parser_tag <token_parser>
+{ typedef token_parser_tag type; };
+
+/**
+\return A parser that matches one token of kind "kind".
+*/
+inline constexpr token_parser token (int kind) { return token_parser (kind); }
+
+namespace operation {
+
+    template <> struct parse <token_parser_tag> {
+        template <class Policy, class Input>
+            explicit_outcome <typename std::decay <
+                decltype (::range::first (std::declval <Input>()))>::type,
+                Input>
+            operator() (Policy const &, token_parser const & parser,
+                Input const & input) const
+        {
+            if (!::range::empty (input)
+                    && ::range::first (input).kind == parser.kind)
+                return explicit_outcome <typename std::decay <
+                    decltype (::range::first (input))>::type, Input> (
+                        ::range::first (input), ::range::drop (input));
+            else
+                return failed();
+        }
+    };
+
+    template <> struct describe <token_parser_tag> {
+        template <class Parser> const char * operator() (Parser const &) const
+        { return "token"; }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_LEX_TOKEN_HPP_INCLUDED
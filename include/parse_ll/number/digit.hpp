@@ -21,6 +21,8 @@ Define a parser that parses one digit.
 #ifndef PARSE_LL_DIGIT_HPP_INCLUDED
 #define PARSE_LL_DIGIT_HPP_INCLUDED
 
+#include <cstdint>
+
 #include "../core/char.hpp"
 #include "../core/transform.hpp"
 
@@ -29,8 +31,7 @@ namespace parse_ll {
 /**
 Digit matcher for char_parser.
 This matches decimal digits.
-It may be interesting to consider how to generalise this (and int_, and float_)
-to other bases.
+match_base_digit generalises this to other bases.
 */
 struct match_digit {
     template <class Char>
@@ -46,7 +47,68 @@ struct convert_digit {
     }
 };
 
-static const auto digit = char_parser <match_digit>() [convert_digit()];
+static constexpr auto digit = char_parser <match_digit>() [convert_digit()];
+
+namespace digit_detail {
+
+    /**
+    Value of ASCII characters as digits: 0-9, then a-z or A-Z for 10 to 35.
+    Characters that are not digits have value 0xff.
+    */
+    template <class Dummy = void> struct value_table {
+        static const unsigned char values [128];
+    };
+
+    template <class Dummy>
+        const unsigned char value_table <Dummy>::values [128] = {
+        255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255,
+        0, 1, 2, 3, 4, 5, 6, 7,
+        8, 9, 255, 255, 255, 255, 255, 255,
+        255, 10, 11, 12, 13, 14, 15, 16,
+        17, 18, 19, 20, 21, 22, 23, 24,
+        25, 26, 27, 28, 29, 30, 31, 32,
+        33, 34, 35, 255, 255, 255, 255, 255,
+        255, 10, 11, 12, 13, 14, 15, 16,
+        17, 18, 19, 20, 21, 22, 23, 24,
+        25, 26, 27, 28, 29, 30, 31, 32,
+        33, 34, 35, 255, 255, 255, 255, 255
+    };
+
+} // namespace digit_detail
+
+/**
+\return The value of c as a digit, or 0xff if c is not a digit in any base up
+to 36.
+*/
+template <class Char> inline unsigned digit_value (Char const & c) {
+    return static_cast <std::uint32_t> (c) < 0x80
+        ? digit_detail::value_table <>::values [static_cast <std::uint32_t> (c)]
+        : 0xff;
+}
+
+/**
+Digit matcher for char_parser that matches digits in base Base.
+Digits beyond 9 are letters, in lower or upper case.
+*/
+template <unsigned Base> struct match_base_digit {
+    static_assert (2 <= Base && Base <= 36, "Base must be from 2 to 36.");
+
+    template <class Char>
+    bool operator() (Char const & c) const { return digit_value (c) < Base; }
+};
+
+struct convert_base_digit {
+    template <class Char>
+    int operator() (Char const & c) const { return int (digit_value (c)); }
+};
+
+static constexpr auto hex_digit
+    = char_parser <match_base_digit <16>>() [convert_base_digit()];
 
 } // namespace parse_ll
 
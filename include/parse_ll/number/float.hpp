@@ -64,8 +64,8 @@ template <typename Result> class convert_mantissa {
 public:
     template <class Digits>
     std::tuple <Result, int> operator() (
-        std::tuple <Digits, boost::optional <
-            std::tuple <Digits> > const &> const & data) const
+        std::tuple <Digits, boost::optional <std::tuple <Digits>>>
+            const & data) const
     {
         Digits before_dot = std::get <0> (data);
         Result current = add_digits (Result(), before_dot);
@@ -105,9 +105,10 @@ PARSE_LL_DEFINE_NAMED_PARSER_TEMPLATE ("float_exponent",
     no_skip [-(literal('e') >> int_as <Result>())] [extract_exponent()]);
 
 template <typename Result>
-    auto float_exponent_as() RETURNS (float_exponent_parser <Result>());
+    constexpr auto float_exponent_as()
+    RETURNS (float_exponent_parser <Result>());
 
-static const auto float_exponent = float_exponent_as <int> ();
+static constexpr auto float_exponent = float_exponent_as <int> ();
 
 template <class Result> struct tuple_and_int {
     typedef std::tuple <Result, int> type;
@@ -124,9 +125,9 @@ PARSE_LL_DEFINE_NAMED_PARSER_TEMPLATE ("float", float_parser, Result,
         [convert_float <Result>()]);
 
 template <class Result>
-    inline auto float_as() RETURNS (float_parser <Result> ());
+    constexpr auto float_as() RETURNS (float_parser <Result> ());
 
-static const auto float_ = float_as <double>();
+static constexpr auto float_ = float_as <double>();
 
 } // namespace parse_ll
 
@@ -52,8 +52,8 @@ PARSE_LL_DEFINE_NAMED_PARSER_TEMPLATE ("int", int_parser, Result,
     (no_skip [sign >> unsigned_as <Result>()] [combine_sign <Result>()]));
 
 template <typename Result>
-    inline auto int_as() RETURNS (int_parser <Result>());
-static const auto int_ = int_as <int>();
+    constexpr auto int_as() RETURNS (int_parser <Result>());
+static constexpr auto int_ = int_as <int>();
 
 } // namespace parse_ll
 
@@ -29,14 +29,12 @@ Define a sign parser, which parses '-' to -1, and '+' or nothing to +1.
 
 #include "../core/named.hpp"
 
-#include "boost/phoenix/core/value.hpp"
-
 namespace parse_ll {
 
-PARSE_LL_DEFINE_NAMED_PARSER (sign, (
-    literal ('+') [boost::phoenix::val (+1)]
-    | literal ('-') [boost::phoenix::val (-1)]
-    | nothing [boost::phoenix::val (+1)]));
+PARSE_LL_DEFINE_CONSTEXPR_NAMED_PARSER (sign, (
+    literal ('+') [constant (+1)]
+    | literal ('-') [constant (-1)]
+    | nothing [constant (+1)]));
 
 } // namespace parse_ll
 
@@ -0,0 +1,322 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define parsers for unsigned integers in bases other than 10: hex_, oct_, bin_,
+and uint_as <Result, Base>().
+*/
+
+#ifndef PARSE_LL_NUMBER_UINT_HPP_INCLUDED
+#define PARSE_LL_NUMBER_UINT_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/mpl/or.hpp>
+
+#include "utility/returns.hpp"
+
+#include "range/core.hpp"
+
+#include "../core/core.hpp"
+#include "../core/outcome/explicit.hpp"
+#include "../core/outcome/failed.hpp"
+#include "./digit.hpp"
+#include "./unsigned.hpp"
+
+namespace parse_ll {
+
+namespace uint_detail {
+
+    /**
+    Evaluate to true iff Iterator points into contiguous memory of char.
+    */
+    template <class Iterator> struct is_contiguous_iterator
+    : boost::mpl::or_ <
+        std::is_same <Iterator, char *>,
+        std::is_same <Iterator, char const *>,
+        std::is_same <Iterator, std::string::iterator>,
+        std::is_same <Iterator, std::string::const_iterator>,
+        boost::mpl::or_ <
+            std::is_same <Iterator, std::vector <char>::iterator>,
+            std::is_same <Iterator, std::vector <char>::const_iterator>>> {};
+
+    template <class Input> struct is_contiguous : std::false_type {};
+
+    template <class Iterator>
+        struct is_contiguous <::range::iterator_range <Iterator>>
+    : is_contiguous_iterator <Iterator> {};
+
+    /**
+    \return The number of digits in base Base that always fit in a 64-bit
+    integer.
+    */
+    constexpr unsigned safe_digits (std::uint64_t base,
+        std::uint64_t limit = std::numeric_limits <std::uint64_t>::max())
+    { return limit < base ? 0 : 1 + safe_digits (base, limit / base); }
+
+    /**
+    \return value as a Result.
+    \throw std::overflow_error iff value does not fit in Result.
+    */
+    template <class Result> inline Result checked (std::uint64_t value) {
+        static_assert (std::numeric_limits <Result>::is_integer,
+            "The result must be an integer type.");
+        if (value > std::uint64_t (std::numeric_limits <Result>::max()))
+            throw std::overflow_error ("Overflow while parsing integer");
+        return Result (value);
+    }
+
+    // Input is a range.
+    template <class Input> inline bool more (Input const & input)
+    { return !::range::empty (input); }
+    template <class Input> inline auto peek (Input const & input)
+    RETURNS (::range::first (input));
+    template <class Input> inline void next (Input & input)
+    { input = ::range::drop (input); }
+
+    // Contiguous memory.
+    struct pointer_input {
+        char const * current;
+        char const * end;
+    };
+
+    inline bool more (pointer_input const & input)
+    { return input.current != input.end; }
+    inline char peek (pointer_input const & input)
+    { return *input.current; }
+    inline void next (pointer_input & input) { ++ input.current; }
+
+    /**
+    Read digits from input, and advance it past them.
+    The first "count" digits have already been read and their value is
+    "value".
+    While the value cannot overflow a 64-bit integer, the digits are added
+    without checking; only then is every digit checked.
+    \throw std::overflow_error iff the result does not fit in Result.
+    */
+    template <class Result, unsigned Base, class Input>
+        inline Result collect_digits (
+            Input & input, std::uint64_t value, unsigned count)
+    {
+        static constexpr unsigned safe = safe_digits (Base);
+        for (; count < safe && more (input); ++ count) {
+            unsigned digit = digit_value (peek (input));
+            if (digit >= Base)
+                return checked <Result> (value);
+            value = value * Base + digit;
+            next (input);
+        }
+        Result result = checked <Result> (value);
+        for (; more (input); next (input)) {
+            unsigned digit = digit_value (peek (input));
+            if (digit >= Base)
+                break;
+            result = collect_integer <Result, Base>() (result, int (digit));
+        }
+        return result;
+    }
+
+    /**
+    \return The 8 bytes at "bytes" as a little-endian integer, so that the
+    first byte is in the lowest bits on any platform.
+    */
+    inline std::uint64_t load_little_endian (char const * bytes) {
+        std::uint64_t result;
+        std::memcpy (&result, bytes, 8);
+#if defined (__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        result = __builtin_bswap64 (result);
+#endif
+        return result;
+    }
+
+    inline unsigned count_trailing_zeros (std::uint64_t value) {
+#if defined (__GNUC__)
+        return unsigned (__builtin_ctzll (value));
+#else
+        unsigned result = 0;
+        for (; !(value & 1); value >>= 1)
+            ++ result;
+        return result;
+#endif
+    }
+
+    /**
+    Convert the hexadecimal digits at the start of 8 characters at once, with
+    operations on all bytes in a 64-bit integer.
+    \param chunk The characters, loaded with load_little_endian.
+    \param value Set to the value of the leading hexadecimal digits.
+    \return The number of leading hexadecimal digits.
+    */
+    inline unsigned convert_hex_chunk (std::uint64_t chunk,
+        std::uint64_t & value)
+    {
+        std::uint64_t const ones = 0x0101010101010101ull;
+        std::uint64_t const high = 0x8080808080808080ull;
+        // Set the high bit of a byte iff low <= byte <= high.
+        // Bytes are 7-bit, so nothing carries into the next byte.
+        std::uint64_t const seven_bit = chunk & ~high;
+        std::uint64_t const decimal = (seven_bit + (0x80 - '0') * ones)
+            & ~(seven_bit + (0x7f - '9') * ones);
+        std::uint64_t const lower_case = seven_bit | 0x20 * ones;
+        std::uint64_t const letter = (lower_case + (0x80 - 'a') * ones)
+            & ~(lower_case + (0x7f - 'f') * ones) & ~chunk & high;
+        std::uint64_t const invalid = ~((decimal & ~chunk) | letter) & high;
+
+        unsigned length = invalid ? count_trailing_zeros (invalid) / 8 : 8;
+        if (length == 0) {
+            value = 0;
+            return 0;
+        }
+        // The value of each byte: '0' to '9' have their value in the low
+        // nibble, and 'a' to 'f' and 'A' to 'F' 9 less than their value.
+        std::uint64_t digits = (chunk & 0x0f * ones) + (letter >> 7) * 9;
+        // Move the digits to the top, dropping the rest, so that the first
+        // digit is the most significant.
+        digits <<= 8 * (8 - length);
+        // Combine pairs of digits, then pairs of pairs, et cetera.
+        digits = ((digits << 4) + (digits >> 8)) & 0x00ff00ff00ff00ffull;
+        digits = ((digits << 8) + (digits >> 16)) & 0x0000ffff0000ffffull;
+        value = ((digits << 16) + (digits >> 32)) & 0xffffffffull;
+        return length;
+    }
+
+    /**
+    Read hexadecimal digits from contiguous memory, 8 at a time while that is
+    possible.
+    */
+    template <class Result> inline Result collect_hex (pointer_input & input)
+    {
+        std::uint64_t value = 0;
+        unsigned count = 0;
+        while (count != 16 && input.end - input.current >= 8) {
+            std::uint64_t chunk_value;
+            unsigned length = convert_hex_chunk (
+                load_little_endian (input.current), chunk_value);
+            value = (value << (4 * length)) | chunk_value;
+            input.current += length;
+            count += length;
+            if (length != 8)
+                return checked <Result> (value);
+        }
+        return collect_digits <Result, 16> (input, value, count);
+    }
+
+    template <class Result, unsigned Base>
+        inline Result collect_contiguous (pointer_input & input,
+            std::integral_constant <unsigned, Base>)
+    { return collect_digits <Result, Base> (input, 0, 0); }
+
+    template <class Result> inline Result collect_contiguous (
+        pointer_input & input, std::integral_constant <unsigned, 16>)
+    { return collect_hex <Result> (input); }
+
+    template <class Result, unsigned Base, class Input>
+        inline explicit_outcome <Result, Input> parse (
+            Input input, std::false_type)
+    {
+        if (!more (input) || digit_value (peek (input)) >= Base)
+            return failed();
+        Result result = collect_digits <Result, Base> (input, 0, 0);
+        return explicit_outcome <Result, Input> (result, input);
+    }
+
+    /**
+    Parse from contiguous memory: convert without going through the range
+    interface.
+    */
+    template <class Result, unsigned Base, class Input>
+        inline explicit_outcome <Result, Input> parse (
+            Input const & input, std::true_type)
+    {
+        auto begin = input.begin();
+        auto end = input.end();
+        if (begin == end || digit_value (*begin) >= Base)
+            return failed();
+        char const * data = &*begin;
+        pointer_input digits = {data, data + (end - begin)};
+        Result result = collect_contiguous <Result> (
+            digits, std::integral_constant <unsigned, Base>());
+        return explicit_outcome <Result, Input> (
+            result, Input (begin + (digits.current - data), end));
+    }
+
+} // namespace uint_detail
+
+/**
+Parser for an unsigned integer in base Base, which outputs a Result.
+Digits beyond 9 are letters, in lower or upper case.
+No prefix like "0x" is parsed.
+
+The parser does not use the skip parser.
+If the input is contiguous memory, the digits are converted directly from
+memory; hexadecimal digits 8 at a time.
+
+\throw std::overflow_error iff the result does not fit in Result.
+*/
+template <class Result, unsigned Base> struct uint_parser
+: parser_base <uint_parser <Result, Base>>
+{
+    static_assert (2 <= Base && Base <= 36, "Base must be from 2 to 36.");
+    constexpr uint_parser() {}
+};
+
+struct uint_parser_tag;
+template <class Result, unsigned Base>
+    struct decayed_parser_tag <uint_parser <Result, Base>>
+{ typedef uint_parser_tag type; };
+
+template <typename Result, unsigned Base>
+    constexpr uint_parser <Result, Base> uint_as()
+{ return uint_parser <Result, Base>(); }
+
+static constexpr auto hex_ = uint_as <unsigned, 16>();
+static constexpr auto oct_ = uint_as <unsigned, 8>();
+static constexpr auto bin_ = uint_as <unsigned, 2>();
+
+namespace operation {
+
+    template <> struct parse <uint_parser_tag> {
+        template <class Policy, class Result, unsigned Base, class Input>
+            explicit_outcome <Result, Input> operator() (Policy const &,
+                uint_parser <Result, Base> const &, Input const & input)
+            const
+        {
+            return uint_detail::parse <Result, Base> (input,
+                std::integral_constant <bool,
+                    uint_detail::is_contiguous <Input>::value>());
+        }
+    };
+
+    template <> struct describe <uint_parser_tag> {
+        template <class Result, unsigned Base> const char * operator() (
+            uint_parser <Result, Base> const &) const
+        {
+            return Base == 16 ? "hex" : Base == 8 ? "octal"
+                : Base == 2 ? "binary" : "unsigned";
+        }
+    };
+
+} // namespace operation
+
+} // namespace parse_ll
+
+#endif  // PARSE_LL_NUMBER_UINT_HPP_INCLUDED
@@ -25,10 +25,9 @@ Define a parser that parses an unsigned integer value.
 
 #include "utility/returns.hpp"
 
-#include "range/core.hpp"
-
 #include "../core/core.hpp"
 #include "../core/repeat.hpp"
+#include "../core/fold.hpp"
 #include "../core/named.hpp"
 #include "../core/no_skip.hpp"
 #include "./digit.hpp"
@@ -36,36 +35,25 @@ Define a parser that parses an unsigned integer value.
 namespace parse_ll {
 
 /**
-Turn a range of values for digits into an unsigned integer.
-\todo Different bases?
-\todo This could be neatly represented with a fold.
+Fold operation that adds a digit in base Base to an unsigned integer.
 
 \throw std::overflow_error iff the result does not fit in the integer type.
 */
-template <class Result> struct collect_integer {
-    template <class DigitValues>
-        Result operator() (DigitValues values) const
-    {
-        // Assume an assignable homogeneous range.
-        Result result = Result();
-        for (; !::range::empty (values);
-            values = ::range::drop (values))
-        {
-            Result new_result = result * 10 + ::range::first (values);
-            if (new_result / 10 != result)
-                throw std::overflow_error ("Overflow while parsing integer");
-            result = new_result;
-        }
-        return result;
+template <class Result, unsigned Base = 10> struct collect_integer {
+    Result operator() (Result result, int digit) const {
+        Result new_result = result * Result (Base) + digit;
+        if (new_result / Result (Base) != result)
+            throw std::overflow_error ("Overflow while parsing integer");
+        return new_result;
     }
 };
 
 PARSE_LL_DEFINE_NAMED_PARSER_TEMPLATE ("unsigned", unsigned_parser, Result,
-    (no_skip [+digit] [collect_integer <Result>()]));
+    (no_skip [fold (Result(), collect_integer <Result>()) [+digit]]));
 
 template <typename Result>
-    inline auto unsigned_as() RETURNS (unsigned_parser <Result>());
-static const auto unsigned_ = unsigned_as <unsigned>();
+    constexpr auto unsigned_as() RETURNS (unsigned_parser <Result>());
+static constexpr auto unsigned_ = unsigned_as <unsigned>();
 
 } // namespace parse_ll
 
@@ -0,0 +1,322 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a range over data that a background thread produces in blocks, for
+example by reading and decompressing a file.
+*/
+
+#ifndef PARSE_LL_SUPPORT_BLOCK_RANGE_HPP_INCLUDED
+#define PARSE_LL_SUPPORT_BLOCK_RANGE_HPP_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <deque>
+#include <functional>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <boost/exception/errinfo_file_name.hpp>
+
+#include "range/core.hpp"
+
+#include "../core/error.hpp"
+
+namespace parse_ll {
+
+/**
+Exception that is thrown when input cannot be read, for example because a
+file cannot be opened or because compressed data is corrupt.
+It contains an error_description and, where it applies, a
+boost::errinfo_file_name.
+*/
+struct input_error : public virtual error {};
+
+} // namespace parse_ll
+
+namespace range {
+
+namespace block_range_detail {
+
+    class producer;
+
+    /**
+    Block of data.
+    Once a block has been handed to the ranges, its reference count and its
+    "next" pointer are only touched by the thread that uses the ranges, so
+    they need no synchronisation.
+    */
+    struct block {
+        std::unique_ptr <char []> data;
+        std::size_t size;
+        // The number of ranges and blocks that refer to this block.
+        std::size_t references;
+        // The block after this one, or null if it is not known yet.
+        block * next;
+        // Keeps the producer alive while blocks are in use.
+        std::shared_ptr <producer> source;
+
+        explicit block (std::size_t capacity)
+        : data (capacity ? new char [capacity] : nullptr), size (0),
+            references (0), next (nullptr) {}
+    };
+
+    inline void acquire (block * b) {
+        if (b)
+            ++ b->references;
+    }
+
+    /**
+    Release a reference to b, and to the blocks after it that are then no
+    longer in use, without recursion.
+    */
+    inline void release (block * b) {
+        while (b && -- b->references == 0) {
+            block * next = b->next;
+            delete b;
+            b = next;
+        }
+    }
+
+    /**
+    Run "read" in a thread, and keep up to block_num blocks ready ahead of
+    the ranges that read them.
+    */
+    class producer {
+    public:
+        /**
+        Function that fills the buffer passed in with up to "size" bytes, and
+        returns the number of bytes it has written, or 0 at the end of the
+        data.
+        It is called from the producer thread only.
+        It may throw an exception, which is then rethrown to the range that
+        tries to read beyond the data that was produced before it.
+        */
+        typedef std::function <std::size_t (char *, std::size_t)> read_type;
+
+    private:
+        read_type read_;
+        std::size_t const block_size_;
+        std::size_t const block_num_;
+
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        std::deque <std::unique_ptr <block>> ready_;
+        bool finished_;
+        bool stopping_;
+        std::exception_ptr error_;
+
+        std::thread thread_;
+
+        void run() {
+            try {
+                while (true) {
+                    std::unique_ptr <block> new_block (new block (block_size_));
+                    new_block->size = read_ (
+                        new_block->data.get(), block_size_);
+                    if (new_block->size == 0)
+                        break;
+
+                    std::unique_lock <std::mutex> lock (mutex_);
+                    changed_.wait (lock, [this] {
+                        return ready_.size() < block_num_ || stopping_; });
+                    if (stopping_)
+                        break;
+                    ready_.push_back (std::move (new_block));
+                    changed_.notify_all();
+                }
+            } catch (...) {
+                std::lock_guard <std::mutex> lock (mutex_);
+                error_ = std::current_exception();
+            }
+            std::lock_guard <std::mutex> lock (mutex_);
+            finished_ = true;
+            changed_.notify_all();
+        }
+
+    public:
+        producer (read_type read, std::size_t block_size,
+            std::size_t block_num)
+        : read_ (std::move (read)),
+            block_size_ (block_size), block_num_ (block_num),
+            finished_ (false), stopping_ (false)
+        {
+            // Start the thread only once everything it uses is initialised.
+            thread_ = std::thread ([this] { run(); });
+        }
+
+        producer (producer const &) = delete;
+        producer & operator = (producer const &) = delete;
+
+        ~producer() {
+            {
+                std::lock_guard <std::mutex> lock (mutex_);
+                stopping_ = true;
+                changed_.notify_all();
+            }
+            thread_.join();
+        }
+
+        /**
+        Link the next ready block to "current", which must be the last block
+        that was handed out, waiting for it to be produced if necessary.
+        Leave current.next null if there are no more blocks.
+        \throw The exception that "read" threw, if it threw one.
+        */
+        void link_next (block & current) {
+            std::unique_lock <std::mutex> lock (mutex_);
+            changed_.wait (lock, [this] {
+                return !ready_.empty() || finished_; });
+            if (ready_.empty()) {
+                if (error_)
+                    std::rethrow_exception (error_);
+                return;
+            }
+            current.next = ready_.front().release();
+            ready_.pop_front();
+            changed_.notify_all();
+            lock.unlock();
+
+            current.next->references = 1;
+            current.next->source = current.source;
+        }
+    };
+
+} // namespace block_range_detail
+
+class block_range;
+
+struct block_range_tag {};
+
+template <> struct tag_of_qualified <block_range>
+{ typedef block_range_tag type; };
+
+/**
+Range of characters that a background thread produces in blocks, so that
+producing the data, for example reading and decompressing a file, and
+parsing it run at the same time on different cores.
+
+The producer runs up to block_num blocks ahead of the range.
+Copies of the range can be kept and used to backtrack: blocks are kept alive
+as long as a range refers to them or to an earlier block, and are freed after
+that.
+The thread is stopped when no range refers to the data any more.
+
+Copying a range touches a reference count without synchronisation, so that
+it is as cheap as possible.
+A range and its copies must therefore be used by one thread at a time.
+
+If the function that produces the data throws an exception, it is rethrown
+by drop() when it reaches the end of the data that was produced before.
+*/
+class block_range {
+    typedef block_range_detail::block block;
+    typedef block_range_detail::producer producer;
+
+    // Null at the end of the data.
+    block * block_;
+    char const * position_;
+
+    block_range (block * b, char const * position)
+    : block_ (b), position_ (position)
+    { block_range_detail::acquire (block_); }
+
+    /**
+    \return The range at the start of the block after b.
+    */
+    static block_range next (block & b) {
+        if (!b.next)
+            b.source->link_next (b);
+        return block_range (b.next, b.next ? b.next->data.get() : nullptr);
+    }
+
+public:
+    typedef producer::read_type read_type;
+
+    /**
+    Start a thread that calls "read" to produce the data.
+    \param read
+        Function that fills the buffer passed in with up to "size" bytes, and
+        returns the number of bytes it has written, or 0 at the end of the
+        data.
+        It is called from the producer thread only.
+    \param block_size The size of the buffer passed to "read".
+    \param block_num The number of blocks that may be ready ahead.
+    */
+    explicit block_range (read_type read,
+        std::size_t block_size = std::size_t (1) << 18,
+        std::size_t block_num = 4)
+    : block_ (nullptr), position_ (nullptr)
+    {
+        block start (0);
+        start.references = 1;
+        start.source = std::make_shared <producer> (
+            std::move (read), block_size, block_num);
+        *this = next (start);
+        // Drop the reference that "start" holds.
+        block_range_detail::release (start.next);
+    }
+
+    block_range (block_range const & other)
+    : block_ (other.block_), position_ (other.position_)
+    { block_range_detail::acquire (block_); }
+
+    block_range (block_range && other)
+    : block_ (other.block_), position_ (other.position_)
+    { other.block_ = nullptr; }
+
+    ~block_range() { block_range_detail::release (block_); }
+
+    block_range & operator = (block_range const & other) {
+        block_range_detail::acquire (other.block_);
+        block_range_detail::release (block_);
+        block_ = other.block_;
+        position_ = other.position_;
+        return *this;
+    }
+
+    block_range & operator = (block_range && other) {
+        std::swap (block_, other.block_);
+        std::swap (position_, other.position_);
+        return *this;
+    }
+
+    bool operator == (block_range const & other) const
+    { return position_ == other.position_; }
+    bool operator != (block_range const & other) const
+    { return !(*this == other); }
+
+private:
+    friend class range::helper::member_access;
+
+    bool empty (direction::front) const { return !block_; }
+
+    char first (direction::front) const { return *position_; }
+
+    block_range drop_one (direction::front) const {
+        if (position_ + 1 != block_->data.get() + block_->size)
+            return block_range (block_, position_ + 1);
+        else
+            return next (*block_);
+    }
+};
+
+} // namespace range
+
+#endif  // PARSE_LL_SUPPORT_BLOCK_RANGE_HPP_INCLUDED
@@ -0,0 +1,99 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a range that decompresses a gzip file while it is being parsed.
+This requires zlib.
+*/
+
+#ifndef PARSE_LL_SUPPORT_GZIP_RANGE_HPP_INCLUDED
+#define PARSE_LL_SUPPORT_GZIP_RANGE_HPP_INCLUDED
+
+#include <climits>
+#include <memory>
+#include <string>
+#include <algorithm>
+
+#include <zlib.h>
+
+#include "block_range.hpp"
+
+namespace range {
+
+namespace gzip_range_detail {
+
+    struct close_file {
+        void operator() (gzFile file) const { gzclose (file); }
+    };
+
+    /**
+    Read function for block_range that reads from a gzip file.
+    */
+    class reader {
+        std::shared_ptr <gzFile_s> file_;
+        std::string file_name_;
+
+    public:
+        reader (std::string const & file_name, std::size_t buffer_size)
+        : file_name_ (file_name)
+        {
+            gzFile file = gzopen (file_name.c_str(), "rb");
+            if (!file)
+                throw ::parse_ll::input_error()
+                    << ::parse_ll::error_description ("Could not open file")
+                    << boost::errinfo_file_name (file_name);
+            file_ = std::shared_ptr <gzFile_s> (file, close_file());
+            gzbuffer (file, unsigned (std::min <std::size_t> (
+                buffer_size, UINT_MAX)));
+        }
+
+        std::size_t operator() (char * buffer, std::size_t size) const {
+            int result = gzread (file_.get(), buffer,
+                unsigned (std::min <std::size_t> (size, INT_MAX)));
+            // Truncated data is only reported through gzerror().
+            int code;
+            char const * message = gzerror (file_.get(), &code);
+            if (result < 0 || (code != Z_OK && code != Z_STREAM_END))
+                throw ::parse_ll::input_error()
+                    << ::parse_ll::error_description (message)
+                    << boost::errinfo_file_name (file_name_);
+            return std::size_t (result);
+        }
+    };
+
+} // namespace gzip_range_detail
+
+/**
+\return A range over the decompressed contents of the gzip file file_name.
+A separate thread reads and decompresses the file in blocks of block_size
+bytes, and runs up to block_num blocks ahead of the parser.
+A file that is not compressed is read as it is.
+
+\throw parse_ll::input_error if the file cannot be opened.
+Reading the range throws parse_ll::input_error where the compressed data
+turns out to be corrupt or truncated.
+*/
+inline block_range gzip_file_range (std::string const & file_name,
+    std::size_t block_size = std::size_t (1) << 18,
+    std::size_t block_num = 4)
+{
+    return block_range (gzip_range_detail::reader (file_name, block_size),
+        block_size, block_num);
+}
+
+} // namespace range
+
+#endif  // PARSE_LL_SUPPORT_GZIP_RANGE_HPP_INCLUDED
@@ -0,0 +1,246 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a range that decodes UTF-8 text into code points.
+*/
+
+#ifndef PARSE_LL_SUPPORT_UTF8_RANGE_HPP_INCLUDED
+#define PARSE_LL_SUPPORT_UTF8_RANGE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "range/core.hpp"
+
+#include "../core/error.hpp"
+
+namespace parse_ll {
+
+/**
+Exception that is thrown when text is not valid UTF-8.
+It contains a utf8_offset, the offset in bytes of the first invalid
+sequence.
+*/
+struct utf8_error : public virtual error {};
+
+typedef boost::error_info <struct utf8_offset_tag, std::size_t> utf8_offset;
+
+namespace utf8_detail {
+
+    /**
+    \return true iff the 16 bytes at "bytes" are all ASCII.
+    */
+    inline bool block_is_ascii (unsigned char const * bytes) {
+#if defined (__SSE2__)
+        __m128i block = _mm_loadu_si128 (
+            reinterpret_cast <__m128i const *> (bytes));
+        return _mm_movemask_epi8 (block) == 0;
+#else
+        std::uint64_t words [2];
+        std::memcpy (words, bytes, 16);
+        return ((words [0] | words [1]) & 0x8080808080808080ull) == 0;
+#endif
+    }
+
+    /**
+    \return The length of the sequence that starts with lead, or 0 if lead
+    cannot start a sequence.
+    */
+    inline std::size_t sequence_length (unsigned char lead) {
+        if (lead < 0x80)
+            return 1;
+        if (lead < 0xc2)
+            // Continuation byte, or overlong two-byte sequence.
+            return 0;
+        if (lead < 0xe0)
+            return 2;
+        if (lead < 0xf0)
+            return 3;
+        if (lead < 0xf5)
+            return 4;
+        return 0;
+    }
+
+    /**
+    \return The offset of the first invalid sequence in [begin, end), or
+    std::size_t (-1) if the text is valid UTF-8.
+    Set "ascii" to whether all text is ASCII.
+    Blocks of 16 ASCII bytes are skipped with one vector comparison.
+    */
+    inline std::size_t find_invalid (char const * begin, char const * end,
+        bool & ascii)
+    {
+        unsigned char const * const first
+            = reinterpret_cast <unsigned char const *> (begin);
+        unsigned char const * const last
+            = reinterpret_cast <unsigned char const *> (end);
+        unsigned char const * current = first;
+        ascii = true;
+        while (current != last) {
+            if (last - current >= 16 && block_is_ascii (current)) {
+                current += 16;
+                continue;
+            }
+            unsigned char lead = *current;
+            if (lead < 0x80) {
+                ++ current;
+                continue;
+            }
+            ascii = false;
+            std::size_t length = sequence_length (lead);
+            if (length == 0 || std::size_t (last - current) < length)
+                return std::size_t (current - first);
+            // Limits on the second byte exclude overlong sequences,
+            // surrogates, and code points beyond U+10FFFF.
+            unsigned char low = 0x80, high = 0xbf;
+            if (lead == 0xe0)
+                low = 0xa0;
+            else if (lead == 0xed)
+                high = 0x9f;
+            else if (lead == 0xf0)
+                low = 0x90;
+            else if (lead == 0xf4)
+                high = 0x8f;
+            if (current [1] < low || current [1] > high)
+                return std::size_t (current - first);
+            for (std::size_t i = 2; i != length; ++ i)
+                if ((current [i] & 0xc0) != 0x80)
+                    return std::size_t (current - first);
+            current += length;
+        }
+        return std::size_t (-1);
+    }
+
+} // namespace utf8_detail
+
+} // namespace parse_ll
+
+namespace range {
+
+class utf8_range;
+
+struct utf8_range_tag {};
+
+template <> struct tag_of_qualified <utf8_range>
+{ typedef utf8_range_tag type; };
+
+/**
+Range of code points (as char32_t) in contiguous UTF-8 text.
+The whole text is validated when the range is constructed, so that stepping
+through it does not need to check anything.
+Text that is all ASCII, which is also detected then, is stepped through one
+byte at a time without looking at the bytes.
+
+The text is not copied, so it must outlive the range.
+offset() and position() give the place in the text, so that the text that a
+parser has consumed can be used without copying.
+*/
+class utf8_range {
+    char const * start_;
+    char const * begin_;
+    char const * end_;
+    bool ascii_;
+
+    utf8_range (char const * start, char const * begin, char const * end,
+        bool ascii)
+    : start_ (start), begin_ (begin), end_ (end), ascii_ (ascii) {}
+
+    void validate() {
+        std::size_t invalid = ::parse_ll::utf8_detail::find_invalid (
+            begin_, end_, ascii_);
+        if (invalid != std::size_t (-1))
+            throw ::parse_ll::utf8_error()
+                << ::parse_ll::error_description ("Invalid UTF-8")
+                << ::parse_ll::utf8_offset (invalid);
+    }
+
+public:
+    /**
+    \throw parse_ll::utf8_error if [begin, end) is not valid UTF-8.
+    */
+    utf8_range (char const * begin, char const * end)
+    : start_ (begin), begin_ (begin), end_ (end), ascii_ (true)
+    { validate(); }
+
+    /**
+    \throw parse_ll::utf8_error if text is not valid UTF-8.
+    */
+    explicit utf8_range (std::string const & text)
+    : start_ (text.data()), begin_ (text.data()),
+        end_ (text.data() + text.size()), ascii_ (true)
+    { validate(); }
+
+    // The range would refer to the temporary string.
+    utf8_range (std::string &&) = delete;
+
+    bool operator == (utf8_range const & other) const
+    { return begin_ == other.begin_ && end_ == other.end_; }
+    bool operator != (utf8_range const & other) const
+    { return !(*this == other); }
+
+    /**
+    \return The offset in bytes from the start of the text.
+    */
+    std::size_t offset() const { return std::size_t (begin_ - start_); }
+
+    /**
+    \return A pointer to the UTF-8 text at the current position.
+    */
+    char const * position() const { return begin_; }
+
+    /**
+    \return true iff the whole text is ASCII.
+    */
+    bool ascii() const { return ascii_; }
+
+private:
+    friend class range::helper::member_access;
+
+    bool empty (direction::front) const { return begin_ == end_; }
+
+    char32_t first (direction::front) const {
+        unsigned char const * bytes
+            = reinterpret_cast <unsigned char const *> (begin_);
+        unsigned char lead = bytes [0];
+        if (lead < 0x80)
+            return lead;
+        if (lead < 0xe0)
+            return char32_t (lead & 0x1f) << 6 | (bytes [1] & 0x3f);
+        if (lead < 0xf0)
+            return char32_t (lead & 0x0f) << 12
+                | char32_t (bytes [1] & 0x3f) << 6 | (bytes [2] & 0x3f);
+        return char32_t (lead & 0x07) << 18
+            | char32_t (bytes [1] & 0x3f) << 12
+            | char32_t (bytes [2] & 0x3f) << 6 | (bytes [3] & 0x3f);
+    }
+
+    utf8_range drop_one (direction::front) const {
+        std::size_t length = ascii_ ? 1 : ::parse_ll::utf8_detail::
+            sequence_length (static_cast <unsigned char> (*begin_));
+        return utf8_range (start_, begin_ + length, end_, ascii_);
+    }
+};
+
+} // namespace range
+
+#endif  // PARSE_LL_SUPPORT_UTF8_RANGE_HPP_INCLUDED
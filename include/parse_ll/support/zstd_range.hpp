@@ -0,0 +1,143 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define a range that decompresses a zstd file while it is being parsed.
+This requires libzstd.
+*/
+
+#ifndef PARSE_LL_SUPPORT_ZSTD_RANGE_HPP_INCLUDED
+#define PARSE_LL_SUPPORT_ZSTD_RANGE_HPP_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <zstd.h>
+
+#include "block_range.hpp"
+
+namespace range {
+
+namespace zstd_range_detail {
+
+    /**
+    Read function for block_range that reads from a zstd file.
+    Copies share the state, since block_range only calls it from one
+    thread.
+    */
+    class reader {
+        struct state {
+            std::string file_name;
+            std::ifstream file;
+            ZSTD_DStream * stream;
+            std::vector <char> input_buffer;
+            ZSTD_inBuffer input;
+            bool end_of_file;
+            // Zero iff the last frame that was read is complete.
+            std::size_t last_result;
+
+            explicit state (std::string const & file_name)
+            : file_name (file_name),
+                file (file_name.c_str(), std::ios::binary),
+                stream (nullptr),
+                input_buffer (ZSTD_DStreamInSize()), end_of_file (false),
+                last_result (1)
+            {
+                input.src = input_buffer.data();
+                input.size = 0;
+                input.pos = 0;
+                if (!file)
+                    throw error ("Could not open file");
+                // The destructor does not run if this throws, so create
+                // the stream only once nothing else can go wrong.
+                stream = ZSTD_createDStream();
+                if (!stream)
+                    throw error ("Could not allocate memory");
+                ZSTD_initDStream (stream);
+            }
+
+            ~state() { ZSTD_freeDStream (stream); }
+
+            ::parse_ll::input_error error (char const * description) const {
+                ::parse_ll::input_error e;
+                e << ::parse_ll::error_description (description)
+                    << boost::errinfo_file_name (file_name);
+                return e;
+            }
+        };
+
+        std::shared_ptr <state> state_;
+
+    public:
+        explicit reader (std::string const & file_name)
+        : state_ (std::make_shared <state> (file_name)) {}
+
+        std::size_t operator() (char * buffer, std::size_t size) const {
+            state & s = *state_;
+            ZSTD_outBuffer output = {buffer, size, 0};
+            while (output.pos != output.size) {
+                if (s.input.pos == s.input.size && !s.end_of_file) {
+                    s.file.read (s.input_buffer.data(),
+                        std::streamsize (s.input_buffer.size()));
+                    s.input.size = std::size_t (s.file.gcount());
+                    s.input.pos = 0;
+                    if (s.input.size == 0) {
+                        if (s.file.bad())
+                            throw s.error ("Could not read file");
+                        s.end_of_file = true;
+                    }
+                }
+                std::size_t previous_position = output.pos;
+                std::size_t result = ZSTD_decompressStream (
+                    s.stream, &output, &s.input);
+                if (ZSTD_isError (result))
+                    throw s.error (ZSTD_getErrorName (result));
+                if (s.end_of_file && output.pos == previous_position) {
+                    // All input has been used, and no more output comes.
+                    if (s.last_result != 0)
+                        throw s.error ("Truncated zstd data");
+                    break;
+                }
+                s.last_result = result;
+            }
+            return output.pos;
+        }
+    };
+
+} // namespace zstd_range_detail
+
+/**
+\return A range over the decompressed contents of the zstd file file_name.
+A separate thread reads and decompresses the file in blocks of block_size
+bytes, and runs up to block_num blocks ahead of the parser.
+
+\throw parse_ll::input_error if the file cannot be opened.
+Reading the range throws parse_ll::input_error where the compressed data
+turns out to be corrupt or truncated.
+*/
+inline block_range zstd_file_range (std::string const & file_name,
+    std::size_t block_size = std::size_t (1) << 18,
+    std::size_t block_num = 4)
+{
+    return block_range (zstd_range_detail::reader (file_name),
+        block_size, block_num);
+}
+
+} // namespace range
+
+#endif  // PARSE_LL_SUPPORT_ZSTD_RANGE_HPP_INCLUDED
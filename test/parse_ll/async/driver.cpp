@@ -0,0 +1,192 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test the coroutine-based parse driver with many pipes at once.
+*/
+
+#define BOOST_TEST_MODULE async_driver
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/async/driver.hpp"
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <thread>
+#include <stdexcept>
+
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/unsigned.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_async_driver)
+
+using parse_ll::async::event_loop;
+using parse_ll::async::parse_task;
+using parse_ll::async::stream_end;
+
+struct pipe_ends {
+    int read, write;
+    pipe_ends() {
+        int ends [2];
+        BOOST_REQUIRE (pipe (ends) == 0);
+        read = ends [0];
+        write = ends [1];
+    }
+};
+
+/**
+\return The number of pipes that can be open at once, up to "wanted".
+*/
+std::size_t pipe_num (std::size_t wanted) {
+    rlimit limit;
+    getrlimit (RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit (RLIMIT_NOFILE, &limit);
+    getrlimit (RLIMIT_NOFILE, &limit);
+    return std::min <std::size_t> (wanted, (limit.rlim_cur - 64) / 2);
+}
+
+/**
+Write texts to the pipes, a few bytes at a time and interleaved, so that
+messages arrive in pieces, and then close the pipes.
+*/
+void write_all (std::vector <pipe_ends> const & pipes,
+    std::vector <std::string> const & texts, std::size_t piece_size)
+{
+    bool more = true;
+    for (std::size_t position = 0; more; position += piece_size) {
+        more = false;
+        for (std::size_t i = 0; i != pipes.size(); ++ i) {
+            if (position < texts [i].size()) {
+                std::size_t size = std::min (
+                    piece_size, texts [i].size() - position);
+                BOOST_REQUIRE_EQUAL (write (pipes [i].write,
+                    texts [i].data() + position, size), ssize_t (size));
+                more = true;
+            }
+        }
+    }
+    for (auto const & ends : pipes)
+        close (ends.write);
+}
+
+BOOST_AUTO_TEST_CASE (test_driver_many_streams) {
+    std::size_t const stream_num = pipe_num (2000);
+    BOOST_TEST_MESSAGE ("Parsing " << stream_num << " streams.");
+
+    auto message = parse_ll::unsigned_ >> parse_ll::literal (';');
+
+    std::vector <pipe_ends> pipes (stream_num);
+    std::vector <std::string> texts (stream_num);
+    std::vector <unsigned> expected (stream_num, 0);
+    for (std::size_t i = 0; i != stream_num; ++ i) {
+        for (unsigned j = 0; j != 50; ++ j) {
+            unsigned value = unsigned (i * 7919 + j * 104729) % 100000;
+            texts [i] += std::to_string (value) + ';';
+            expected [i] += value;
+        }
+    }
+
+    event_loop loop;
+    std::vector <unsigned> sums (stream_num, 0);
+    std::vector <parse_task> tasks;
+    for (std::size_t i = 0; i != stream_num; ++ i)
+        tasks.push_back (parse_ll::async::parse_stream (
+            loop, pipes [i].read, message,
+            [&sums, i] (std::tuple <unsigned> value)
+            { sums [i] += std::get <0> (value); }));
+    BOOST_CHECK_EQUAL (loop.waiting(), stream_num);
+
+    std::thread writer (write_all, std::cref (pipes), std::cref (texts), 3);
+    loop.run();
+    writer.join();
+
+    for (std::size_t i = 0; i != stream_num; ++ i) {
+        BOOST_REQUIRE (tasks [i].done());
+        BOOST_CHECK (tasks [i].result() == stream_end::closed);
+        BOOST_CHECK_EQUAL (sums [i], expected [i]);
+        close (pipes [i].read);
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_driver_end) {
+    auto message = parse_ll::unsigned_ >> parse_ll::literal (';');
+
+    std::vector <std::string> texts = {
+        "", "1;2;", "1;x;", "1;2", "99999999999999;"};
+    std::vector <pipe_ends> pipes (texts.size());
+
+    event_loop loop;
+    int message_num = 0;
+    std::vector <parse_task> tasks;
+    for (auto const & ends : pipes)
+        tasks.push_back (parse_ll::async::parse_stream (
+            loop, ends.read, message,
+            [&message_num] (std::tuple <unsigned>) { ++ message_num; }));
+
+    write_all (pipes, texts, 1);
+    loop.run();
+
+    for (auto const & task : tasks)
+        BOOST_REQUIRE (task.done());
+    BOOST_CHECK (tasks [0].result() == stream_end::closed);
+    BOOST_CHECK (tasks [1].result() == stream_end::closed);
+    BOOST_CHECK (tasks [2].result() == stream_end::parse_failed);
+    // Closed in the middle of a message.
+    BOOST_CHECK (tasks [3].result() == stream_end::parse_failed);
+    BOOST_CHECK_THROW (tasks [4].result(), std::overflow_error);
+    BOOST_CHECK_EQUAL (message_num, 4);
+
+    for (auto const & ends : pipes)
+        close (ends.read);
+}
+
+// A message that never ends is given up on.
+BOOST_AUTO_TEST_CASE (test_driver_message_size) {
+    auto message = *parse_ll::literal ('a') >> parse_ll::literal (';');
+
+    std::vector <std::string> texts = {
+        "aaaa;aaaaaaa;", "aaaa;" + std::string (100, 'a'), "aaaaaaaaaa;"};
+    std::vector <pipe_ends> pipes (texts.size());
+
+    event_loop loop;
+    int message_num = 0;
+    std::vector <parse_task> tasks;
+    for (auto const & ends : pipes)
+        tasks.push_back (parse_ll::async::parse_stream (
+            loop, ends.read, message, [&message_num] { ++ message_num; },
+            3, 8));
+
+    write_all (pipes, texts, 2);
+    loop.run();
+
+    for (auto const & task : tasks)
+        BOOST_REQUIRE (task.done());
+    BOOST_CHECK (tasks [0].result() == stream_end::closed);
+    BOOST_CHECK (tasks [1].result() == stream_end::parse_failed);
+    // Nine bytes have arrived, and the message is not complete.
+    BOOST_CHECK (tasks [2].result() == stream_end::parse_failed);
+    BOOST_CHECK_EQUAL (message_num, 3);
+
+    for (auto const & ends : pipes)
+        close (ends.read);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
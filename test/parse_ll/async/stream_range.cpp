@@ -0,0 +1,98 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test stream_range.
+*/
+
+#define BOOST_TEST_MODULE stream_range
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/async/stream_range.hpp"
+
+#include <string>
+#include <tuple>
+
+#include "range/core.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/unsigned.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_stream_range)
+
+using range::empty;
+using range::first;
+using range::drop;
+
+BOOST_AUTO_TEST_CASE (test_stream_range) {
+    range::stream_buffer buffer;
+    BOOST_CHECK_THROW (empty (buffer.range()), parse_ll::need_more_input);
+
+    buffer.append ("ab", 2);
+    range::stream_range r = buffer.range();
+    BOOST_CHECK (!empty (r));
+    BOOST_CHECK_EQUAL (first (r), 'a');
+    r = drop (r);
+    BOOST_CHECK_EQUAL (first (r), 'b');
+    r = drop (r);
+    BOOST_CHECK_EQUAL (r.offset(), 2u);
+    BOOST_CHECK_THROW (empty (r), parse_ll::need_more_input);
+
+    // Ranges stay valid when input is appended.
+    buffer.append ("c", 1);
+    BOOST_CHECK (!empty (r));
+    BOOST_CHECK_EQUAL (first (r), 'c');
+    BOOST_CHECK_EQUAL (first (buffer.range()), 'a');
+
+    buffer.discard (r);
+    BOOST_CHECK (buffer.range() == r);
+    BOOST_CHECK_EQUAL (buffer.size(), 1u);
+    r = drop (r);
+
+    buffer.close();
+    BOOST_CHECK (empty (r));
+}
+
+BOOST_AUTO_TEST_CASE (test_stream_range_parse) {
+    auto message = parse_ll::unsigned_ >> parse_ll::literal (';');
+
+    range::stream_buffer buffer;
+    buffer.append ("12", 2);
+    // Whether the number is complete is not known yet.
+    BOOST_CHECK_THROW (parse_ll::success (
+        parse_ll::parse (message, buffer.range())),
+        parse_ll::need_more_input);
+
+    buffer.append ("3;45;", 5);
+    auto result = parse_ll::parse (message, buffer.range());
+    BOOST_CHECK (parse_ll::success (result));
+    BOOST_CHECK_EQUAL (std::get <0> (parse_ll::output (result)), 123u);
+    buffer.discard (parse_ll::rest (result));
+
+    auto result2 = parse_ll::parse (message, buffer.range());
+    BOOST_CHECK (parse_ll::success (result2));
+    BOOST_CHECK_EQUAL (std::get <0> (parse_ll::output (result2)), 45u);
+    buffer.discard (parse_ll::rest (result2));
+    BOOST_CHECK_EQUAL (buffer.size(), 0u);
+
+    buffer.append ("6", 1);
+    buffer.close();
+    // The message cannot be completed any more.
+    BOOST_CHECK (!parse_ll::success (
+        parse_ll::parse (message, buffer.range())));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
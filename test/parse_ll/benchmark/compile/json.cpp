@@ -0,0 +1,104 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Define the JSON-like grammar declared in json.hpp, and instantiate it.
+This is the one source file that contains the code for the grammar.
+*/
+
+#include "json.hpp"
+
+#include <tuple>
+#include <vector>
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/float.hpp"
+
+namespace json {
+
+    namespace json_detail {
+
+        using parse_ll::literal;
+        using parse_ll::char_;
+        using parse_ll::one_of;
+        using parse_ll::no_skip;
+
+        struct one {
+            template <class ... Arguments>
+                int operator() (Arguments const & ...) const
+            { return 1; }
+        };
+
+        struct first {
+            int operator() (std::tuple <int> const & t) const
+            { return std::get <0> (t); }
+        };
+
+        // Add up the outputs of an optional list.
+        struct sum {
+            template <class Elements>
+                int operator() (std::tuple <Elements> const & t) const
+            {
+                int result = 0;
+                if (std::get <0> (t)) {
+                    std::vector <int> elements = *std::get <0> (t);
+                    for (int element : elements)
+                        result += element;
+                }
+                return result;
+            }
+        };
+
+        struct is_plain {
+            bool operator() (char c) const
+            { return c != '"' && c != '\\' && c >= ' '; }
+        };
+
+        auto const string = no_skip [literal ('"')
+            >> *(parse_ll::one_of_parser (
+                    parse_ll::char_class::matching (is_plain()))
+                | (literal ('\\') >> one_of ("\"\\/bfnrt")))
+            >> literal ('"')];
+
+    } // namespace json_detail
+
+    using namespace json_detail;
+
+    PARSE_LL_DEFINE_STATIC_RULE (value,
+        parse_ll::skip (parse_ll::whitespace) [
+            object() | array() | string [one()] | parse_ll::float_ [one()]
+            | literal ("true") [one()] | literal ("false") [one()]
+            | literal ("null") [one()]])
+
+    PARSE_LL_DEFINE_STATIC_RULE (array,
+        (literal ('[') >> -(value() % literal (',')) >> literal (']'))
+            [sum()])
+
+    PARSE_LL_DEFINE_STATIC_RULE (object,
+        (literal ('{')
+            >> -((string >> literal (':') >> value()) [first()]
+                % literal (','))
+            >> literal ('}')) [sum()])
+
+    parse_ll::rule <input_type, int> const & value_rule() {
+        static parse_ll::rule <input_type, int> const rule = value();
+        return rule;
+    }
+
+} // namespace json
+
+PARSE_LL_INSTANTIATE_STATIC_RULE (json::value,
+    parse_ll::parse_policy::direct, json::input_type)
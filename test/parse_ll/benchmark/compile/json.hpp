@@ -0,0 +1,57 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Declare a JSON-like grammar that is compiled in json.cpp only.
+Every source file that includes this can use the grammar without compiling
+it again.
+*/
+
+#ifndef PARSE_LL_BENCHMARK_COMPILE_JSON_HPP_INCLUDED
+#define PARSE_LL_BENCHMARK_COMPILE_JSON_HPP_INCLUDED
+
+#include <string>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/static_rule.hpp"
+#include "parse_ll/core/rule.hpp"
+
+namespace json {
+
+    typedef range::result_of <range::callable::view (std::string const &)
+        >::type input_type;
+
+    /**
+    A JSON value.
+    The output is the number of numbers, strings, and constants in it.
+    */
+    struct value : parse_ll::static_rule <value, int> {};
+    struct array : parse_ll::static_rule <array, int> {};
+    struct object : parse_ll::static_rule <object, int> {};
+
+    /**
+    \return The same grammar as value, behind a rule.
+    */
+    parse_ll::rule <input_type, int> const & value_rule();
+
+} // namespace json
+
+PARSE_LL_EXTERN_STATIC_RULE (json::value,
+    parse_ll::parse_policy::direct, json::input_type)
+
+#endif // PARSE_LL_BENCHMARK_COMPILE_JSON_HPP_INCLUDED
@@ -0,0 +1,57 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Use the JSON-like grammar from json.hpp, which is compiled in json.cpp.
+This source file should be cheap to compile: it does not see the definition
+of the grammar.
+*/
+
+#include "json.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "parse_ll/core/outcome.hpp"
+
+/**
+\return The output of the parser on text, or -1 if it fails or does not
+consume all input.
+*/
+template <class Parser> int count (Parser const & parser,
+    std::string const & text)
+{
+    auto outcome = parse_ll::parse (parser, range::view (text));
+    if (!parse_ll::success (outcome)
+            || !range::empty (parse_ll::rest (outcome)))
+        return -1;
+    return parse_ll::output (outcome);
+}
+
+int main (int argc, char * argv[]) {
+    std::string text = argc > 1 ? argv [1]
+        : "{\"a\": [1, 2.5e3, -3], \"b\": {\"c\": \"d\\n\", \"e\": null},"
+            " \"f\": [true, false, [], {}]}";
+
+    int static_count = count (json::value(), text);
+    int rule_count = count (json::value_rule(), text);
+    std::cout << "Values: " << static_count << '\n';
+    if (static_count != rule_count) {
+        std::cerr << "static_rule and rule disagree." << std::endl;
+        return 1;
+    }
+    return static_count < 0;
+}
@@ -0,0 +1,80 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Use the parsers for numbers in a few typical ways, to measure how long this
+takes to compile and how much code it produces.
+*/
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <cstdint>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/int.hpp"
+#include "parse_ll/number/unsigned.hpp"
+#include "parse_ll/number/float.hpp"
+
+namespace {
+
+    struct add {
+        template <class Number>
+            double operator() (double sum, std::tuple <Number> number) const
+        { return sum + std::get <0> (number); }
+    };
+
+    /**
+    \return The sum of the output of parser, or 0 if it fails or does not
+    consume all input.
+    */
+    template <class Parser>
+        double sum (Parser const & parser, std::string const & text)
+    {
+        auto outcome = parse_ll::parse (
+            parse_ll::fold (0., add()) [*parser], text);
+        if (!parse_ll::success (outcome)
+                || !range::empty (parse_ll::rest (outcome)))
+            return 0;
+        return parse_ll::output (outcome);
+    }
+
+} // namespace
+
+double sum_numbers (std::string const & text) {
+    using parse_ll::literal;
+    using parse_ll::skip;
+    using parse_ll::whitespace;
+
+    return sum (skip (whitespace) [parse_ll::int_ >> -literal (',')], text)
+        + sum (skip (whitespace) [parse_ll::unsigned_as <std::uint64_t>()
+            >> -literal (',')], text)
+        + sum (skip (whitespace) [parse_ll::float_ >> -literal (',')], text)
+        + sum (skip (whitespace) [parse_ll::float_as <float>()
+            >> -literal (',')], text);
+}
+
+std::vector <double> read_floats (std::string const & text) {
+    auto outcome = parse_ll::parse (
+        parse_ll::skip (parse_ll::whitespace) [
+            parse_ll::float_ % parse_ll::literal (',')], text);
+    if (!parse_ll::success (outcome))
+        return std::vector <double>();
+    return parse_ll::output (outcome);
+}
@@ -0,0 +1,95 @@
+#!/bin/bash
+
+# Measure what the representative grammars in compile/ cost to compile, and
+# check this against the budget in compile_budget.txt.
+
+# For every source file, this reports:
+# - the time it takes to compile with optimisation;
+# - the size of the code in the object file;
+# - the number of functions instantiated from parse_ll, counted as the
+#   functions in parse_ll that an unoptimised object file defines.
+# If the compiler supports -ftime-trace (Clang does), it also reports the
+# number of class and function template instantiations that the compiler
+# performed.
+# The times depend on the machine, so only the code size and the number of
+# functions are checked against the budget.
+# The script exits with status 1 if any budget is exceeded.
+
+# Environment variables:
+#   CXX        The compiler (default: c++).
+#   CXXFLAGS   Flags for the optimised build (default: -std=c++11 -O2).
+#   INCLUDES   Include flags.
+#       By default, the include directories of this repository and of the
+#       repositories next to it, as in the "parse_ll-test" repository.
+#   BUDGET     The budget file (default: compile_budget.txt next to this).
+
+set -o nounset
+set -o errexit
+
+here="$(cd "$(dirname "$0")" && pwd)"
+root="$(cd "$here/../../.." && pwd)"
+
+CXX="${CXX:-c++}"
+CXXFLAGS="${CXXFLAGS:--std=c++11 -O2}"
+if [ -z "${INCLUDES:-}" ]; then
+    INCLUDES="-I$root/include"
+    for directory in "$root"/../*/include; do
+        [ -d "$directory" ] && INCLUDES="$INCLUDES -I$directory"
+    done
+fi
+BUDGET="${BUDGET:-$here/compile_budget.txt}"
+
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+if $CXX -ftime-trace -x c++ -c /dev/null -o "$work/probe.o" \
+        > /dev/null 2>&1; then
+    time_trace=yes
+else
+    time_trace=no
+fi
+
+printf "%-16s %8s %10s %10s %10s\n" \
+    source seconds "text (kB)" functions templates
+
+over_budget=0
+for source in "$here"/compile/*.cpp; do
+    name="$(basename "$source" .cpp)"
+
+    start=$(date +%s.%N)
+    $CXX $CXXFLAGS $INCLUDES -c "$source" -o "$work/$name.o"
+    end=$(date +%s.%N)
+    seconds=$(awk "BEGIN { print $end - $start }")
+    text=$(size "$work/$name.o" | awk 'NR == 2 { print int ($1 / 1024) }')
+
+    $CXX $CXXFLAGS -O0 $INCLUDES -c "$source" -o "$work/$name.O0.o"
+    functions=$(nm -C --defined-only "$work/$name.O0.o" \
+        | grep -c ' [TtWw] .*parse_ll::' || true)
+
+    templates=-
+    if [ $time_trace = yes ]; then
+        mkdir -p "$work/trace"
+        $CXX $CXXFLAGS $INCLUDES -ftime-trace -c "$source" \
+            -o "$work/trace/$name.o"
+        templates=$(grep -o '"name":"Instantiate\(Class\|Function\)"' \
+            "$work/trace/$name.json" | wc -l)
+    fi
+
+    printf "%-16s %8.2f %10d %10d %10s\n" \
+        "$name" "$seconds" "$text" "$functions" "$templates"
+
+    budget=$(awk -v name="$name" '$1 == name { print $2, $3 }' "$BUDGET")
+    if [ -n "$budget" ]; then
+        set -- $budget
+        if [ "$text" -gt "$1" ]; then
+            echo "  $name: text is $text kB; the budget is $1 kB."
+            over_budget=1
+        fi
+        if [ "$functions" -gt "$2" ]; then
+            echo "  $name: $functions functions; the budget is $2."
+            over_budget=1
+        fi
+    fi
+done
+
+exit $over_budget
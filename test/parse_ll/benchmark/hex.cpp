@@ -0,0 +1,134 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Compare the speed of parsing a list of 64-bit hexadecimal numbers in three
+ways:
+\li one digit at a time, with fold and hex_digit;
+\li with uint_as <std::uint64_t, 16>() on contiguous memory, which converts
+8 digits at a time;
+\li with the same parser on a std::list, which converts one digit at a time
+through the range interface.
+Each sums the numbers, so that the conversion cannot be optimised away.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <list>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/uint.hpp"
+
+std::string make_input (int number_num) {
+    std::string input;
+    std::uint64_t value = 0x9e3779b97f4a7c15ull;
+    static char const digits [] = "0123456789abcdef";
+    for (int i = 0; i != number_num; ++ i) {
+        // Vary the length of the numbers.
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        std::uint64_t number = value >> (value & 0x3f);
+        std::string text;
+        do {
+            text.insert (text.begin(), digits [number & 0xf]);
+            number >>= 4;
+        } while (number);
+        input += text;
+        input += ' ';
+    }
+    return input;
+}
+
+struct add {
+    std::uint64_t operator() (std::uint64_t sum, std::uint64_t number) const
+    { return sum + number; }
+};
+
+/**
+\return The throughput in MB/s of parse, which is called with input.
+*/
+template <class Parse, class Input> double measure (Parse const & parse,
+    Input const & input, std::size_t size, int repetition_num)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i != repetition_num; ++ i)
+        parse (input);
+    std::chrono::duration <double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return double (size) * repetition_num / elapsed.count() / 1e6;
+}
+
+int main (int argc, char * argv[]) {
+    int repetition_num = argc > 1 ? std::atoi (argv [1]) : 20;
+    std::string const input = make_input (100000);
+    std::list <char> const list (input.begin(), input.end());
+
+    auto digits = parse_ll::no_skip [parse_ll::fold (std::uint64_t(),
+        parse_ll::collect_integer <std::uint64_t, 16>()) [
+            +parse_ll::hex_digit]];
+    auto digit_grammar = parse_ll::skip (parse_ll::literal (' ')) [
+        parse_ll::fold (std::uint64_t(), add()) [*digits]];
+    auto hex_grammar = parse_ll::skip (parse_ll::literal (' ')) [
+        parse_ll::fold (std::uint64_t(), add()) [
+            *parse_ll::uint_as <std::uint64_t, 16>()]];
+
+    std::uint64_t expected = parse_ll::output (
+        parse_ll::parse (digit_grammar, input));
+
+    auto check = [&] (std::uint64_t sum) {
+        if (sum != expected) {
+            std::cerr << "Wrong sum." << std::endl;
+            std::exit (1);
+        }
+    };
+
+    std::cout << "Input: " << input.size() << " bytes; "
+        << repetition_num << " parses.\n";
+
+    double digit_throughput = measure ([&] (std::string const & input) {
+            check (parse_ll::output (parse_ll::parse (digit_grammar, input)));
+        }, input, input.size(), repetition_num);
+
+    double hex_throughput = measure ([&] (std::string const & input) {
+            check (parse_ll::output (parse_ll::parse (hex_grammar, input)));
+        }, input, input.size(), repetition_num);
+
+    double list_throughput = measure ([&] (std::list <char> const & input) {
+            check (parse_ll::output (parse_ll::parse (hex_grammar, input)));
+        }, list, input.size(), repetition_num);
+
+    std::cout << std::fixed;
+    std::cout << std::setw (12) << "parser" << std::setw (14) << "MB/s"
+        << std::setw (10) << "relative" << '\n';
+    std::cout << std::setw (12) << "hex_digit" << std::setw (14)
+        << std::setprecision (1) << digit_throughput
+        << std::setw (10) << std::setprecision (2) << 1. << '\n';
+    std::cout << std::setw (12) << "hex_" << std::setw (14)
+        << std::setprecision (1) << hex_throughput
+        << std::setw (10) << std::setprecision (2)
+        << hex_throughput / digit_throughput << '\n';
+    std::cout << std::setw (12) << "hex_ (list)" << std::setw (14)
+        << std::setprecision (1) << list_throughput
+        << std::setw (10) << std::setprecision (2)
+        << list_throughput / digit_throughput << '\n';
+    return 0;
+}
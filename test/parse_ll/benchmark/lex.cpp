@@ -0,0 +1,128 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Compare the speed of one grammar in two forms:
+\li composed statically from parsers that work on characters, with a skip
+parser for the whitespace;
+\li a lexer that splits the input into tokens and drops the whitespace,
+followed by a grammar that works on tokens.
+The time for the second includes running the lexer.
+
+Both only recognise the input.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/lex.hpp"
+
+std::string make_input (int line_num) {
+    std::string input;
+    for (int line = 0; line != line_num; ++ line) {
+        for (int column = 0; column != 10; ++ column) {
+            if (column != 0)
+                input += " , ";
+            input += std::to_string ((line * 7919 + column * 104729) % 100000);
+        }
+        input += " ;\n";
+    }
+    return input;
+}
+
+struct match_digit {
+    bool operator() (char c) const { return c >= '0' && c <= '9'; }
+};
+
+void fail (const char * name) {
+    std::cerr << name << ": parse error." << std::endl;
+    std::exit (1);
+}
+
+/**
+\return The throughput in MB/s of parse, which is called with input.
+*/
+template <class Parse> double measure (Parse const & parse,
+    std::string const & input, int repetition_num)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i != repetition_num; ++ i)
+        parse (input);
+    std::chrono::duration <double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return double (input.size()) * repetition_num / elapsed.count() / 1e6;
+}
+
+enum kind { number, comma, semicolon };
+
+int main (int argc, char * argv[]) {
+    namespace lex = parse_ll::lex;
+    using parse_ll::literal;
+    using parse_ll::token;
+
+    int repetition_num = argc > 1 ? std::atoi (argv [1]) : 50;
+    std::string const input = make_input (1000);
+
+    auto digit = parse_ll::char_parser <match_digit>();
+    auto line = parse_ll::no_skip [+digit] % literal (',') >> literal (';');
+    auto char_grammar = parse_ll::skip (parse_ll::whitespace) [
+        *line >> parse_ll::end];
+
+    lex::lexer lexer ({
+        {number, +lex::between ('0', '9')},
+        {comma, lex::literal (',')},
+        {semicolon, lex::literal (';')},
+        {lex::ignore, +lex::one_of (" \t\r\n")}});
+    auto token_grammar = *(token (number) % token (comma)
+        >> token (semicolon)) >> parse_ll::end;
+
+    std::cout << "Input: " << input.size() << " bytes; "
+        << repetition_num << " parses.\n";
+
+    double char_throughput = measure ([&] (std::string const & input) {
+            auto outcome = parse_ll::parse (char_grammar, input);
+            if (!parse_ll::success (outcome))
+                fail ("characters");
+        }, input, repetition_num);
+
+    double token_throughput = measure ([&] (std::string const & input) {
+            std::vector <lex::token> tokens = lexer.tokenize (input);
+            auto outcome = parse_ll::parse (token_grammar,
+                range::view (tokens));
+            if (!parse_ll::success (outcome))
+                fail ("tokens");
+        }, input, repetition_num);
+
+    std::cout << std::fixed;
+    std::cout << std::setw (12) << "grammar" << std::setw (14) << "MB/s"
+        << std::setw (10) << "relative" << '\n';
+    std::cout << std::setw (12) << "characters" << std::setw (14)
+        << std::setprecision (1) << char_throughput
+        << std::setw (10) << std::setprecision (2) << 1. << '\n';
+    std::cout << std::setw (12) << "tokens" << std::setw (14)
+        << std::setprecision (1) << token_throughput
+        << std::setw (10) << std::setprecision (2)
+        << token_throughput / char_throughput << '\n';
+    return 0;
+}
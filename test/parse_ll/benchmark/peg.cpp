@@ -0,0 +1,125 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Compare the speed of one grammar in three forms:
+\li composed statically from parsers;
+\li compiled from the static grammar into bytecode;
+\li read at run time from PEG notation, which also produces bytecode.
+
+All three only recognise the input, so that the comparison is about the
+parsing and not about producing output.
+The output lists the throughput of each, and its speed relative to the static
+grammar.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/bytecode.hpp"
+
+std::string make_input (int line_num) {
+    std::string input;
+    for (int line = 0; line != line_num; ++ line) {
+        if (line != 0)
+            input += '\n';
+        for (int column = 0; column != 10; ++ column) {
+            if (column != 0)
+                input += ", ";
+            input += std::to_string ((line * 7919 + column * 104729) % 100000
+                - 50000);
+        }
+    }
+    return input;
+}
+
+struct match_digit {
+    bool operator() (char c) const { return c >= '0' && c <= '9'; }
+};
+
+/**
+\return The throughput of parser on input in MB/s.
+*/
+template <class Parser> double measure (const char * name,
+    Parser const & parser, std::string const & input, int repetition_num)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i != repetition_num; ++ i) {
+        auto outcome = parse_ll::parse (parser, input);
+        if (!parse_ll::success (outcome)
+                || !range::empty (parse_ll::rest (outcome)))
+        {
+            std::cerr << name << ": parse error." << std::endl;
+            std::exit (1);
+        }
+    }
+    std::chrono::duration <double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return double (input.size()) * repetition_num / elapsed.count() / 1e6;
+}
+
+int main (int argc, char * argv[]) {
+    using parse_ll::literal;
+
+    int repetition_num = argc > 1 ? std::atoi (argv [1]) : 50;
+    std::string const input = make_input (1000);
+
+    auto digit = parse_ll::char_parser <match_digit>();
+    auto number = -literal ('-') >> +digit;
+    auto line = number >> *(literal (',') >> *literal (' ') >> number);
+    auto static_grammar = line >> *(literal ('\n') >> line);
+
+    auto compiled_grammar = parse_ll::bytecode_parser (
+        parse_ll::bytecode::compile (static_grammar));
+
+    auto peg_grammar = parse_ll::peg (
+        "file   <- line ('\\n' line)*\n"
+        "line   <- number (',' ' '* number)*\n"
+        "number <- '-'? [0-9]+\n");
+
+    std::cout << "Input: " << input.size() << " bytes; "
+        << repetition_num << " parses.\n";
+    std::cout << std::setw (10) << "grammar" << std::setw (14) << "MB/s"
+        << std::setw (10) << "relative" << '\n';
+
+    double static_throughput = measure (
+        "static", static_grammar, input, repetition_num);
+    double compiled_throughput = measure (
+        "bytecode", compiled_grammar, input, repetition_num);
+    double peg_throughput = measure (
+        "peg", peg_grammar, input, repetition_num);
+
+    std::cout << std::fixed;
+    std::cout << std::setw (10) << "static" << std::setw (14)
+        << std::setprecision (1) << static_throughput
+        << std::setw (10) << std::setprecision (2) << 1. << '\n';
+    std::cout << std::setw (10) << "bytecode" << std::setw (14)
+        << std::setprecision (1) << compiled_throughput
+        << std::setw (10) << std::setprecision (2)
+        << compiled_throughput / static_throughput << '\n';
+    std::cout << std::setw (10) << "peg" << std::setw (14)
+        << std::setprecision (1) << peg_throughput
+        << std::setw (10) << std::setprecision (2)
+        << peg_throughput / static_throughput << '\n';
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Measure how parsing with one compiled_grammar scales with the number of
+threads.
+
+Every thread parses the same input a fixed number of times with the same
+grammar, which contains rules.
+Since parsing touches no shared mutable state, the throughput should grow
+linearly with the number of threads, up to the number of cores.
+The output lists, for each number of threads, the throughput and the speed-up
+relative to one thread.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/int.hpp"
+
+typedef range::result_of <range::callable::view (std::string const &)>::type
+    input_type;
+
+typedef parse_ll::rule <input_type, std::vector <int>> line_rule;
+typedef parse_ll::rule <input_type, std::vector <std::vector <int>>>
+    document_rule;
+
+document_rule make_grammar() {
+    line_rule line = parse_ll::skip (parse_ll::horizontal_space) [
+        parse_ll::int_ % parse_ll::literal (',')];
+    return line % parse_ll::newline;
+}
+
+std::string make_input (int line_num) {
+    std::string input;
+    for (int line = 0; line != line_num; ++ line) {
+        if (line != 0)
+            input += '\n';
+        for (int column = 0; column != 10; ++ column) {
+            if (column != 0)
+                input += ", ";
+            input += std::to_string ((line * 7919 + column * 104729) % 100000
+                - 50000);
+        }
+    }
+    return input;
+}
+
+/**
+Parse input repetition_num times, and return the number of numbers found, so
+that the work cannot be optimised away.
+*/
+template <class Grammar> std::size_t parse_repeatedly (
+    Grammar const & grammar, std::string const & input, int repetition_num)
+{
+    std::size_t number_num = 0;
+    for (int i = 0; i != repetition_num; ++ i) {
+        auto outcome = grammar.parse (input);
+        if (!parse_ll::success (outcome)) {
+            std::cerr << "Parse error." << std::endl;
+            std::exit (1);
+        }
+        for (auto const & line : parse_ll::output (outcome))
+            number_num += line.size();
+    }
+    return number_num;
+}
+
+int main (int argc, char * argv[]) {
+    int repetition_num = argc > 1 ? std::atoi (argv [1]) : 50;
+    unsigned max_thread_num = std::thread::hardware_concurrency();
+    if (argc > 2)
+        max_thread_num = unsigned (std::atoi (argv [2]));
+    if (max_thread_num == 0)
+        max_thread_num = 1;
+
+    auto const grammar = parse_ll::compile (make_grammar());
+    std::string const input = make_input (1000);
+
+    std::cout << "Input: " << input.size() << " bytes; "
+        << repetition_num << " parses per thread.\n";
+    std::cout << std::setw (8) << "threads" << std::setw (14) << "MB/s"
+        << std::setw (10) << "speed-up" << '\n';
+
+    double single_thread_throughput = 0;
+    for (unsigned thread_num = 1; thread_num <= max_thread_num;
+        ++ thread_num)
+    {
+        std::vector <std::size_t> number_nums (thread_num);
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::vector <std::thread> threads;
+            for (unsigned index = 0; index != thread_num; ++ index)
+                threads.emplace_back ([&, index]() {
+                    number_nums [index] = parse_repeatedly (
+                        grammar, input, repetition_num);
+                });
+            for (auto & thread : threads)
+                thread.join();
+        }
+        std::chrono::duration <double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        for (std::size_t number_num : number_nums) {
+            if (number_num != number_nums.front()) {
+                std::cerr << "Threads disagree." << std::endl;
+                return 1;
+            }
+        }
+
+        double throughput = double (input.size()) * repetition_num
+            * thread_num / elapsed.count() / 1e6;
+        if (thread_num == 1)
+            single_thread_throughput = throughput;
+        std::cout << std::setw (8) << thread_num
+            << std::setw (14) << std::fixed << std::setprecision (1)
+            << throughput
+            << std::setw (10) << std::setprecision (2)
+            << throughput / single_thread_throughput << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,237 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test lowering parsers into bytecode and running the bytecode, by comparing
+the result with the result of the parser itself.
+*/
+
+#define BOOST_TEST_MODULE bytecode
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/bytecode.hpp"
+
+#include <string>
+#include <vector>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/int.hpp"
+#include "parse_ll/number/digit.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_bytecode)
+
+typedef range::result_of <range::callable::view (std::string const &)>::type
+    input_type;
+
+std::size_t length (input_type input) {
+    std::size_t result = 0;
+    for (; !range::empty (input); input = range::drop (input))
+        ++ result;
+    return result;
+}
+
+/**
+Check that parser and its bytecode agree on whether the parse succeeds, and
+what the rest of the input is.
+*/
+template <class Parser>
+    void check_same (Parser const & parser, std::string const & text)
+{
+    auto program = parse_ll::bytecode::compile (parser);
+    input_type input = range::view (text);
+    auto outcome = parse_ll::parse (parser, input);
+    auto result = parse_ll::bytecode::run (program, input);
+    BOOST_CHECK_EQUAL (result.success, parse_ll::success (outcome));
+    if (result.success && parse_ll::success (outcome)) {
+        BOOST_CHECK_EQUAL (length (result.rest),
+            length (parse_ll::rest (outcome)));
+    }
+}
+
+template <class Parser>
+    void check_same (Parser const & parser, std::vector <std::string> texts)
+{
+    for (auto const & text : texts)
+        check_same (parser, text);
+}
+
+struct to_int { int operator() (char c) const { return c; } };
+struct add {
+    int operator() (int sum, int digit) const { return sum + digit; }
+};
+
+BOOST_AUTO_TEST_CASE (test_bytecode_primitives) {
+    using parse_ll::char_;
+    using parse_ll::literal;
+
+    std::vector <std::string> texts {"", "a", "b", "ab", "abc", "abd",
+        "1", "12a", " a", "\xe9"};
+
+    check_same (char_, texts);
+    check_same (char_ ('a'), texts);
+    check_same (char_ ('\xe9'), texts);
+    check_same (literal ('b'), texts);
+    check_same (literal ("abc"), texts);
+    check_same (literal (""), texts);
+    check_same (parse_ll::digit, texts);
+    check_same (parse_ll::end, texts);
+    check_same (parse_ll::nothing, texts);
+    BOOST_CHECK (!parse_ll::bytecode::run (
+        parse_ll::bytecode::compile (parse_ll::fail),
+        range::view (texts [1])).success);
+}
+
+BOOST_AUTO_TEST_CASE (test_bytecode_structure) {
+    using parse_ll::char_;
+    using parse_ll::literal;
+    using parse_ll::repeat;
+    using parse_ll::digit;
+
+    std::vector <std::string> texts {"", "a", "b", "ab", "aab", "aaab",
+        "aaaab", "abab", "a,a,a", "a,a,", "1,2,3x", "ba", "bab"};
+
+    check_same (char_ ('a') >> char_ ('b'), texts);
+    check_same (char_ ('a') | char_ ('b'), texts);
+    check_same (literal ("ab") | literal ('a'), texts);
+    check_same (parse_ll::variant_alternative (
+        char_ ('a'), literal ('b')), texts);
+    check_same (-char_ ('a') >> char_ ('b'), texts);
+    check_same (*char_ ('a'), texts);
+    check_same (+char_ ('a') >> parse_ll::end, texts);
+    check_same (repeat (2, 3) [char_ ('a')], texts);
+    check_same (repeat (2) [char_ ('a')] >> char_ ('b'), texts);
+    check_same (repeat.at_least (2) [char_ ('a')], texts);
+    check_same (repeat.at_most (2) [char_ ('a')] >> char_ ('b'), texts);
+    check_same (*(char_ ('a') >> char_ ('b')), texts);
+    check_same (*(char_ - char_ ('b')), texts);
+    check_same ((char_ ('a') | char_ (',')) - literal ("a,"), texts);
+    check_same (char_ ('a') % char_ (','), texts);
+    check_same (digit % char_ (','), texts);
+    check_same (parse_ll::fixed_repeat <2>() [char_ ('a')], texts);
+    check_same (parse_ll::collect <std::string>() [+char_ ('a')], texts);
+    check_same (parse_ll::fold (0, add()) [*digit], texts);
+    check_same (char_ ('a') [to_int()], texts);
+}
+
+BOOST_AUTO_TEST_CASE (test_bytecode_skip) {
+    using parse_ll::char_;
+    using parse_ll::literal;
+    using parse_ll::skip;
+    using parse_ll::skip_pad;
+    using parse_ll::no_skip;
+    using parse_ll::horizontal_space;
+
+    std::vector <std::string> texts {"", "a", "ab", "a b", "a  b ",
+        " a b", "a b c", "a, b ,c ", "a,b,", "ab c", "a b, "};
+
+    check_same (skip (horizontal_space) [char_ ('a') >> char_ ('b')], texts);
+    check_same (skip (horizontal_space) [*char_ ('a') >> char_ ('b')],
+        texts);
+    check_same (skip (horizontal_space) [+(char_ - literal (','))], texts);
+    check_same (skip (horizontal_space) [char_ % literal (',')], texts);
+    check_same (skip_pad (horizontal_space) [char_ ('a') >> char_ ('b')],
+        texts);
+    check_same (skip (horizontal_space) [
+        char_ ('a') >> no_skip [char_ >> char_]], texts);
+    check_same (skip (horizontal_space) [
+        parse_ll::int_ % literal (',')], {"1, 2,3", "-1 , 22", "1,"});
+}
+
+BOOST_AUTO_TEST_CASE (test_bytecode_rule) {
+    using parse_ll::char_;
+    using parse_ll::literal;
+
+    std::vector <std::string> texts {"", "()", "(())", "()()", "(()",
+        "(()())x", ")(", "( ( ) )", "(a)"};
+
+    using parse_ll::bytecode::lowerable;
+
+    parse_ll::rule <input_type> pair
+        = lowerable (literal ('(') >> literal (')'));
+    parse_ll::rule <input_type> pairs = lowerable (*pair);
+    check_same (pairs, texts);
+    check_same (parse_ll::skip (parse_ll::horizontal_space) [pairs], texts);
+    // The same rule with two skip parsers.
+    check_same (parse_ll::skip (parse_ll::horizontal_space) [pairs]
+        >> pair >> pairs, texts);
+
+    parse_ll::rule <input_type, void, parse_ll::rule_explicit_skip_parser>
+        explicit_skip = lowerable (parse_ll::skip (parse_ll::horizontal_space) [
+            char_ ('(') >> char_ (')')]);
+    check_same (explicit_skip, texts);
+
+    // A rule that has not been initialised cannot be lowered.
+    parse_ll::rule <input_type> empty_rule;
+    BOOST_CHECK_THROW (parse_ll::bytecode::compile (empty_rule),
+        parse_ll::bytecode::lowering_error);
+
+    // Nor can a rule that was not initialised with lowerable().
+    parse_ll::rule <input_type> plain_rule = literal ('(');
+    BOOST_CHECK (parse_ll::success (parse_ll::parse (plain_rule,
+        std::string ("("))));
+    BOOST_CHECK_THROW (parse_ll::bytecode::compile (plain_rule),
+        parse_ll::bytecode::lowering_error);
+}
+
+BOOST_AUTO_TEST_CASE (test_bytecode_diagnostics) {
+    using parse_ll::char_;
+    using parse_ll::literal;
+
+    std::string text ("ab x");
+    auto program = parse_ll::bytecode::compile (
+        parse_ll::skip (parse_ll::horizontal_space) [
+            literal ("ab") >> parse_ll::int_]);
+    auto result = parse_ll::bytecode::run (program, range::view (text));
+    BOOST_CHECK (!result.success);
+    BOOST_CHECK_EQUAL (result.furthest, 3u);
+    // The description of the named parser is used.
+    BOOST_CHECK_EQUAL (result.expected, "int");
+
+    // Expectation failure.
+    auto expect_program = parse_ll::bytecode::compile (
+        char_ ('a') > char_ ('b'));
+    BOOST_CHECK (!parse_ll::bytecode::run (
+        expect_program, range::view (std::string ("b"))).success);
+    BOOST_CHECK_THROW (parse_ll::bytecode::run (
+        expect_program, range::view (std::string ("ac"))), parse_ll::error);
+    BOOST_CHECK_THROW (parse_ll::parse (
+        char_ ('a') > char_ ('b'), std::string ("ac")), parse_ll::error);
+
+    // Parsers that need outputs at parse time cannot be lowered.
+    BOOST_CHECK_THROW (parse_ll::bytecode::compile (
+        parse_ll::counted (parse_ll::digit) [char_]),
+        parse_ll::bytecode::lowering_error);
+}
+
+BOOST_AUTO_TEST_CASE (test_bytecode_parser) {
+    using parse_ll::char_;
+
+    parse_ll::bytecode_parser ab (
+        parse_ll::bytecode::compile (+char_ ('a') >> char_ ('b')));
+    BOOST_CHECK_EQUAL (parse_ll::describe (ab), std::string ("bytecode"));
+
+    std::string text ("aab,ab");
+    auto outcome = parse_ll::parse (ab % char_ (','), text);
+    BOOST_CHECK (parse_ll::success (outcome));
+    BOOST_CHECK (range::empty (parse_ll::rest (outcome)));
+
+    BOOST_CHECK (!parse_ll::success (parse_ll::parse (ab, std::string ("b"))));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,208 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test reading grammars in PEG notation at run time.
+*/
+
+#define BOOST_TEST_MODULE bytecode_peg
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/bytecode/peg.hpp"
+
+#include <string>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_bytecode_peg)
+
+/**
+\return The number of characters that the grammar consumes from text, or -1
+if it fails.
+*/
+int consumed (parse_ll::bytecode_parser const & parser,
+    std::string const & text)
+{
+    auto outcome = parse_ll::parse (parser, text);
+    if (!parse_ll::success (outcome))
+        return -1;
+    int rest = 0;
+    for (auto r = parse_ll::rest (outcome); !range::empty (r);
+            r = range::drop (r))
+        ++ rest;
+    return int (text.size()) - rest;
+}
+
+BOOST_AUTO_TEST_CASE (test_peg_elements) {
+    using parse_ll::peg;
+
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- 'ab'"), "abc"), 2);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- \"ab\""), "ac"), -1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- ."), "xy"), 1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- ."), ""), -1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- [a-c_]*"), "ab_cd"), 4);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- [^a-c]*"), "xyzb"), 3);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- [-x]+"), "x-x-y"), 4);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- 'a' 'b'"), "abc"), 2);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- 'a' / 'b'"), "bc"), 1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a = 'a' | 'b' ;"), "bc"), 1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- 'ab' / 'a'"), "ac"), 1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- 'a'+"), "aaab"), 3);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- 'a'+"), "b"), -1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- 'a'? 'b'"), "b"), 1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- ('a' 'b')*"), "ababa"), 4);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- !'b' ."), "a"), 1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- !'b' ."), "b"), -1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- &'a' ."), "a"), 1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- &'a' ."), "b"), -1);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- !."), ""), 0);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- '\\n\\t\\x41\\''"), "\n\tA'"), 4);
+    BOOST_CHECK_EQUAL (consumed (peg ("a <- [\\]\\\\]*"), "]\\]x"), 3);
+}
+
+BOOST_AUTO_TEST_CASE (test_peg_rules) {
+    // Rules refer to each other, recursively and before they are defined.
+    std::string grammar (
+        "# Nested lists of numbers.\n"
+        "list   <- '(' items? ')'\n"
+        "items  <- item (',' item)*\n"
+        "item   <- list\n"
+        "        / number\n"
+        "number <- '-'? digit+   # A comment.\n"
+        "digit  <- [0-9]\n");
+    auto parser = parse_ll::peg (grammar);
+    BOOST_CHECK_EQUAL (consumed (parser, "()"), 2);
+    BOOST_CHECK_EQUAL (consumed (parser, "(1,-23,(4,()))x"), 14);
+    BOOST_CHECK_EQUAL (consumed (parser, "(1,"), -1);
+
+    // Another start rule.
+    BOOST_CHECK_EQUAL (consumed (parse_ll::peg (grammar, "items"), "1,2)"), 3);
+
+    // Use the parser inside a statically composed grammar.
+    auto lists = parser % parse_ll::literal (';');
+    auto outcome = parse_ll::parse (lists, std::string ("(1);(2,3)"));
+    BOOST_CHECK (parse_ll::success (outcome));
+    BOOST_CHECK (range::empty (parse_ll::rest (outcome)));
+
+    // Diagnostics use the names of the rules.
+    auto result = parse_ll::bytecode::run (parse_ll::bytecode::compile_peg (
+        grammar), range::view (std::string ("(1,x")));
+    BOOST_CHECK (!result.success);
+    BOOST_CHECK_EQUAL (result.furthest, 3u);
+    BOOST_CHECK_EQUAL (result.expected, "list");
+}
+
+BOOST_AUTO_TEST_CASE (test_peg_errors) {
+    using parse_ll::bytecode::compile_peg;
+    using parse_ll::bytecode::grammar_error;
+
+    BOOST_CHECK_THROW (compile_peg (""), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("# Nothing"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a 'b'"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a <- 'b"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a <- [b"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a <- [z-a]"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a <- ('b'"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a <- '\\q'"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a <- b"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a <- 'b'\na <- 'c'"), grammar_error);
+    BOOST_CHECK_THROW (compile_peg ("a <- 'b'", "c"), grammar_error);
+
+    try {
+        compile_peg ("a <- 'b'\n\nc <- )");
+        BOOST_ERROR ("Expected an exception");
+    } catch (grammar_error & e) {
+        std::size_t const * line
+            = boost::get_error_info <parse_ll::bytecode::grammar_line> (e);
+        BOOST_REQUIRE (line);
+        BOOST_CHECK_EQUAL (*line, 3u);
+    }
+}
+
+/**
+\return The line in the grammar_error that compiling grammar throws, or 0 if
+it contains none.
+*/
+std::size_t error_line (std::string const & grammar,
+    std::string const & start = std::string())
+{
+    try {
+        parse_ll::bytecode::compile_peg (grammar, start);
+    } catch (parse_ll::bytecode::grammar_error & e) {
+        std::size_t const * line
+            = boost::get_error_info <parse_ll::bytecode::grammar_line> (e);
+        return line ? *line : 0;
+    }
+    BOOST_ERROR ("Expected an exception");
+    return 0;
+}
+
+// Errors about rules contain the line the rule is defined on.
+BOOST_AUTO_TEST_CASE (test_peg_error_lines) {
+    // Undefined rule.
+    BOOST_CHECK_EQUAL (error_line ("a <- 'b'\n\n# c\nc <- 'x'\n d"), 4u);
+    // Defined twice.
+    BOOST_CHECK_EQUAL (error_line ("a <- 'b'\nc <- 'c'\na <- 'c'"), 3u);
+    // Repetition of an expression that can match nothing.
+    BOOST_CHECK_EQUAL (error_line ("a <- b\nb <- 'b'?*"), 2u);
+    // Left recursion.
+    BOOST_CHECK_EQUAL (error_line ("a <- 'x' b\n\nb <- b 'y'"), 3u);
+    // The start rule is not in the grammar text.
+    BOOST_CHECK_EQUAL (error_line ("a <- 'b'", "c"), 0u);
+}
+
+/**
+\return The rule named in the grammar_error that compiling grammar throws, or
+"" if it throws none.
+*/
+std::string rejected_rule (std::string const & grammar) {
+    try {
+        parse_ll::bytecode::compile_peg (grammar);
+    } catch (parse_ll::bytecode::grammar_error & e) {
+        std::string const * rule
+            = boost::get_error_info <parse_ll::bytecode::grammar_rule> (e);
+        return rule ? *rule : "(no rule)";
+    }
+    return "";
+}
+
+// Grammars that would not terminate are rejected.
+BOOST_AUTO_TEST_CASE (test_peg_termination) {
+    // Repetitions of expressions that can match nothing.
+    BOOST_CHECK_EQUAL (rejected_rule ("start <- ('x'?)*"), "start");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- 'a' b+\nb <- c\nc <- 'c'*"),
+        "a");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- (!'b')*"), "a");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- ('' / 'x')*"), "a");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- 'x' b*\nb <- 'y'? 'z'?"), "a");
+
+    // Left recursion, directly and indirectly.
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- a 'x' / 'y'"), "a");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- b 'x'\nb <- 'y'? a"), "a");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- 'x' b\nb <- c\nc <- !b 'y'"),
+        "b");
+
+    // These do terminate.
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- ('x'? 'y')*"), "");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- 'x' a / 'y'"), "");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- b*\nb <- 'x' b?"), "");
+    BOOST_CHECK_EQUAL (rejected_rule ("a <- ('x'*)?"), "");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,175 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test writing and reading bytecode programs.
+*/
+
+#define BOOST_TEST_MODULE bytecode_program
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/bytecode.hpp"
+
+#include <string>
+#include <sstream>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/int.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_bytecode_program)
+
+using parse_ll::bytecode::program;
+using parse_ll::bytecode::opcode;
+using parse_ll::bytecode::instruction;
+
+BOOST_AUTO_TEST_CASE (test_bytecode_program_round_trip) {
+    using parse_ll::literal;
+
+    auto original = parse_ll::bytecode::compile (
+        parse_ll::skip (parse_ll::horizontal_space) [
+            literal ("key\n =") >> parse_ll::int_ % literal (',')]);
+
+    std::stringstream stream;
+    original.write (stream);
+    program read = program::read (stream);
+
+    BOOST_CHECK (read.strings == original.strings);
+    BOOST_CHECK (read.sets == original.sets);
+    BOOST_CHECK (read.descriptions == original.descriptions);
+    BOOST_REQUIRE_EQUAL (read.instructions.size(),
+        original.instructions.size());
+    for (std::size_t index = 0; index != read.instructions.size(); ++ index) {
+        instruction const & i = read.instructions [index];
+        instruction const & o = original.instructions [index];
+        BOOST_CHECK (i.code == o.code);
+        BOOST_CHECK_EQUAL (i.argument, o.argument);
+        BOOST_CHECK_EQUAL (i.description, o.description);
+    }
+
+    std::string good ("key\n = 1, -2 ,3");
+    std::string bad ("key\n = 1, -");
+    BOOST_CHECK (parse_ll::bytecode::run (read, range::view (good)).success);
+    auto result = parse_ll::bytecode::run (read, range::view (bad));
+    BOOST_CHECK (result.success);
+    BOOST_CHECK_EQUAL (range::first (result.rest), ',');
+}
+
+BOOST_AUTO_TEST_CASE (test_bytecode_program_errors) {
+    auto original = parse_ll::bytecode::compile (parse_ll::literal ("ab"));
+    std::stringstream stream;
+    original.write (stream);
+    std::string text = stream.str();
+
+    // Wrong header.
+    {
+        std::stringstream wrong ("parse_ll bytecode 0\n" +
+            text.substr (text.find ('\n') + 1));
+        BOOST_CHECK_THROW (program::read (wrong),
+            parse_ll::bytecode::format_error);
+    }
+    // Cut off.
+    {
+        std::stringstream wrong (text.substr (0, text.size() - 10));
+        BOOST_CHECK_THROW (program::read (wrong),
+            parse_ll::bytecode::format_error);
+    }
+    // Unknown opcode.
+    {
+        std::string modified = text;
+        modified.replace (modified.find ("halt"), 4, "stop");
+        std::stringstream wrong (modified);
+        BOOST_CHECK_THROW (program::read (wrong),
+            parse_ll::bytecode::format_error);
+    }
+
+    // Jump out of the program.
+    program p = original;
+    p.instructions.insert (p.instructions.begin(),
+        instruction (opcode::jump, 100, 0));
+    BOOST_CHECK_THROW (p.verify(), parse_ll::bytecode::format_error);
+    // No halt at the end.
+    p = original;
+    p.instructions.pop_back();
+    BOOST_CHECK_THROW (p.verify(), parse_ll::bytecode::format_error);
+}
+
+// Counts in the stream that do not fit in memory.
+BOOST_AUTO_TEST_CASE (test_bytecode_program_huge_counts) {
+    std::string header ("parse_ll bytecode 1\n");
+    {
+        std::stringstream wrong (header
+            + "strings 1\n18446744073709551615 abc\n");
+        BOOST_CHECK_THROW (program::read (wrong),
+            parse_ll::bytecode::format_error);
+    }
+    {
+        std::stringstream wrong (header
+            + "strings 0\nsets 0\ndescriptions 1\n0 \n"
+            "instructions 18446744073709551615\nhalt 0 0\n");
+        BOOST_CHECK_THROW (program::read (wrong),
+            parse_ll::bytecode::format_error);
+    }
+    {
+        // A long string is read in pieces.
+        std::string long_string (10000, 'a');
+        std::stringstream right (header + "strings 1\n10000 " + long_string
+            + "\nsets 0\ndescriptions 1\n0 \ninstructions 1\nhalt 0 0\n");
+        BOOST_CHECK (program::read (right).strings.front() == long_string);
+    }
+}
+
+// Programs that pass verify() but use the stack wrongly.
+BOOST_AUTO_TEST_CASE (test_bytecode_program_stack) {
+    using parse_ll::bytecode::run;
+    std::string input ("a");
+
+    program p;
+    p.descriptions.push_back ("");
+    p.instructions.push_back (instruction (opcode::commit, 1, 0));
+    p.instructions.push_back (instruction (opcode::halt, 0, 0));
+    p.verify();
+    BOOST_CHECK_THROW (run (p, range::view (input)),
+        parse_ll::bytecode::format_error);
+
+    p.instructions.front() = instruction (opcode::return_, 0, 0);
+    BOOST_CHECK_THROW (run (p, range::view (input)),
+        parse_ll::bytecode::format_error);
+
+    // Return to a backtrack point.
+    p.instructions.front() = instruction (opcode::choice, 1, 0);
+    p.instructions.insert (p.instructions.begin() + 1,
+        instruction (opcode::return_, 0, 0));
+    p.verify();
+    BOOST_CHECK_THROW (run (p, range::view (input)),
+        parse_ll::bytecode::format_error);
+
+    // Commit to a return address.
+    p.instructions [0] = instruction (opcode::call, 2, 0);
+    p.instructions [1] = instruction (opcode::halt, 0, 0);
+    p.instructions [2] = instruction (opcode::partial_commit, 1, 0);
+    p.instructions.push_back (instruction (opcode::halt, 0, 0));
+    p.verify();
+    BOOST_CHECK_THROW (run (p, range::view (input)),
+        parse_ll::bytecode::format_error);
+    p.instructions [2] = instruction (opcode::fail_twice, 0, 0);
+    BOOST_CHECK_THROW (run (p, range::view (input)),
+        parse_ll::bytecode::format_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
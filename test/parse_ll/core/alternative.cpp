@@ -29,6 +29,7 @@ Test alternative parser.
 #include "range/std/container.hpp"
 
 #include "parse_ll/core/char.hpp"
+#include "parse_ll/core/literal.hpp"
 #include "parse_ll/core/nothing.hpp"
 #include "parse_ll/core/transform.hpp"
 
@@ -190,5 +191,67 @@ BOOST_AUTO_TEST_CASE (test_alternative) {
     }
 }
 
+struct count_calls {
+    int & calls;
+    explicit count_calls (int & calls) : calls (calls) {}
+
+    int operator() (char c) const { ++ calls; return c; }
+};
+
+BOOST_AUTO_TEST_CASE (test_alternative_lazy) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+
+    std::string r ("ab");
+    int calls = 0;
+    auto parser = parse_ll::char_ ('b') [count_calls (calls)]
+        | parse_ll::char_ ('a') [count_calls (calls)];
+    auto result = parse (parser, r);
+    BOOST_CHECK (success (result));
+    BOOST_CHECK_EQUAL (range::first (rest (result)), 'b');
+    // The actor is only called when the output is requested.
+    BOOST_CHECK_EQUAL (calls, 0);
+    BOOST_CHECK_EQUAL (output (result), 'a');
+    BOOST_CHECK_EQUAL (calls, 1);
+}
+
+BOOST_AUTO_TEST_CASE (test_variant_alternative) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+
+    std::string r ("ab");
+    auto parser = fuzz (parse_ll::variant_alternative (
+        parse_ll::char_ ('a') [always (object (1))],
+        parse_ll::char_ ('b')));
+
+    auto result1 = parse (parser, r);
+    BOOST_CHECK (success (result1));
+    auto output1 = output (result1);
+    BOOST_CHECK_EQUAL (output1.which(), 0);
+    BOOST_CHECK_EQUAL (boost::get <object> (output1), 1);
+
+    auto result2 = parse (parser, rest (result1));
+    BOOST_CHECK (success (result2));
+    auto output2 = output (result2);
+    BOOST_CHECK_EQUAL (output2.which(), 1);
+    BOOST_CHECK_EQUAL (boost::get <char> (output2), 'b');
+    BOOST_CHECK (range::empty (rest (result2)));
+
+    BOOST_CHECK (!success (parse (parser, rest (result2))));
+
+    // A void output becomes boost::blank.
+    auto void_parser = parse_ll::variant_alternative (
+        parse_ll::literal ('a'), parse_ll::char_);
+    auto void_result = parse (void_parser, r);
+    BOOST_CHECK (success (void_result));
+    BOOST_CHECK_EQUAL (output (void_result).which(), 0);
+    BOOST_CHECK_EQUAL (boost::get <char> (output (
+        parse (void_parser, rest (void_result)))), 'b');
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,157 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test batch_context.
+*/
+
+#define BOOST_TEST_MODULE batch
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/batch.hpp"
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/char.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/alternative.hpp"
+#include "parse_ll/core/list.hpp"
+#include "parse_ll/core/sequence.hpp"
+#include "parse_ll/core/transform.hpp"
+#include "parse_ll/core/rule.hpp"
+#include "parse_ll/core/skip.hpp"
+#include "parse_ll/core/whitespace.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_batch)
+
+typedef range::result_of <range::callable::view (std::string const &)>::type
+    input_type;
+
+parse_ll::rule <input_type, std::vector <char>> make_grammar() {
+    parse_ll::rule <input_type, char> letter
+        = parse_ll::char_ ('a') | parse_ll::char_ ('b');
+    return parse_ll::skip (parse_ll::horizontal_space) [
+        letter % parse_ll::literal (',')];
+}
+
+BOOST_AUTO_TEST_CASE (test_batch) {
+    auto const grammar = parse_ll::compile (make_grammar());
+    parse_ll::batch_context <decltype (grammar)> context (grammar);
+
+    std::vector <std::string> const inputs {
+        "a, b ,a,c", "c", "b", "", "a,a,"};
+    context.parse (inputs);
+    BOOST_CHECK_EQUAL (context.size(), 5u);
+
+    BOOST_CHECK (context.success (0));
+    BOOST_CHECK ((context.output (0) == std::vector <char> {'a', 'b', 'a'}));
+    BOOST_CHECK_EQUAL (context.rest (0), 7u);
+
+    BOOST_CHECK (!context.success (1));
+    BOOST_CHECK (!context.success (3));
+
+    BOOST_CHECK (context.item (2).success);
+    BOOST_CHECK ((context.output (2) == std::vector <char> {'b'}));
+    BOOST_CHECK_EQUAL (context.item (2).rest, 1u);
+
+    BOOST_CHECK (context.success (4));
+    BOOST_CHECK ((context.output (4) == std::vector <char> {'a', 'a'}));
+    BOOST_CHECK_EQUAL (context.rest (4), 3u);
+
+    // The context is reused for the next batch.
+    std::vector <std::string> const next {"b,b"};
+    context.parse (next);
+    BOOST_CHECK_EQUAL (context.size(), 1u);
+    BOOST_CHECK (context.success (0));
+    BOOST_CHECK ((context.output (0) == std::vector <char> {'b', 'b'}));
+    BOOST_CHECK_EQUAL (context.rest (0), 3u);
+}
+
+BOOST_AUTO_TEST_CASE (test_batch_void) {
+    auto const grammar = parse_ll::compile (
+        parse_ll::literal ('a') >> parse_ll::literal ('b'));
+    parse_ll::batch_context <decltype (grammar)> context (grammar);
+
+    std::vector <std::string> const inputs {"abc", "ba", "ab"};
+    context.parse (inputs);
+    BOOST_CHECK (context.success (0));
+    BOOST_CHECK_EQUAL (context.rest (0), 2u);
+    BOOST_CHECK (!context.success (1));
+    BOOST_CHECK (context.success (2));
+    BOOST_CHECK_EQUAL (context.rest (2), 2u);
+}
+
+BOOST_AUTO_TEST_CASE (test_batch_threads) {
+    auto const grammar = parse_ll::compile (make_grammar());
+
+    std::vector <std::string> inputs;
+    for (int i = 0; i != 10000; ++ i) {
+        std::string input;
+        for (int j = 0; j <= i % 7; ++ j)
+            input += std::string (j == 0 ? "" : ",") + "ab" [(i + j) % 3 % 2];
+        if (i % 5 == 0)
+            input = "c" + input;
+        inputs.push_back (input);
+    }
+
+    parse_ll::batch_context <decltype (grammar)> serial (grammar);
+    serial.parse (inputs);
+    parse_ll::batch_context <decltype (grammar)> parallel (grammar);
+    parallel.parse (inputs, 4);
+
+    BOOST_REQUIRE_EQUAL (parallel.size(), inputs.size());
+    for (std::size_t i = 0; i != inputs.size(); ++ i) {
+        std::string const & input = inputs [i];
+        auto outcome = grammar.parse (input);
+        BOOST_REQUIRE_EQUAL (parallel.success (i), parse_ll::success (outcome));
+        BOOST_REQUIRE_EQUAL (serial.success (i), parse_ll::success (outcome));
+        if (parallel.success (i)) {
+            BOOST_CHECK (parallel.output (i) == parse_ll::output (outcome));
+            BOOST_CHECK (serial.output (i) == parse_ll::output (outcome));
+            BOOST_CHECK_EQUAL (parallel.rest (i), serial.rest (i));
+        }
+    }
+}
+
+struct check_letter {
+    char operator() (char c) const {
+        if (c == 'c')
+            throw std::runtime_error ("Unexpected c");
+        return c;
+    }
+};
+
+BOOST_AUTO_TEST_CASE (test_batch_exception) {
+    auto const grammar = parse_ll::compile (
+        parse_ll::char_ [check_letter()]);
+    parse_ll::batch_context <decltype (grammar)> context (grammar);
+
+    std::vector <std::string> inputs (1000, "a");
+    context.parse (inputs, 4);
+    BOOST_CHECK (context.success (999));
+    BOOST_CHECK_EQUAL (context.output (999), 'a');
+
+    inputs [700] = "c";
+    BOOST_CHECK_THROW (context.parse (inputs, 4), std::runtime_error);
+    BOOST_CHECK_THROW (context.parse (inputs), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,171 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test collect parser.
+*/
+
+#define BOOST_TEST_MODULE collect_parser
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/collect.hpp"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <set>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/char.hpp"
+#include "parse_ll/core/difference.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/sequence.hpp"
+#include "parse_ll/core/skip.hpp"
+#include "parse_ll/core/transform.hpp"
+#include "parse_ll/core/whitespace.hpp"
+
+#include "../helper/fuzz_parser.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_collect)
+
+struct count_calls {
+    int & calls;
+    explicit count_calls (int & calls) : calls (calls) {}
+
+    int operator() (char c) const { ++ calls; return c - '0'; }
+};
+
+/**
+Allocator that counts the number of allocations.
+*/
+template <class Value> struct counting_allocator {
+    typedef Value value_type;
+    int * allocations;
+
+    explicit counting_allocator (int & allocations)
+    : allocations (&allocations) {}
+    template <class Other> counting_allocator (
+        counting_allocator <Other> const & other)
+    : allocations (other.allocations) {}
+
+    Value * allocate (std::size_t size) {
+        ++ *allocations;
+        return std::allocator <Value>().allocate (size);
+    }
+    void deallocate (Value * p, std::size_t size)
+    { std::allocator <Value>().deallocate (p, size); }
+
+    template <class Other> bool operator == (
+        counting_allocator <Other> const & other) const
+    { return allocations == other.allocations; }
+    template <class Other> bool operator != (
+        counting_allocator <Other> const & other) const
+    { return allocations != other.allocations; }
+};
+
+BOOST_AUTO_TEST_CASE (test_collect) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+    using parse_ll::collect;
+    using parse_ll::char_;
+
+    std::string input ("1234a");
+    {
+        auto parser = collect <std::vector <char>>() [*char_];
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        std::vector <char> o = output (result);
+        BOOST_CHECK_EQUAL (std::string (o.begin(), o.end()), "1234a");
+        BOOST_CHECK (range::empty (rest (result)));
+    }
+    {
+        // The actor is called exactly once per element.
+        int calls = 0;
+        auto parser = collect <std::vector <int>>() [
+            *(char_ - parse_ll::literal ('a')) [count_calls (calls)]];
+        auto result = parse (parser, input);
+        BOOST_CHECK_EQUAL (calls, 4);
+        BOOST_CHECK (success (result));
+        std::vector <int> o = output (std::move (result));
+        BOOST_CHECK_EQUAL (calls, 4);
+        BOOST_CHECK_EQUAL (o.size(), 4u);
+        BOOST_CHECK_EQUAL (o.front(), 1);
+        BOOST_CHECK_EQUAL (o.back(), 4);
+    }
+    {
+        // Minimum and maximum.
+        auto parser = fuzz (collect <std::string>() [
+            parse_ll::repeat (2, 3) [char_ - parse_ll::literal ('3')]]);
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (output (result), "12");
+        BOOST_CHECK_EQUAL (range::first (rest (result)), '3');
+
+        BOOST_CHECK (!success (parse (parser, std::string ("13"))));
+        BOOST_CHECK_EQUAL (output (parse (parser, input.substr (3))), "4a");
+
+        auto parser_2 = collect <std::string>() [+char_];
+        BOOST_CHECK (!success (parse (parser_2, std::string())));
+    }
+    {
+        // Skip parser between elements, but not after.
+        auto parser = parse_ll::skip (parse_ll::horizontal_space) [
+            collect <std::list <char>>() [*char_ ('a')]];
+        std::string spaced_input ("a a  a b");
+        auto result = parse (parser, spaced_input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (output (result).size(), 3u);
+        BOOST_CHECK_EQUAL (range::first (rest (result)), ' ');
+    }
+    {
+        auto parser = collect <std::set <char>>() [*char_];
+        auto result = parse (parser, std::string ("abcab"));
+        BOOST_CHECK_EQUAL (output (result).size(), 3u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_collect_allocator) {
+    using parse_ll::parse;
+    using parse_ll::output;
+    using parse_ll::collect;
+    using parse_ll::char_;
+
+    typedef std::vector <char, counting_allocator <char>> vector_type;
+    std::string input (1000, 'x');
+    {
+        int allocations = 0;
+        auto parser = collect <vector_type> (
+            counting_allocator <char> (allocations)) [*char_];
+        vector_type o = output (parse (parser, input));
+        BOOST_CHECK_EQUAL (o.size(), 1000u);
+        BOOST_CHECK (allocations > 1);
+    }
+    {
+        // With a size hint, only one allocation is necessary.
+        int allocations = 0;
+        auto parser = collect <vector_type> (
+            counting_allocator <char> (allocations)).reserve (1000) [*char_];
+        vector_type o = output (parse (parser, input));
+        BOOST_CHECK_EQUAL (o.size(), 1000u);
+        BOOST_CHECK_EQUAL (allocations, 1);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test compiled_grammar, also from multiple threads.
+*/
+
+#define BOOST_TEST_MODULE compiled_grammar
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/compiled_grammar.hpp"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <type_traits>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/char.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/alternative.hpp"
+#include "parse_ll/core/list.hpp"
+#include "parse_ll/core/rule.hpp"
+#include "parse_ll/core/skip.hpp"
+#include "parse_ll/core/whitespace.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_compiled_grammar)
+
+typedef range::result_of <range::callable::view (std::string const &)>::type
+    input_type;
+
+parse_ll::rule <input_type, std::vector <char>> make_grammar() {
+    parse_ll::rule <input_type, char> letter
+        = parse_ll::char_ ('a') | parse_ll::char_ ('b');
+    return parse_ll::skip (parse_ll::horizontal_space) [
+        letter % parse_ll::literal (',')];
+}
+
+BOOST_AUTO_TEST_CASE (test_compiled_grammar) {
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+
+    static_assert (!std::is_copy_constructible <
+        parse_ll::compiled_grammar <decltype (make_grammar())>>::value,
+        "A compiled grammar should not be copied.");
+
+    auto grammar = parse_ll::compile (make_grammar());
+
+    std::string const input ("a, b ,a,c");
+    auto outcome = grammar.parse (input);
+    BOOST_CHECK (success (outcome));
+    std::vector <char> expected {'a', 'b', 'a'};
+    BOOST_CHECK (output (outcome) == expected);
+    BOOST_CHECK_EQUAL (range::first (rest (outcome)), ',');
+
+    outcome = grammar.parse (parse_ll::parse_policy::direct(), input);
+    BOOST_CHECK (success (outcome));
+
+    std::string const wrong ("c");
+    BOOST_CHECK (!success (grammar.parse (wrong)));
+
+    // Move.
+    auto moved = std::move (grammar);
+    BOOST_CHECK (success (moved.parse (input)));
+}
+
+BOOST_AUTO_TEST_CASE (test_compiled_grammar_threads) {
+    auto const grammar = parse_ll::compile (make_grammar());
+    std::string const input ("a,b, a ,b,b,a,a");
+    std::vector <char> const expected {'a', 'b', 'a', 'b', 'b', 'a', 'a'};
+
+    // Each thread parses repeatedly and counts the correct outcomes.
+    int const thread_num = 8;
+    int const repetition_num = 1000;
+    std::vector <int> correct (thread_num, 0);
+    std::vector <std::thread> threads;
+    for (int thread_index = 0; thread_index != thread_num; ++ thread_index)
+        threads.emplace_back ([&, thread_index]() {
+            for (int i = 0; i != repetition_num; ++ i) {
+                auto outcome = grammar.parse (input);
+                if (parse_ll::success (outcome)
+                        && parse_ll::output (outcome) == expected
+                        && range::empty (parse_ll::rest (outcome)))
+                    ++ correct [thread_index];
+            }
+        });
+    for (auto & thread : threads)
+        thread.join();
+
+    for (int count : correct)
+        BOOST_CHECK_EQUAL (count, repetition_num);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
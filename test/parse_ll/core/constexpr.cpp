@@ -0,0 +1,75 @@
+/*
+Copyright 2012 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test that parsers can be constructed in constant expressions.
+*/
+
+#define BOOST_TEST_MODULE constexpr_parser
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core.hpp"
+
+#include <string>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+// Grammars that are initialised at compile time.
+constexpr auto keyword = parse_ll::literal ('k')
+    >> parse_ll::repeat (2) [parse_ll::char_ ('e')];
+constexpr auto list = parse_ll::skip (parse_ll::horizontal_space) [
+    parse_ll::char_ >> *(parse_ll::literal (',') >> parse_ll::char_)];
+constexpr auto sign = parse_ll::literal ('-') [parse_ll::constant (-1)]
+    | parse_ll::nothing [parse_ll::constant (+1)];
+
+PARSE_LL_DEFINE_CONSTEXPR_NAMED_PARSER (letters,
+    parse_ll::no_skip [+(parse_ll::char_ - parse_ll::one_whitespace)]);
+
+BOOST_AUTO_TEST_SUITE(test_parse_constexpr)
+
+BOOST_AUTO_TEST_CASE (test_constexpr_parser) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+
+    {
+        std::string input ("kee!");
+        auto outcome = parse (keyword, input);
+        BOOST_CHECK (success (outcome));
+        BOOST_CHECK_EQUAL (range::first (rest (outcome)), '!');
+        BOOST_CHECK (!success (parse (keyword, std::string ("ke"))));
+    }
+    {
+        std::string input ("a, b ,c");
+        auto outcome = parse (list, input);
+        BOOST_CHECK (success (outcome));
+        BOOST_CHECK (range::empty (rest (outcome)));
+    }
+    {
+        BOOST_CHECK_EQUAL (output (parse (sign, std::string ("-"))), -1);
+        BOOST_CHECK_EQUAL (output (parse (sign, std::string ("+"))), +1);
+    }
+    {
+        std::string input ("abc def");
+        auto outcome = parse (letters, input);
+        BOOST_CHECK (success (outcome));
+        BOOST_CHECK_EQUAL (range::first (rest (outcome)), ' ');
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test counted parser.
+*/
+
+#define BOOST_TEST_MODULE counted_parser
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/counted.hpp"
+
+#include <string>
+#include <vector>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/char.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/skip.hpp"
+#include "parse_ll/core/transform.hpp"
+#include "parse_ll/core/whitespace.hpp"
+
+#include "../helper/fuzz_parser.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_counted)
+
+// Interpret a character as a digit, where '-' is -1.
+struct to_count {
+    int operator() (char c) const { return c == '-' ? -1 : c - '0'; }
+};
+
+BOOST_AUTO_TEST_CASE (test_counted) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+    using parse_ll::counted;
+    using parse_ll::char_;
+
+    auto count = char_ [to_count()];
+    {
+        auto parser = fuzz (counted (count) [char_]);
+        BOOST_CHECK (!success (parse (parser, std::string())));
+
+        std::string input ("3abcd");
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK (output (result) == std::vector <char> ({'a', 'b', 'c'}));
+        BOOST_CHECK_EQUAL (output (result).capacity(), 3u);
+        BOOST_CHECK_EQUAL (range::first (rest (result)), 'd');
+
+        // Too few items.
+        BOOST_CHECK (!success (parse (parser, std::string ("3ab"))));
+        // Negative count.
+        BOOST_CHECK (!success (parse (parser, std::string ("-ab"))));
+
+        std::string empty_input ("0a");
+        auto empty_result = parse (parser, empty_input);
+        BOOST_CHECK (success (empty_result));
+        BOOST_CHECK (output (empty_result).empty());
+        BOOST_CHECK_EQUAL (range::first (rest (empty_result)), 'a');
+    }
+    {
+        // Void output.
+        auto parser = counted (count) [parse_ll::literal ('a')];
+        std::string input ("2aaa");
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (range::first (rest (result)), 'a');
+        BOOST_CHECK (!success (parse (parser, std::string ("2ab"))));
+    }
+    {
+        // The skip parser is used after the count and between the items.
+        auto parser = parse_ll::skip (parse_ll::horizontal_space) [
+            counted (count) [char_]];
+        std::string input ("2 a  b c");
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK (output (result) == std::vector <char> ({'a', 'b'}));
+        BOOST_CHECK_EQUAL (range::first (rest (result)), ' ');
+    }
+}
+
+// A count from the input that does not fit in memory.
+struct huge_count {
+    std::size_t operator() () const { return std::size_t (-1) / 2; }
+};
+
+struct count_5000 {
+    std::size_t operator() () const { return 5000; }
+};
+
+BOOST_AUTO_TEST_CASE (test_counted_huge) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::counted;
+    using parse_ll::char_;
+    using parse_ll::literal;
+
+    // Space is not reserved for all items at once, so this just fails.
+    auto parser = counted (literal ('x') [huge_count()]) [char_];
+    BOOST_CHECK (!success (parse (parser, std::string ("xabc"))));
+
+    // Beyond the space reserved, the vector grows.
+    auto long_parser = counted (literal ('x') [count_5000()]) [char_];
+    std::string input = "x" + std::string (5000, 'a');
+    auto result = parse (long_parser, input);
+    BOOST_CHECK (success (result));
+    BOOST_CHECK_EQUAL (output (result).size(), 5000u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test fixed_repeat parser.
+*/
+
+#define BOOST_TEST_MODULE fixed_repeat_parser
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/fixed_repeat.hpp"
+
+#include <string>
+#include <array>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/char.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/sequence.hpp"
+#include "parse_ll/core/skip.hpp"
+#include "parse_ll/core/whitespace.hpp"
+
+#include "../helper/fuzz_parser.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_fixed_repeat)
+
+BOOST_AUTO_TEST_CASE (test_fixed_repeat) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+    using parse_ll::fixed_repeat;
+    using parse_ll::char_;
+
+    std::string input ("abcd");
+    {
+        auto parser = fuzz (fixed_repeat <3>() [char_]);
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        std::array <char, 3> expected = {{'a', 'b', 'c'}};
+        BOOST_CHECK (output (result) == expected);
+        BOOST_CHECK_EQUAL (range::first (rest (result)), 'd');
+
+        BOOST_CHECK (!success (parse (parser, std::string ("ab"))));
+    }
+    {
+        auto parser = fixed_repeat <0>() [char_];
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (output (result).size(), 0u);
+        BOOST_CHECK_EQUAL (range::first (rest (result)), 'a');
+    }
+    {
+        // Void output.
+        auto parser = fixed_repeat <2>() [parse_ll::literal ('a')];
+        std::string repeated ("aab");
+        auto result = parse (parser, repeated);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (range::first (rest (result)), 'b');
+        BOOST_CHECK (!success (parse (parser, input)));
+    }
+    {
+        // Dotted quad-like: the skip parser is used between elements only.
+        auto parser = parse_ll::skip (parse_ll::literal ('.')) [
+            fixed_repeat <4>() [char_]];
+        std::string dotted ("1.2.3.4.");
+        auto result = parse (parser, dotted);
+        BOOST_CHECK (success (result));
+        std::array <char, 4> expected = {{'1', '2', '3', '4'}};
+        BOOST_CHECK (output (result) == expected);
+        BOOST_CHECK_EQUAL (range::first (rest (result)), '.');
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
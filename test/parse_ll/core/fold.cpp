@@ -0,0 +1,109 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test fold parser.
+*/
+
+#define BOOST_TEST_MODULE fold_parser
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/fold.hpp"
+
+#include <string>
+#include <algorithm>
+#include <functional>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/char.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/skip.hpp"
+#include "parse_ll/core/transform.hpp"
+#include "parse_ll/core/whitespace.hpp"
+
+#include "../helper/fuzz_parser.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_fold)
+
+struct to_digit {
+    int & calls;
+    explicit to_digit (int & calls) : calls (calls) {}
+
+    int operator() (char c) const { ++ calls; return c - '0'; }
+};
+
+struct maximum {
+    char operator() (char current, char c) const
+    { return std::max (current, c); }
+};
+
+struct count {
+    int operator() (int current) const { return current + 1; }
+};
+
+BOOST_AUTO_TEST_CASE (test_fold) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+    using parse_ll::fold;
+    using parse_ll::char_;
+
+    {
+        // The sub-parser is run once per element.
+        int calls = 0;
+        auto parser = fold (0, std::plus <int>()) [
+            *parse_ll::char_parser <parse_ll::match_any>() [to_digit (calls)]];
+        std::string input ("1234");
+        auto result = parse (parser, input);
+        BOOST_CHECK_EQUAL (calls, 4);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (output (result), 10);
+        BOOST_CHECK_EQUAL (calls, 4);
+        BOOST_CHECK (range::empty (rest (result)));
+    }
+    {
+        auto parser = fuzz (fold ('\0', maximum()) [+char_]);
+        BOOST_CHECK (!success (parse (parser, std::string())));
+        BOOST_CHECK_EQUAL (output (parse (parser, std::string ("acb"))), 'c');
+
+        auto bounded = fold ('\0', maximum()) [parse_ll::repeat (2, 3) [char_]];
+        BOOST_CHECK (!success (parse (bounded, std::string ("a"))));
+        std::string input ("azby");
+        auto result = parse (bounded, input);
+        BOOST_CHECK_EQUAL (output (result), 'z');
+        BOOST_CHECK_EQUAL (range::first (rest (result)), 'y');
+    }
+    {
+        // Void output: the operation is called with only the state.
+        auto parser = parse_ll::skip (parse_ll::space) [
+            fold (0, count()) [*parse_ll::literal ('a')]];
+        std::string input ("a a ab");
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (output (result), 3);
+        BOOST_CHECK_EQUAL (range::first (rest (result)), 'b');
+
+        std::string empty_input (" a");
+        auto empty_result = parse (parser, empty_input);
+        BOOST_CHECK_EQUAL (output (empty_result), 0);
+        BOOST_CHECK_EQUAL (range::first (rest (empty_result)), ' ');
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
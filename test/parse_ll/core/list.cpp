@@ -0,0 +1,112 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test list parser.
+*/
+
+#define BOOST_TEST_MODULE list_parser
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/list.hpp"
+
+#include <string>
+#include <vector>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/char.hpp"
+#include "parse_ll/core/difference.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/skip.hpp"
+#include "parse_ll/core/transform.hpp"
+#include "parse_ll/core/whitespace.hpp"
+
+#include "../helper/fuzz_parser.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_list)
+
+struct count_calls {
+    int & calls;
+    explicit count_calls (int & calls) : calls (calls) {}
+
+    char operator() (char c) const { ++ calls; return c; }
+};
+
+BOOST_AUTO_TEST_CASE (test_list) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+    using parse_ll::char_;
+    using parse_ll::literal;
+
+    auto letter = char_ - literal (',') - literal (';');
+    {
+        auto parser = fuzz (letter % literal (','));
+        BOOST_CHECK (!success (parse (parser, std::string())));
+        BOOST_CHECK (!success (parse (parser, std::string (","))));
+
+        std::string input ("a,b,c;");
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK (output (result) == std::vector <char> ({'a', 'b', 'c'}));
+        BOOST_CHECK_EQUAL (range::first (rest (result)), ';');
+    }
+    {
+        // A trailing separator is not consumed.
+        auto parser = letter % literal (',');
+        std::string input ("a,b,");
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (output (result).size(), 2u);
+        BOOST_CHECK_EQUAL (range::first (rest (result)), ',');
+    }
+    {
+        // Each element is parsed exactly once.
+        int calls = 0;
+        auto parser = letter [count_calls (calls)] % literal (',');
+        std::string input ("a,b,c,d");
+        auto result = parse (parser, input);
+        BOOST_CHECK_EQUAL (calls, 4);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK (range::empty (rest (result)));
+        std::vector <char> o = output (std::move (result));
+        BOOST_CHECK_EQUAL (o.size(), 4u);
+        BOOST_CHECK_EQUAL (calls, 4);
+    }
+    {
+        // Void output.
+        auto parser = literal ('a') % literal (',');
+        std::string input ("a,a,b");
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (range::first (rest (result)), ',');
+    }
+    {
+        // The skip parser is used around the separators, but not at the end.
+        auto parser = parse_ll::skip (parse_ll::horizontal_space) [
+            letter % literal (',')];
+        std::string input ("a , b,c ;");
+        auto result = parse (parser, input);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK (output (result) == std::vector <char> ({'a', 'b', 'c'}));
+        BOOST_CHECK_EQUAL (range::first (rest (result)), ' ');
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
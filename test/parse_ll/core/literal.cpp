@@ -33,6 +33,14 @@ Test literal_parser.
 
 BOOST_AUTO_TEST_SUITE(test_parse_literal_parser)
 
+// An integer argument means a char; only char32_t means a code point.
+static_assert (std::is_same <decltype (parse_ll::literal (0x41)),
+    parse_ll::literal_parser <char>>::value, "");
+static_assert (std::is_same <decltype (parse_ll::literal ('A')),
+    parse_ll::literal_parser <char>>::value, "");
+static_assert (std::is_same <decltype (parse_ll::literal (U'A')),
+    parse_ll::literal_parser <char32_t>>::value, "");
+
 BOOST_AUTO_TEST_CASE (test_literal) {
     using range::empty; using range::first; using range::drop;
 
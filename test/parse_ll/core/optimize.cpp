@@ -0,0 +1,244 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test optimize(), which rewrites parser expressions.
+*/
+
+#define BOOST_TEST_MODULE optimize
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/optimize.hpp"
+
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core/char.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/whitespace.hpp"
+#include "parse_ll/core/compiled_grammar.hpp"
+#include "parse_ll/support/utf8_range.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_optimize)
+
+using parse_ll::char_;
+using parse_ll::literal;
+using parse_ll::no_skip;
+using parse_ll::skip;
+
+struct to_int {
+    int operator() (char c) const { return c; }
+};
+
+struct add_one {
+    int operator() (int i) const { return i + 1; }
+};
+
+struct forty_two {
+    int operator() () const { return 42; }
+};
+
+struct count_calls {
+    int * calls;
+    void operator() (char) const { ++ * calls; }
+};
+
+/**
+Check that parser and optimised have the same outcome on all inputs.
+*/
+template <class Parser, class Optimised,
+        class Inputs = std::vector <std::string>>
+    void check_same_void (Parser const & parser, Optimised const & optimised,
+        Inputs const & inputs)
+{
+    for (auto const & input : inputs) {
+        auto expected = parse_ll::parse (parser, input);
+        auto outcome = parse_ll::parse (optimised, input);
+        BOOST_CHECK_EQUAL (parse_ll::success (outcome),
+            parse_ll::success (expected));
+        if (parse_ll::success (expected))
+            BOOST_CHECK (parse_ll::rest (outcome) == parse_ll::rest (expected));
+    }
+}
+
+template <class Parser, class Optimised,
+        class Inputs = std::vector <std::string>>
+    void check_same (Parser const & parser, Optimised const & optimised,
+        Inputs const & inputs)
+{
+    check_same_void (parser, optimised, inputs);
+    for (auto const & input : inputs) {
+        auto expected = parse_ll::parse (parser, input);
+        auto outcome = parse_ll::parse (optimised, input);
+        if (parse_ll::success (expected))
+            BOOST_CHECK (parse_ll::output (outcome)
+                == parse_ll::output (expected));
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_optimize_literal) {
+    auto parser = literal ('a') >> literal ("bc") >> literal ('d');
+    auto optimised = parse_ll::optimize (parser);
+    static_assert (std::is_same <decltype (optimised),
+        parse_ll::literal_parser <std::string>>::value, "");
+    BOOST_CHECK_EQUAL (optimised.literal, "abcd");
+    check_same_void (parser, optimised, {"", "abc", "abcd", "abcde", "abd"});
+
+    // With an expectation, the position of the error is different.
+    auto expect_parser = literal ('a') > literal ('b');
+    static_assert (std::is_same <
+        decltype (parse_ll::optimize (expect_parser)),
+        decltype (expect_parser)>::value, "");
+
+    // With a skip parser, the literals must not be merged.
+    auto skip_parser = skip (parse_ll::space) [literal ('a') >> literal ('b')];
+    static_assert (std::is_same <decltype (parse_ll::optimize (skip_parser)),
+        decltype (skip_parser)>::value, "");
+    // ... unless skipping is switched off.
+    auto no_skip_parser =
+        skip (parse_ll::space) [no_skip [literal ('a') >> literal ('b')]];
+    auto optimised_no_skip = parse_ll::optimize (no_skip_parser);
+    static_assert (!std::is_same <decltype (optimised_no_skip),
+        decltype (no_skip_parser)>::value, "");
+    check_same_void (no_skip_parser, optimised_no_skip,
+        {"ab", " ab ", "a b", "b"});
+
+    // optimize_any_policy does not assume that no skip parser is active.
+    static_assert (std::is_same <
+        decltype (parse_ll::optimize_any_policy (parser)),
+        decltype (parser)>::value, "");
+}
+
+BOOST_AUTO_TEST_CASE (test_optimize_char_class) {
+    auto parser = literal (' ') | literal ('\t') | literal ('\n');
+    auto optimised = parse_ll::optimize (parser);
+    static_assert (std::is_same <decltype (optimised),
+        parse_ll::one_of_parser>::value, "");
+    check_same_void (parser, optimised, {"", " ", "\t", "\n", "a", "  "});
+
+    auto whitespace = parse_ll::optimize (parse_ll::whitespace);
+    static_assert (std::is_same <decltype (whitespace),
+        parse_ll::repeat_parser <parse_ll::one_of_parser>>::value, "");
+    check_same_void (parse_ll::whitespace, whitespace,
+        {"", " \t\r\n a", "a", "\t\t"});
+
+    auto digit = char_ ('0') | char_ ('1') | char_ ('2');
+    auto optimised_digit = parse_ll::optimize (digit);
+    static_assert (std::is_same <decltype (optimised_digit),
+        parse_ll::char_parser <parse_ll::char_class>>::value, "");
+    check_same (digit, optimised_digit, {"", "0", "12", "3", "a"});
+
+    // Different output types: not merged.
+    auto mixed = char_ ('a') | literal ('b');
+    static_assert (std::is_same <decltype (parse_ll::optimize (mixed)),
+        decltype (mixed)>::value, "");
+
+    auto not_quote = char_ - (literal ('"') | literal ('\\'));
+    auto optimised_not_quote = parse_ll::optimize (not_quote);
+    static_assert (std::is_same <decltype (optimised_not_quote),
+        parse_ll::char_parser <parse_ll::char_class_fallback <
+            parse_ll::match_any>>>::value, "");
+    check_same (not_quote, optimised_not_quote,
+        {"", "a", "\"", "\\", "\xe9", std::string (1, '\0')});
+
+    auto not_letter = *(char_ - char_ ('a'));
+    check_same_void (not_letter, parse_ll::optimize (not_letter),
+        {"", "bcd", "bad", "a"});
+}
+
+// Characters that do not fit in a char are treated as before.
+BOOST_AUTO_TEST_CASE (test_optimize_wide) {
+    auto not_quote = char_ - literal ('"');
+    auto optimised_not_quote = parse_ll::optimize (not_quote);
+    std::vector <std::wstring> const wide {
+        L"", L"a", L"\"", L"\xe9", L"\x4e2d", L"\x4e2d\"", L"\x10ffff"};
+    check_same (not_quote, optimised_not_quote, wide);
+
+    auto not_a = char_ ('a') - literal ('"');
+    check_same (not_a, parse_ll::optimize (not_a), wide);
+
+    auto letters = literal ('a') | literal ('b') | literal ('"');
+    check_same_void (letters, parse_ll::optimize (letters), wide);
+
+    auto digits = char_ ('0') | (char_ ('1') - literal ('1'));
+    check_same (digits, parse_ll::optimize (digits), wide);
+
+    std::string const text ("\xe4\xb8\xad\"");
+    range::utf8_range code_points (text);
+    auto outcome = parse_ll::parse (optimised_not_quote, code_points);
+    BOOST_REQUIRE (parse_ll::success (outcome));
+    BOOST_CHECK (parse_ll::output (outcome) == U'\x4e2d');
+    BOOST_CHECK_EQUAL (parse_ll::rest (outcome).offset(), 3u);
+
+    auto compiled = parse_ll::compile (*not_quote >> literal (U'"'));
+    auto compiled_outcome = compiled.parse (code_points);
+    BOOST_CHECK (parse_ll::success (compiled_outcome));
+    BOOST_CHECK (range::empty (parse_ll::rest (compiled_outcome)));
+}
+
+BOOST_AUTO_TEST_CASE (test_optimize_transform) {
+    auto parser = char_ [to_int()] [add_one()];
+    auto optimised = parse_ll::optimize (parser);
+    static_assert (std::is_same <decltype (optimised),
+        parse_ll::transform_parser <parse_ll::char_parser <parse_ll::match_any>,
+            parse_ll::optimize_detail::composed_actor <to_int, add_one>>
+        >::value, "");
+    check_same (parser, optimised, {"", "a", "bc"});
+
+    auto void_parser = literal ('a') [forty_two()] [add_one()];
+    check_same (void_parser, parse_ll::optimize (void_parser),
+        {"", "a", "b"});
+
+    int calls = 0;
+    auto void_actor = char_ [count_calls {&calls}] [forty_two()];
+    auto optimised_void_actor = parse_ll::optimize (void_actor);
+    std::string a ("a");
+    auto outcome = parse_ll::parse (optimised_void_actor, a);
+    BOOST_CHECK_EQUAL (parse_ll::output (outcome), 42);
+    BOOST_CHECK_EQUAL (calls, 1);
+}
+
+BOOST_AUTO_TEST_CASE (test_optimize_nested) {
+    // The rewrites go through repeat, optional, list, and sequence.
+    auto parser = +(char_ ('a') | char_ ('b'))
+        >> -(literal ('x') >> literal ('y'))
+        >> ((literal ('c') | literal ('d')) % literal (','));
+    auto optimised = parse_ll::optimize (parser);
+    check_same_void (parser, optimised,
+        {"", "ab", "abxyc", "bad,c,d", "axc", "xyc", "ab,c"});
+
+    auto compiled = parse_ll::compile (parser);
+    std::string input ("abxyc,d");
+    auto outcome = compiled.parse (input);
+    BOOST_CHECK (parse_ll::success (outcome));
+    BOOST_CHECK (range::empty (parse_ll::rest (outcome)));
+
+    // A compiled grammar can still be used with a skip parser.
+    auto spaced = parse_ll::compile (literal ('a') >> literal ('b'));
+    auto space = parse_ll::one_of (" ");
+    parse_ll::parse_policy::skip_policy <
+        parse_ll::one_of_parser, parse_ll::parse_policy::direct> policy (
+            space, parse_ll::parse_policy::direct());
+    std::string spaced_input ("a b");
+    auto skip_outcome = spaced.parse (policy, spaced_input);
+    BOOST_CHECK (parse_ll::success (skip_outcome));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
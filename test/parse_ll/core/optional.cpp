@@ -30,6 +30,7 @@ Test optional parser.
 
 #include "parse_ll/core/char.hpp"
 #include "parse_ll/core/nothing.hpp"
+#include "parse_ll/core/transform.hpp"
 #include "../helper/fuzz_parser.hpp"
 
 BOOST_AUTO_TEST_SUITE(test_parse_optional)
@@ -81,5 +82,48 @@ BOOST_AUTO_TEST_CASE (test_optional) {
     }
 }
 
+/**
+Actor that counts how often it is called.
+*/
+struct count_calls {
+    int * count;
+    count_calls (int & count) : count (&count) {}
+
+    char operator() (char c) const {
+        ++ *count;
+        return c;
+    }
+};
+
+BOOST_AUTO_TEST_CASE (test_optional_lazy) {
+    using range::first;
+
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+    using parse_ll::rest;
+
+    std::string r ("ab");
+    int count = 0;
+    {
+        auto parser = -parse_ll::char_ ('a') [count_calls (count)];
+        auto result = parse (parser, r);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (first (rest (result)), 'b');
+        // The output of the sub-parser has not been produced.
+        BOOST_CHECK_EQUAL (count, 0);
+        BOOST_CHECK_EQUAL (output (result).get(), 'a');
+        BOOST_CHECK_EQUAL (count, 1);
+    }
+    {
+        auto parser = -parse_ll::char_ ('b') [count_calls (count)];
+        auto result = parse (parser, r);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (first (rest (result)), 'a');
+        BOOST_CHECK (!output (result));
+        BOOST_CHECK_EQUAL (count, 1);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,116 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Report the size of outcomes of various grammars, and check that they stay
+within bounds.
+Outcomes are kept on the stack and copied around, so their size matters.
+Run with --log_level=message to see the sizes.
+*/
+
+#define BOOST_TEST_MODULE outcome_size
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core.hpp"
+
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_outcome_size)
+
+/**
+\return The size of the outcome of parser on input, after reporting it.
+*/
+template <class Parser, class Input>
+    std::size_t outcome_size (const char * name,
+        Parser const & parser, Input const & input)
+{
+    std::size_t size = sizeof (parse_ll::parse (parser, input));
+    BOOST_MESSAGE ("Outcome of " << name << ": " << size << " bytes");
+    return size;
+}
+
+struct to_int {
+    int operator() (char c) const { return c; }
+};
+
+BOOST_AUTO_TEST_CASE (test_outcome_size) {
+    using parse_ll::char_;
+    using parse_ll::literal;
+
+    std::string input ("abc");
+    typedef decltype (range::view (input)) view_type;
+
+    std::size_t char_size = outcome_size ("char_", char_, input);
+    std::size_t literal_size = outcome_size ("literal", literal ('a'), input);
+    BOOST_CHECK (char_size <= sizeof (boost::optional <view_type>));
+    BOOST_CHECK (literal_size <= sizeof (boost::optional <view_type>));
+
+    // A sequence does not keep a copy of the input.
+    std::size_t char_char_size = outcome_size (
+        "char_ >> char_", char_ >> char_, input);
+    BOOST_CHECK (char_char_size <= char_size
+        + sizeof (boost::optional <parse_ll::char_outcome <view_type>>));
+
+    // A sequence drops the outcome of a first parser with void output.
+    std::size_t literal_char_size = outcome_size (
+        "literal >> char_", literal ('a') >> char_, input);
+    BOOST_CHECK (literal_char_size < literal_size + char_char_size - char_size);
+
+    // The default policy takes up no space.
+    std::size_t repeat_size = outcome_size ("*char_", *char_, input);
+    BOOST_CHECK_EQUAL (repeat_size, sizeof (view_type)
+        + sizeof (decltype (*char_) const *));
+
+    outcome_size ("-char_", -char_, input);
+    outcome_size ("char_ ('a') | char_", char_ ('a') | char_, input);
+    outcome_size ("char_ - literal", char_ - literal ('a'), input);
+    outcome_size ("char_ [actor]", char_ [to_int()], input);
+    outcome_size ("whitespace", parse_ll::whitespace, input);
+    outcome_size ("newline", parse_ll::newline, input);
+    outcome_size ("skip (space) [*(char_ >> char_)]",
+        parse_ll::skip (parse_ll::space) [*(char_ >> char_)], input);
+    outcome_size ("no_skip [char_ >> +char_]",
+        parse_ll::no_skip [char_ >> +char_], input);
+}
+
+// Policies are copied into lazy outcomes, so they should be handles.
+BOOST_AUTO_TEST_CASE (test_policy_size) {
+    typedef parse_ll::parse_policy::skip_policy <
+        decltype (parse_ll::whitespace), parse_ll::parse_policy::direct>
+        skip_policy;
+    BOOST_CHECK_EQUAL (sizeof (skip_policy), sizeof (void *));
+
+    typedef parse_ll::parse_policy::no_skip_policy <skip_policy>
+        no_skip_policy;
+    BOOST_CHECK_EQUAL (sizeof (no_skip_policy), sizeof (void *));
+
+    // A repeat outcome holds the policy, the parser, and the input.
+    std::string input ("a b");
+    auto repeat_parser = *parse_ll::char_;
+    skip_policy policy (parse_ll::whitespace, parse_ll::parse_policy::direct());
+    std::size_t repeat_size = sizeof (
+        parse_ll::parse (policy, repeat_parser, input));
+    BOOST_CHECK_EQUAL (repeat_size, sizeof (void *)
+        + sizeof (decltype (repeat_parser) const *)
+        + sizeof (decltype (range::view (input))));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,154 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test the compile-time properties of parsers, and how combinators use them.
+Repetitions of parsers that may be empty are rejected at compile time, which
+cannot be tested here.
+*/
+
+#define BOOST_TEST_MODULE properties
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core.hpp"
+
+#include <string>
+#include <type_traits>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_properties)
+
+using parse_ll::char_;
+using parse_ll::literal;
+using parse_ll::nothing;
+using parse_ll::end;
+
+template <class Parser> struct properties {
+    typedef typename std::decay <Parser>::type parser_type;
+    static constexpr bool always_succeeds
+        = parse_ll::always_succeeds <parser_type>::value;
+    static constexpr bool never_consumes
+        = parse_ll::never_consumes <parser_type>::value;
+    static constexpr bool may_be_empty
+        = parse_ll::may_be_empty <parser_type>::value;
+};
+
+struct to_int {
+    int operator() (char c) const { return c; }
+};
+
+BOOST_AUTO_TEST_CASE (test_properties) {
+    typedef properties <decltype (char_)> char_properties;
+    static_assert (!char_properties::always_succeeds, "");
+    static_assert (!char_properties::never_consumes, "");
+    static_assert (!char_properties::may_be_empty, "");
+
+    typedef properties <decltype (nothing)> nothing_properties;
+    static_assert (nothing_properties::always_succeeds, "");
+    static_assert (nothing_properties::never_consumes, "");
+    static_assert (nothing_properties::may_be_empty, "");
+
+    typedef properties <decltype (end)> end_properties;
+    static_assert (!end_properties::always_succeeds, "");
+    static_assert (end_properties::never_consumes, "");
+    static_assert (end_properties::may_be_empty, "");
+
+    typedef properties <decltype (-char_)> optional_properties;
+    static_assert (optional_properties::always_succeeds, "");
+    static_assert (!optional_properties::never_consumes, "");
+    static_assert (optional_properties::may_be_empty, "");
+
+    static_assert (properties <decltype (-char_ >> -char_)>::may_be_empty, "");
+    static_assert (!properties <decltype (-char_ >> char_)>::may_be_empty, "");
+    static_assert (properties <decltype (char_ | nothing)>::always_succeeds,
+        "");
+    static_assert (!properties <decltype (char_ | end)>::always_succeeds, "");
+    static_assert (properties <decltype (char_ | end)>::may_be_empty, "");
+    static_assert (properties <decltype ((-char_) [to_int()])>
+        ::always_succeeds, "");
+    static_assert (properties <decltype (
+        parse_ll::skip (parse_ll::space) [-char_])>::may_be_empty, "");
+    static_assert (properties <decltype (parse_ll::no_skip [end])>
+        ::never_consumes, "");
+
+    // The minimum of a repeat_parser is only known at run time.
+    static_assert (!properties <decltype (*char_)>::may_be_empty, "");
+    static_assert (properties <decltype (*end)>::never_consumes, "");
+    static_assert (properties <decltype (parse_ll::fixed_repeat <0>() [char_])
+        >::always_succeeds, "");
+
+    // Rules are opaque.
+    typedef range::result_of <range::callable::view (std::string const &)
+        >::type input_type;
+    static_assert (!properties <parse_ll::rule <input_type>>::may_be_empty,
+        "");
+}
+
+BOOST_AUTO_TEST_CASE (test_sequence_always_succeeds) {
+    std::string input ("ab");
+    auto parser = -char_ ('a') >> -char_ ('c');
+    auto outcome = parse_ll::parse (parser, input);
+    static_assert (std::is_same <decltype (parse_ll::success (outcome)),
+        rime::true_type>::value, "");
+    // The outcome of the second parser is not kept in an optional.
+    static_assert (std::is_same <decltype (outcome.outcome_2),
+        decltype (parse_ll::parse (-char_ ('c'), input))>::value, "");
+    BOOST_CHECK_EQUAL (range::first (parse_ll::rest (outcome)), 'b');
+    BOOST_CHECK_EQUAL (*std::get <0> (parse_ll::output (outcome)), 'a');
+    BOOST_CHECK (!std::get <1> (parse_ll::output (outcome)));
+
+    // The second parser always succeeds, so only the first is checked.
+    auto parser_2 = char_ ('a') >> -char_ ('c');
+    BOOST_CHECK (parse_ll::success (parse_ll::parse (parser_2, input)));
+    BOOST_CHECK (!parse_ll::success (
+        parse_ll::parse (parser_2, std::string ("b"))));
+
+    // The first parser always succeeds, so only the second is checked.
+    auto parser_3 = -char_ ('a') >> char_ ('c');
+    std::string input_3 ("ac");
+    BOOST_CHECK (parse_ll::success (parse_ll::parse (parser_3, input_3)));
+    BOOST_CHECK (!parse_ll::success (parse_ll::parse (parser_3, input)));
+
+    // An expectation must still be checked.
+    auto expect_parser = -char_ ('a') > char_ ('c');
+    BOOST_CHECK_THROW (parse_ll::parse (expect_parser, input), parse_ll::error);
+}
+
+BOOST_AUTO_TEST_CASE (test_alternative_always_succeeds) {
+    std::string input ("ab");
+    auto parser = -char_ ('a') | -char_ ('b');
+    auto outcome = parse_ll::parse (parser, input);
+    static_assert (std::is_same <decltype (parse_ll::success (outcome)),
+        rime::true_type>::value, "");
+    BOOST_CHECK_EQUAL (*parse_ll::output (outcome), 'a');
+    BOOST_CHECK_EQUAL (range::first (parse_ll::rest (outcome)), 'b');
+
+    // The second parser is never tried.
+    std::string input_2 ("b");
+    auto outcome_2 = parse_ll::parse (parser, input_2);
+    BOOST_CHECK (!parse_ll::output (outcome_2));
+
+    auto variant_parser =
+        parse_ll::variant_alternative (nothing, char_ ('b'));
+    auto variant_outcome = parse_ll::parse (variant_parser, input);
+    BOOST_CHECK (parse_ll::success (variant_outcome));
+    BOOST_CHECK_EQUAL (parse_ll::output (variant_outcome).which(), 0);
+    BOOST_CHECK_EQUAL (range::first (parse_ll::rest (variant_outcome)), 'a');
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,230 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test static_rule.
+*/
+
+#define BOOST_TEST_MODULE static_rule
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/core/static_rule.hpp"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/bytecode.hpp"
+
+/*
+Rules must be defined at namespace scope, in the namespace of the rule.
+*/
+namespace static_rule_test {
+
+    using parse_ll::literal;
+    using parse_ll::fold;
+
+    struct add {
+        int operator() (int sum, int count) const { return sum + count; }
+    };
+    struct one { int operator() () const { return 1; } };
+    struct zero { int operator() () const { return 0; } };
+    struct first_plus_one {
+        int operator() (std::tuple <int> const & t) const
+        { return std::get <0> (t) + 1; }
+    };
+    struct first {
+        int operator() (std::tuple <int> const & t) const
+        { return std::get <0> (t); }
+    };
+
+    // S-expression; outputs the number of atoms in it.
+    struct sexpr : parse_ll::static_rule <sexpr, int> {};
+
+    PARSE_LL_DEFINE_STATIC_RULE (sexpr,
+        parse_ll::one_of ("abcd") [one()]
+        | (literal ('(') >> fold (0, add()) [*sexpr()] >> literal (')'))
+            [first()])
+
+    // The same, but it skips horizontal space inside the recursion.
+    struct spaced : parse_ll::static_rule <spaced, int> {};
+
+    PARSE_LL_DEFINE_STATIC_RULE (spaced,
+        parse_ll::skip (parse_ll::horizontal_space) [
+            parse_ll::one_of ("abcd") [one()]
+            | (literal ('(') >> fold (0, add()) [*spaced()]
+                >> literal (')')) [first()]])
+
+    // Mutual recursion: "a" followed by "b"s alternate.
+    struct a_then_b;
+    struct b_then_a;
+
+    struct a_then_b : parse_ll::static_rule <a_then_b> {};
+    struct b_then_a : parse_ll::static_rule <b_then_a> {};
+
+    PARSE_LL_DEFINE_STATIC_RULE (a_then_b,
+        literal ('a') >> -b_then_a())
+    PARSE_LL_DEFINE_STATIC_RULE (b_then_a,
+        literal ('b') >> -a_then_b())
+
+    typedef range::result_of <range::callable::view (std::string const &)
+        >::type input_type;
+
+    // Compiled separately, at the end of this file.
+    struct pairs : parse_ll::static_rule <pairs, int> {};
+
+} // namespace static_rule_test
+
+PARSE_LL_EXTERN_STATIC_RULE (static_rule_test::pairs,
+    parse_ll::parse_policy::direct, static_rule_test::input_type)
+
+BOOST_AUTO_TEST_SUITE(test_parse_static_rule)
+
+using static_rule_test::sexpr;
+using static_rule_test::spaced;
+using static_rule_test::a_then_b;
+
+template <class Input> std::size_t length (Input input) {
+    std::size_t result = 0;
+    for (; !range::empty (input); input = range::drop (input))
+        ++ result;
+    return result;
+}
+
+template <class Parser> void check_count (Parser const & parser,
+    std::string const & text, int count, std::size_t rest_size)
+{
+    auto outcome = parse_ll::parse (parser, text);
+    BOOST_CHECK (parse_ll::success (outcome));
+    if (parse_ll::success (outcome)) {
+        BOOST_CHECK_EQUAL (parse_ll::output (outcome), count);
+        BOOST_CHECK_EQUAL (length (parse_ll::rest (outcome)), rest_size);
+    }
+}
+
+template <class Parser>
+    void check_fail (Parser const & parser, std::string const & text)
+{ BOOST_CHECK (!parse_ll::success (parse_ll::parse (parser, text))); }
+
+BOOST_AUTO_TEST_CASE (test_static_rule) {
+    static_assert (std::is_empty <sexpr>::value,
+        "A static_rule should not contain anything.");
+
+    check_count (sexpr(), "a", 1, 0);
+    check_count (sexpr(), "ab", 1, 1);
+    check_count (sexpr(), "()", 0, 0);
+    check_count (sexpr(), "(ab(c(d)))", 4, 0);
+    check_count (sexpr(), "((a)(b))c", 2, 1);
+    check_fail (sexpr(), "");
+    check_fail (sexpr(), "(a");
+    check_fail (sexpr(), "(a(b)");
+    check_fail (sexpr(), ")");
+
+    // The input type is not fixed.
+    std::vector <char> characters {'(', 'a', '(', 'b', ')', ')'};
+    auto outcome = parse_ll::parse (sexpr(), characters);
+    BOOST_CHECK (parse_ll::success (outcome));
+    BOOST_CHECK_EQUAL (parse_ll::output (outcome), 2);
+
+    BOOST_CHECK_EQUAL (
+        std::string (parse_ll::describe (sexpr())), "static rule");
+}
+
+BOOST_AUTO_TEST_CASE (test_static_rule_skip) {
+    check_count (spaced(), "( a (b  c) )", 3, 0);
+    check_count (spaced(), "(a(b)) x", 2, 2);
+    check_fail (spaced(), "(a (b)");
+
+    // Outside a skip parser, sexpr does not skip.
+    auto skip_sexpr = parse_ll::skip (parse_ll::horizontal_space) [sexpr()];
+    check_count (skip_sexpr, "( a (b  c) )", 3, 0);
+    check_fail (sexpr(), "( a)");
+}
+
+BOOST_AUTO_TEST_CASE (test_static_rule_mutual) {
+    std::string text ("ababaxx");
+    auto outcome = parse_ll::parse (a_then_b(), text);
+    BOOST_CHECK (parse_ll::success (outcome));
+    BOOST_CHECK_EQUAL (length (parse_ll::rest (outcome)), 2u);
+    check_fail (a_then_b(), "b");
+}
+
+BOOST_AUTO_TEST_CASE (test_static_rule_bytecode) {
+    std::vector <std::string> texts {"", "a", "()", "(ab(c(d)))",
+        "((a)(b))c", "(a", "( a (b  c) )", "(a (b)", "ababaxx", "b"};
+
+    auto sexpr_program = parse_ll::bytecode::compile (sexpr());
+    auto spaced_program = parse_ll::bytecode::compile (spaced());
+    auto mutual_program = parse_ll::bytecode::compile (a_then_b());
+    for (auto const & text : texts) {
+        auto input = range::view (text);
+        {
+            auto outcome = parse_ll::parse (sexpr(), input);
+            auto result = parse_ll::bytecode::run (sexpr_program, input);
+            BOOST_CHECK_EQUAL (result.success, parse_ll::success (outcome));
+            if (result.success && parse_ll::success (outcome))
+                BOOST_CHECK_EQUAL (length (result.rest),
+                    length (parse_ll::rest (outcome)));
+        }
+        {
+            auto outcome = parse_ll::parse (spaced(), input);
+            auto result = parse_ll::bytecode::run (spaced_program, input);
+            BOOST_CHECK_EQUAL (result.success, parse_ll::success (outcome));
+            if (result.success && parse_ll::success (outcome))
+                BOOST_CHECK_EQUAL (length (result.rest),
+                    length (parse_ll::rest (outcome)));
+        }
+        {
+            auto outcome = parse_ll::parse (a_then_b(), input);
+            auto result = parse_ll::bytecode::run (mutual_program, input);
+            BOOST_CHECK_EQUAL (result.success, parse_ll::success (outcome));
+            if (result.success && parse_ll::success (outcome))
+                BOOST_CHECK_EQUAL (length (result.rest),
+                    length (parse_ll::rest (outcome)));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_static_rule_extern) {
+    using static_rule_test::pairs;
+    std::string text ("(()())()x");
+    auto outcome = parse_ll::parse (pairs(), range::view (text));
+    BOOST_CHECK (parse_ll::success (outcome));
+    BOOST_CHECK_EQUAL (parse_ll::output (outcome), 4);
+    BOOST_CHECK_EQUAL (length (parse_ll::rest (outcome)), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/*
+This would normally be in a different source file.
+*/
+namespace static_rule_test {
+
+    // Nested pairs of parentheses; outputs the number of pairs.
+    PARSE_LL_DEFINE_STATIC_RULE (pairs,
+        fold (0, add()) [+(literal ('(') >> pairs() >> literal (')'))
+            [first_plus_one()]]
+        | parse_ll::nothing [zero()])
+
+} // namespace static_rule_test
+
+PARSE_LL_INSTANTIATE_STATIC_RULE (static_rule_test::pairs,
+    parse_ll::parse_policy::direct, static_rule_test::input_type)
@@ -24,6 +24,7 @@ Test transform_parser.
 #include "parse_ll/core/transform.hpp"
 
 #include <string>
+#include <memory>
 
 #include "range/core.hpp"
 #include "range/std/container.hpp"
@@ -82,4 +83,86 @@ BOOST_AUTO_TEST_CASE (test_transform) {
     }
 }
 
+/**
+Actor that counts how often it is called.
+*/
+struct count_calls {
+    int * count;
+    count_calls (int & count) : count (&count) {}
+
+    std::string operator() (char c) const {
+        ++ *count;
+        return std::string (3, c);
+    }
+};
+
+/**
+Actor that reports whether it was able to move from its argument.
+*/
+struct report_move {
+    std::string operator() (std::string const & s) const
+    { return "copied " + s; }
+    std::string operator() (std::string && s) const
+    { return "moved " + s; }
+};
+
+BOOST_AUTO_TEST_CASE (test_transform_output_once) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+
+    std::string r ("ab");
+    int count = 0;
+    {
+        auto parser = parse_ll::char_ [count_calls (count)];
+        auto result = parse (parser, r);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (count, 0);
+        BOOST_CHECK_EQUAL (output (result), "aaa");
+        BOOST_CHECK_EQUAL (output (result), "aaa");
+        // The actor is only called once.
+        BOOST_CHECK_EQUAL (count, 1);
+    }
+    {
+        auto parser = parse_ll::char_ [count_calls (count)] [report_move()];
+        {
+            // The inner output is a copy of the cached output, which the
+            // outer actor can move from.
+            auto result = parse (parser, r);
+            BOOST_CHECK_EQUAL (output (result), "moved aaa");
+            BOOST_CHECK_EQUAL (output (result), "moved aaa");
+            BOOST_CHECK_EQUAL (count, 2);
+        }
+        {
+            // An rvalue outcome passes its sub-output as an rvalue.
+            auto result = parse (parser, r);
+            BOOST_CHECK_EQUAL (output (std::move (result)), "moved aaa");
+            BOOST_CHECK_EQUAL (count, 3);
+        }
+    }
+}
+
+/**
+Actor that returns an output that cannot be copied.
+*/
+struct make_unique {
+    std::unique_ptr <char> operator() (char c) const
+    { return std::unique_ptr <char> (new char (c)); }
+};
+
+BOOST_AUTO_TEST_CASE (test_transform_move_only) {
+    using parse_ll::parse;
+    using parse_ll::success;
+    using parse_ll::output;
+
+    std::string r ("ab");
+    auto parser = parse_ll::char_ [make_unique()];
+    auto result = parse (parser, r);
+    BOOST_CHECK (success (result));
+    std::unique_ptr <char> o = output (result);
+    BOOST_CHECK_EQUAL (*o, 'a');
+    BOOST_CHECK_EQUAL (*output (result), 'a');
+    BOOST_CHECK_EQUAL (*output (std::move (result)), 'a');
+}
+
 BOOST_AUTO_TEST_SUITE_END()
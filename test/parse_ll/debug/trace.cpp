@@ -29,6 +29,8 @@ Test trace.
 #include <typeinfo>
 #include <list>
 #include <string>
+#include <vector>
+#include <memory>
 
 #include <boost/any.hpp>
 
@@ -246,5 +248,52 @@ sequence successful (1,6) "aabst"
 //    BOOST_CHECK (false);
 }
 
+/// Observer that records the depth of every parse that is started.
+struct depth_observer {
+    std::shared_ptr <std::vector <int>> depths;
+
+    depth_observer() : depths (std::make_shared <std::vector <int>>()) {}
+
+    template <class Parser, class Input>
+        void start_parse (int depth, Parser const &, Input const &) const
+    { depths->push_back (depth); }
+
+    template <class Parser, class Input, class Outcome>
+        void success (int, Parser const &, Input const &, Input const &,
+            Outcome const &) const {}
+
+    template <class Parser, class Input>
+        void no_success (int, Parser const &, Input const &) const {}
+};
+
+// An exception from a sub-parser should not leave the trace one level too
+// deep.
+BOOST_AUTO_TEST_CASE (test_trace_exception) {
+    depth_observer observer;
+    auto parser = trace (observer, parse_ll::parse_policy::no_stop()) [
+        literal ('a') > literal ('b')];
+
+    std::string wrong = "ac";
+    BOOST_CHECK_THROW (parse (parser, wrong), parse_ll::error);
+    BOOST_REQUIRE (!observer.depths->empty());
+    BOOST_CHECK_EQUAL (observer.depths->front(), 0);
+
+    observer.depths->clear();
+    std::string right = "ab";
+    BOOST_CHECK (parse_ll::success (parse (parser, right)));
+    std::vector <int> expected {0, 1, 1};
+    BOOST_CHECK_EQUAL_COLLECTIONS (observer.depths->begin(),
+        observer.depths->end(), expected.begin(), expected.end());
+}
+
+// The trace policy is a handle, so that copying it into lazy outcomes is
+// cheap.
+BOOST_AUTO_TEST_CASE (test_trace_policy_size) {
+    typedef parse_ll::parse_policy::trace_policy <
+        parse_ll::parse_policy::direct, expect_observer,
+        parse_ll::parse_policy::no_stop> policy_type;
+    BOOST_CHECK (sizeof (policy_type) <= 3 * sizeof (void *));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,150 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test patterns and the DFA that is built from them.
+*/
+
+#define BOOST_TEST_MODULE lex_dfa
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/lex/dfa.hpp"
+
+#include <string>
+#include <vector>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+#include "range/walk_size.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_lex_dfa)
+
+using parse_ll::lex::pattern;
+using parse_ll::lex::dfa;
+using parse_ll::lex::literal;
+using parse_ll::lex::one_of;
+using parse_ll::lex::between;
+
+/**
+\return The length of the longest match of automaton at the start of text,
+or -1 if there is none, after checking that the two versions of
+longest_match agree.
+*/
+int match_length (dfa const & automaton, std::string const & text,
+    int expected_pattern = 0)
+{
+    auto match = automaton.longest_match (
+        text.data(), text.data() + text.size());
+    auto range_match = automaton.longest_match (range::view (text));
+    BOOST_CHECK_EQUAL (match.pattern, range_match.first.pattern);
+    if (match.pattern == -1)
+        return -1;
+    BOOST_CHECK_EQUAL (match.pattern, expected_pattern);
+    BOOST_CHECK_EQUAL (match.length, range_match.first.length);
+    BOOST_CHECK_EQUAL (match.length,
+        text.size() - range::walk_size (range_match.second));
+    return int (match.length);
+}
+
+BOOST_AUTO_TEST_CASE (test_pattern) {
+    BOOST_CHECK (!literal ("a").matches_empty());
+    BOOST_CHECK (literal ("").matches_empty());
+    BOOST_CHECK (!(literal ("a") >> *literal ("b")).matches_empty());
+    BOOST_CHECK ((-literal ("a") >> *literal ("b")).matches_empty());
+    BOOST_CHECK ((literal ("a") | -literal ("b")).matches_empty());
+    BOOST_CHECK (!(literal ("a") | +literal ("b")).matches_empty());
+    BOOST_CHECK (!pattern::alternative ({}).matches_empty());
+    BOOST_CHECK (pattern::repeat (literal ("a"), 0, 3).matches_empty());
+    BOOST_CHECK (!pattern::repeat (literal ("a"), 2, 3).matches_empty());
+}
+
+BOOST_AUTO_TEST_CASE (test_dfa_single) {
+    {
+        // Matches nothing.
+        dfa automaton;
+        BOOST_CHECK_EQUAL (match_length (automaton, ""), -1);
+        BOOST_CHECK_EQUAL (match_length (automaton, "a"), -1);
+    }
+    {
+        dfa automaton ({literal ("abc")});
+        BOOST_CHECK_EQUAL (match_length (automaton, "abc"), 3);
+        BOOST_CHECK_EQUAL (match_length (automaton, "abcd"), 3);
+        BOOST_CHECK_EQUAL (match_length (automaton, "ab"), -1);
+        BOOST_CHECK_EQUAL (match_length (automaton, "xabc"), -1);
+    }
+    {
+        auto letter = between ('a', 'z') | between ('A', 'Z') | one_of ("_");
+        auto digit = between ('0', '9');
+        dfa automaton ({letter >> *(letter | digit)});
+        BOOST_CHECK_EQUAL (match_length (automaton, "a"), 1);
+        BOOST_CHECK_EQUAL (match_length (automaton, "_a1 b"), 3);
+        BOOST_CHECK_EQUAL (match_length (automaton, "Zz9_-"), 4);
+        BOOST_CHECK_EQUAL (match_length (automaton, "1a"), -1);
+        // Bytes are put in classes: letters, digits, and the rest.
+        BOOST_CHECK_EQUAL (automaton.class_num(), 3u);
+    }
+    {
+        // The empty string can match.
+        dfa automaton ({*literal ("ab")});
+        BOOST_CHECK_EQUAL (match_length (automaton, ""), 0);
+        BOOST_CHECK_EQUAL (match_length (automaton, "aba"), 2);
+        BOOST_CHECK_EQUAL (match_length (automaton, "ababx"), 4);
+    }
+    {
+        // Bounded repetition.
+        dfa automaton ({pattern::repeat (literal ("a"), 2, 4)});
+        BOOST_CHECK_EQUAL (match_length (automaton, "a"), -1);
+        BOOST_CHECK_EQUAL (match_length (automaton, "aa"), 2);
+        BOOST_CHECK_EQUAL (match_length (automaton, "aaa"), 3);
+        BOOST_CHECK_EQUAL (match_length (automaton, "aaaaaa"), 4);
+    }
+    {
+        // Unlike a parser, the pattern does not commit to the first
+        // alternative or to a greedy repetition.
+        dfa automaton ({(literal ("a") | literal ("ab")) >> literal ("c")});
+        BOOST_CHECK_EQUAL (match_length (automaton, "abc"), 3);
+        dfa automaton2 ({*literal ("a") >> literal ("ab")});
+        BOOST_CHECK_EQUAL (match_length (automaton2, "aaab"), 4);
+    }
+    {
+        // Any character, including 0 and 255.
+        dfa automaton ({+parse_ll::lex::any()});
+        BOOST_CHECK_EQUAL (match_length (automaton, std::string ("\0\xff", 2)),
+            2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_dfa_multiple) {
+    auto letter = between ('a', 'z');
+    dfa automaton ({literal ("if"), +letter, literal ("i")});
+    // The longest match wins.
+    BOOST_CHECK_EQUAL (match_length (automaton, "iffy", 1), 4);
+    // If the length is the same, the first pattern wins.
+    BOOST_CHECK_EQUAL (match_length (automaton, "if", 0), 2);
+    BOOST_CHECK_EQUAL (match_length (automaton, "if(", 0), 2);
+    BOOST_CHECK_EQUAL (match_length (automaton, "i(", 1), 1);
+    BOOST_CHECK_EQUAL (match_length (automaton, "(", 1), -1);
+}
+
+BOOST_AUTO_TEST_CASE (test_dfa_max_states) {
+    // The dead state, and one state for every prefix of "abcdef".
+    std::vector <parse_ll::lex::pattern> patterns {literal ("abcdef")};
+    BOOST_CHECK_THROW (dfa (patterns, 4), parse_ll::lex::lex_error);
+    dfa automaton (patterns, 8);
+    BOOST_CHECK_EQUAL (match_length (automaton, "abcdefg", 0), 6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
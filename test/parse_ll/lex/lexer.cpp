@@ -0,0 +1,99 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test the lexer.
+*/
+
+#define BOOST_TEST_MODULE lex_lexer
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/lex/lexer.hpp"
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(test_parse_lex_lexer)
+
+namespace lex = parse_ll::lex;
+
+enum kind { keyword_if, identifier, number, plus, comment };
+
+lex::lexer make_lexer() {
+    auto letter = lex::between ('a', 'z');
+    auto digit = lex::between ('0', '9');
+    return lex::lexer ({
+        {keyword_if, lex::literal ("if")},
+        {identifier, letter >> *(letter | digit)},
+        {number, +digit},
+        {plus, lex::literal ('+')},
+        {comment, lex::literal ("//") >> *lex::none_of ("\n")},
+        {lex::ignore, +lex::one_of (" \t\n")}});
+}
+
+/**
+\return The kinds of the tokens.
+*/
+std::vector <int> kinds (std::vector <lex::token> const & tokens) {
+    std::vector <int> result;
+    for (auto const & token : tokens)
+        result.push_back (token.kind);
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE (test_lexer) {
+    lex::lexer lexer = make_lexer();
+
+    BOOST_CHECK (lexer.tokenize ("").empty());
+    BOOST_CHECK (lexer.tokenize (" \n\t ").empty());
+
+    std::string text ("if iffy+12 // if\n  x1 +3");
+    auto tokens = lexer.tokenize (text);
+    std::vector <int> expected_kinds {keyword_if, identifier, plus, number,
+        comment, identifier, plus, number};
+    BOOST_CHECK (kinds (tokens) == expected_kinds);
+
+    std::vector <std::string> expected_text {"if", "iffy", "+", "12",
+        "// if", "x1", "+", "3"};
+    BOOST_REQUIRE_EQUAL (tokens.size(), expected_text.size());
+    for (std::size_t i = 0; i != tokens.size(); ++ i)
+        BOOST_CHECK_EQUAL (tokens [i].text(), expected_text [i]);
+
+    // Tokens refer to the text.
+    BOOST_CHECK (tokens [1].begin == text.data() + 3);
+    BOOST_CHECK_EQUAL (tokens [1].size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE (test_lexer_error) {
+    lex::lexer lexer = make_lexer();
+    try {
+        lexer.tokenize ("a + B");
+        BOOST_ERROR ("No exception thrown.");
+    } catch (lex::lex_error & e) {
+        std::size_t const * offset
+            = boost::get_error_info <lex::lex_offset> (e);
+        BOOST_REQUIRE (offset);
+        BOOST_CHECK_EQUAL (*offset, 4u);
+    }
+
+    // Definitions that match the empty string would never make progress.
+    BOOST_CHECK_THROW (lex::lexer ({{0, *lex::literal ('a')}}),
+        lex::lex_error);
+    BOOST_CHECK_THROW (lex::lexer ({{-2, lex::literal ('a')}}),
+        lex::lex_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
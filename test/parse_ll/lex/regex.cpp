@@ -0,0 +1,187 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test regex_parser.
+*/
+
+#define BOOST_TEST_MODULE lex_regex
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/lex/regex.hpp"
+
+#include <string>
+#include <tuple>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_lex_regex)
+
+/**
+\return The number of characters that the regular expression matches at the
+start of text, or -1 if it does not match.
+*/
+int matched (std::string const & expression, std::string const & text) {
+    auto outcome = parse_ll::parse (parse_ll::regex (expression), text);
+    if (!parse_ll::success (outcome))
+        return -1;
+    return int (parse_ll::output (outcome).size);
+}
+
+/**
+\return The offset in the expression at which reading fails, or -1 if it
+does not fail.
+*/
+int error_offset (std::string const & expression) {
+    try {
+        parse_ll::lex::read_regex (expression);
+        return -1;
+    } catch (parse_ll::lex::lex_error & e) {
+        std::size_t const * offset
+            = boost::get_error_info <parse_ll::lex::lex_offset> (e);
+        BOOST_REQUIRE (offset);
+        return int (*offset);
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_regex_syntax) {
+    BOOST_CHECK_EQUAL (matched ("abc", "abcd"), 3);
+    BOOST_CHECK_EQUAL (matched ("abc", "abd"), -1);
+    BOOST_CHECK_EQUAL (matched ("", "abc"), 0);
+    BOOST_CHECK_EQUAL (matched ("a|bc", "bcd"), 2);
+    BOOST_CHECK_EQUAL (matched ("a*", "aaab"), 3);
+    BOOST_CHECK_EQUAL (matched ("a*", "b"), 0);
+    BOOST_CHECK_EQUAL (matched ("a+", "b"), -1);
+    BOOST_CHECK_EQUAL (matched ("ab?c", "ac"), 2);
+    BOOST_CHECK_EQUAL (matched ("(ab)+", "ababa"), 4);
+    BOOST_CHECK_EQUAL (matched ("(?:ab)+", "ababa"), 4);
+    BOOST_CHECK_EQUAL (matched ("a{3}", "aaaa"), 3);
+    BOOST_CHECK_EQUAL (matched ("a{3}", "aa"), -1);
+    BOOST_CHECK_EQUAL (matched ("a{2,}", "aaaa"), 4);
+    BOOST_CHECK_EQUAL (matched ("a{1,2}", "aaaa"), 2);
+    BOOST_CHECK_EQUAL (matched (".*", "ab\ncd"), 2);
+    BOOST_CHECK_EQUAL (matched ("[a-c_]*", "ab_cd"), 4);
+    BOOST_CHECK_EQUAL (matched ("[^a-c]*", "xyzb"), 3);
+    BOOST_CHECK_EQUAL (matched ("[]a]*", "]a]b"), 3);
+    BOOST_CHECK_EQUAL (matched ("[a-]*", "a-a-b"), 4);
+    BOOST_CHECK_EQUAL (matched ("[\\d.]+", "1.5e3"), 3);
+    BOOST_CHECK_EQUAL (matched ("\\d+", "123a"), 3);
+    BOOST_CHECK_EQUAL (matched ("\\D+", "ab1"), 2);
+    BOOST_CHECK_EQUAL (matched ("\\w+", "a_1 b"), 3);
+    BOOST_CHECK_EQUAL (matched ("\\s+", " \t\nx"), 3);
+    BOOST_CHECK_EQUAL (matched ("\\S+", "ab c"), 2);
+    BOOST_CHECK_EQUAL (matched ("\\.\\*\\\\", ".*\\"), 3);
+    BOOST_CHECK_EQUAL (matched ("\\x41\\n", "A\n"), 2);
+    BOOST_CHECK_EQUAL (matched ("[\\x41-\\x43]+", "ABCD"), 3);
+
+    // The longest match is found, not the first.
+    BOOST_CHECK_EQUAL (matched ("a|ab", "abc"), 2);
+    BOOST_CHECK_EQUAL (matched ("a*ab", "aaab"), 4);
+}
+
+BOOST_AUTO_TEST_CASE (test_regex_errors) {
+    BOOST_CHECK_EQUAL (error_offset ("a(b"), 3);
+    BOOST_CHECK_EQUAL (error_offset ("ab)"), 2);
+    BOOST_CHECK_EQUAL (error_offset ("[ab"), 3);
+    BOOST_CHECK_EQUAL (error_offset ("[b-a]"), 4);
+    BOOST_CHECK_EQUAL (error_offset ("*a"), 0);
+    BOOST_CHECK_EQUAL (error_offset ("a**"), -1);
+    BOOST_CHECK_EQUAL (error_offset ("a*?"), 2);
+    BOOST_CHECK_EQUAL (error_offset ("a{2"), 3);
+    BOOST_CHECK_EQUAL (error_offset ("a{3,2}"), 5);
+    BOOST_CHECK_EQUAL (error_offset ("^a"), 0);
+    BOOST_CHECK_EQUAL (error_offset ("a\\q"), 2);
+    BOOST_CHECK_EQUAL (error_offset ("\\x4"), 2);
+    BOOST_CHECK_EQUAL (error_offset ("(?=a)"), 1);
+    BOOST_CHECK_THROW (parse_ll::regex ("a\\"), parse_ll::lex::lex_error);
+}
+
+// Nested repetitions multiply the size of the automaton.
+BOOST_AUTO_TEST_CASE (test_regex_nested_repetitions) {
+    using parse_ll::lex::read_regex;
+    using parse_ll::lex::lex_error;
+    BOOST_CHECK_THROW (read_regex ("(a{1000}){1000}"), lex_error);
+    BOOST_CHECK_THROW (read_regex ("((a{100}){100}b){100}"), lex_error);
+    BOOST_CHECK_THROW (read_regex ("(((a{1000})*){1000})+"), lex_error);
+    BOOST_CHECK_THROW (read_regex ("(a{1000}){60}(a{1000}){60}"), lex_error);
+    BOOST_CHECK_EQUAL (error_offset ("(a{1000}){1000}b"), 15);
+    BOOST_CHECK_NO_THROW (read_regex ("(a{1000}){60}"));
+}
+
+// The DFA for these expressions has a number of states that is exponential
+// in the count.
+BOOST_AUTO_TEST_CASE (test_regex_too_many_states) {
+    BOOST_CHECK_THROW (parse_ll::regex ("[ab]*a[ab]{20}"),
+        parse_ll::lex::lex_error);
+    BOOST_CHECK_THROW (parse_ll::regex ("[ab]*a[ab]{1000}"),
+        parse_ll::lex::lex_error);
+
+    auto small = parse_ll::regex ("[ab]*a[ab]{3}");
+    std::string input ("babbb");
+    BOOST_CHECK (parse_ll::success (parse_ll::parse (small, input)));
+}
+
+BOOST_AUTO_TEST_CASE (test_regex_parser) {
+    using parse_ll::regex;
+    using parse_ll::literal;
+
+    auto identifier = regex ("[A-Za-z_][A-Za-z0-9_]*");
+    auto uuid = regex ("[0-9a-f]{8}-([0-9a-f]{4}-){3}[0-9a-f]{12}");
+    auto timestamp = regex ("\\d{4}-\\d{2}-\\d{2}T\\d{2}:\\d{2}:\\d{2}"
+        "(\\.\\d+)?(Z|[+-]\\d{2}:\\d{2})");
+
+    {
+        std::string text ("_name1 = 3");
+        auto outcome = parse_ll::parse (identifier, text);
+        BOOST_CHECK (parse_ll::success (outcome));
+        BOOST_CHECK_EQUAL (parse_ll::output (outcome).str(), "_name1");
+        BOOST_CHECK_EQUAL (range::first (parse_ll::rest (outcome)), ' ');
+    }
+    BOOST_CHECK_EQUAL (matched (uuid.expression(),
+        "123e4567-e89b-12d3-a456-426614174000"), 36);
+    BOOST_CHECK_EQUAL (matched (uuid.expression(),
+        "123e4567-e89b-12d3-a456-42661417400"), -1);
+    BOOST_CHECK_EQUAL (matched (timestamp.expression(),
+        "2015-03-01T12:00:59.5+01:00 "), 27);
+    BOOST_CHECK_EQUAL (matched (timestamp.expression(),
+        "2015-03-01T12:00:59Z"), 20);
+
+    // Use it inside a grammar.
+    {
+        std::string text ("key = 123e4567-e89b-12d3-a456-426614174000;");
+        auto assignment = parse_ll::skip (parse_ll::whitespace) [
+            identifier >> literal ('=') >> uuid >> literal (';')];
+        auto outcome = parse_ll::parse (assignment, text);
+        BOOST_CHECK (parse_ll::success (outcome));
+        BOOST_CHECK_EQUAL (std::get <0> (parse_ll::output (outcome)).str(),
+            "key");
+        BOOST_CHECK_EQUAL (std::get <1> (parse_ll::output (outcome)).size,
+            36u);
+        BOOST_CHECK (range::empty (parse_ll::rest (outcome)));
+    }
+
+    // Copies share the DFA.
+    auto copy = identifier;
+    BOOST_CHECK (&copy.dfa() == &identifier.dfa());
+
+    BOOST_CHECK_EQUAL (std::string (parse_ll::describe (identifier)),
+        "regex");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
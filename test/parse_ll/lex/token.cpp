@@ -0,0 +1,92 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test parsing tokens.
+*/
+
+#define BOOST_TEST_MODULE lex_token
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/lex/token.hpp"
+
+#include <string>
+#include <vector>
+#include <tuple>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/lex/lexer.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_lex_token)
+
+namespace lex = parse_ll::lex;
+
+enum kind { number, plus, open, close };
+
+struct to_int {
+    int operator() (lex::token const & t) const
+    { return std::stoi (t.text()); }
+};
+
+// Add "+ number" to sum.
+struct add {
+    int operator() (int sum,
+        std::tuple <lex::token, int> const & operation) const
+    { return sum + std::get <1> (operation); }
+};
+
+BOOST_AUTO_TEST_CASE (test_token) {
+    using parse_ll::token;
+
+    lex::lexer lexer ({
+        {number, +lex::between ('0', '9')},
+        {plus, lex::literal ('+')},
+        {open, lex::literal ('(')},
+        {close, lex::literal (')')},
+        {lex::ignore, +lex::one_of (" \n")}});
+
+    std::string text ("12 + 3\n+ 40 )");
+    std::vector <lex::token> tokens = lexer.tokenize (text);
+    auto input = range::view (tokens);
+
+    {
+        auto outcome = parse_ll::parse (token (number), input);
+        BOOST_CHECK (parse_ll::success (outcome));
+        BOOST_CHECK_EQUAL (parse_ll::output (outcome).text(), "12");
+        BOOST_CHECK_EQUAL (range::first (parse_ll::rest (outcome)).kind, plus);
+    }
+    BOOST_CHECK (!parse_ll::success (parse_ll::parse (token (plus), input)));
+    BOOST_CHECK (!parse_ll::success (parse_ll::parse (token (plus),
+        range::view (std::vector <lex::token>()))));
+
+    // No skip parser is needed: the lexer has removed the whitespace.
+    auto sum = parse_ll::fold (0, add()) [
+        *(token (plus) >> token (number) [to_int()])];
+    auto expression = token (number) [to_int()] >> sum;
+    auto outcome = parse_ll::parse (expression, input);
+    BOOST_CHECK (parse_ll::success (outcome));
+    BOOST_CHECK_EQUAL (std::get <0> (parse_ll::output (outcome)), 12);
+    BOOST_CHECK_EQUAL (std::get <1> (parse_ll::output (outcome)), 43);
+    BOOST_CHECK_EQUAL (range::first (parse_ll::rest (outcome)).kind, close);
+
+    BOOST_CHECK_EQUAL (std::string (parse_ll::describe (token (plus))),
+        "token");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
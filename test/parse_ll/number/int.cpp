@@ -34,6 +34,10 @@ Test int parser.
 #include "parse_ll/core/skip.hpp"
 #include "parse_ll/core/literal.hpp"
 
+// The number parsers can be used in constant expressions.
+constexpr auto int_pair = parse_ll::int_as <long>()
+    >> parse_ll::literal (',') >> parse_ll::int_;
+
 BOOST_AUTO_TEST_SUITE(test_parse_int)
 
 BOOST_AUTO_TEST_CASE (test_int) {
@@ -142,6 +146,14 @@ BOOST_AUTO_TEST_CASE (test_int) {
             BOOST_CHECK_THROW (output (parse (parser, r)), std::overflow_error);
         }
     }
+    {
+        std::string r ("-12,34");
+        auto result = parse (int_pair, r);
+        BOOST_CHECK (success (result));
+        BOOST_CHECK_EQUAL (std::get <0> (output (result)), -12l);
+        BOOST_CHECK_EQUAL (std::get <1> (output (result)), 34);
+        BOOST_CHECK (empty (rest (result)));
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,157 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test parsers for unsigned integers in other bases.
+*/
+
+#define BOOST_TEST_MODULE uint_parser
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/number/uint.hpp"
+
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "range/core.hpp"
+#include "range/std/container.hpp"
+
+#include "../helper/fuzz_parser.hpp"
+
+#include "parse_ll/core/skip.hpp"
+#include "parse_ll/core/literal.hpp"
+#include "parse_ll/core/sequence.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_uint)
+
+using parse_ll::parse;
+using parse_ll::success;
+using parse_ll::output;
+using parse_ll::rest;
+
+/**
+Parse text with parser both from contiguous memory and from a std::list,
+check that the results are the same, and return the output.
+Also check that the parser consumes "length" characters.
+*/
+template <class Parser> typename std::decay <decltype (output (parse (
+    std::declval <Parser>(), std::declval <std::string &>())))>::type
+    check_parse (Parser const & parser, std::string text, std::size_t length)
+{
+    auto result = parse (parser, text);
+    BOOST_REQUIRE (success (result));
+    BOOST_CHECK_EQUAL (range::walk_size (rest (result)),
+        text.size() - length);
+
+    std::list <char> list (text.begin(), text.end());
+    auto list_result = parse (parser, list);
+    BOOST_REQUIRE (success (list_result));
+    BOOST_CHECK_EQUAL (output (list_result), output (result));
+    BOOST_CHECK_EQUAL (range::walk_size (rest (list_result)),
+        text.size() - length);
+    return output (result);
+}
+
+BOOST_AUTO_TEST_CASE (test_uint_hex) {
+    using parse_ll::hex_;
+    BOOST_CHECK_EQUAL (check_parse (hex_, "0", 1), 0u);
+    BOOST_CHECK_EQUAL (check_parse (hex_, "f", 1), 15u);
+    BOOST_CHECK_EQUAL (check_parse (hex_, "Ab;", 2), 0xabu);
+    BOOST_CHECK_EQUAL (check_parse (hex_, "deadBEEF", 8), 0xdeadbeefu);
+    BOOST_CHECK_EQUAL (check_parse (hex_, "deadbeefg", 8), 0xdeadbeefu);
+    BOOST_CHECK_EQUAL (check_parse (hex_, "1234567 89", 7), 0x1234567u);
+    BOOST_CHECK_EQUAL (check_parse (hex_, "12:34567890", 2), 0x12u);
+    // Bytes that are not ASCII should not be taken as digits.
+    BOOST_CHECK_EQUAL (check_parse (hex_, "1\xb1\xc1\xe1zzzzzz", 1), 1u);
+    BOOST_CHECK_EQUAL (check_parse (hex_, "9@G`g/:FfaA00000", 1), 9u);
+
+    auto hex64 = parse_ll::uint_as <std::uint64_t, 16>();
+    BOOST_CHECK_EQUAL (check_parse (hex64, "0123456789abcdef", 16),
+        0x0123456789abcdefull);
+    BOOST_CHECK_EQUAL (check_parse (hex64, "FEDCBA9876543210 ", 16),
+        0xfedcba9876543210ull);
+    BOOST_CHECK_EQUAL (check_parse (hex64, "ffffffffffffffff", 16),
+        0xffffffffffffffffull);
+    // Leading zeros beyond 16 digits.
+    BOOST_CHECK_EQUAL (check_parse (hex64, "000000000000000000012345", 24),
+        0x12345ull);
+    BOOST_CHECK_EQUAL (check_parse (hex64, "abcdef012", 9), 0xabcdef012ull);
+
+    std::string overflow ("100000000");
+    BOOST_CHECK_THROW (output (parse (hex_, overflow)), std::overflow_error);
+    std::string overflow64 ("10000000000000000");
+    BOOST_CHECK_THROW (output (parse (hex64, overflow64)),
+        std::overflow_error);
+    std::list <char> overflow_list (overflow.begin(), overflow.end());
+    BOOST_CHECK_THROW (output (parse (hex_, overflow_list)),
+        std::overflow_error);
+
+    std::string empty;
+    BOOST_CHECK (!success (parse (hex_, empty)));
+    std::string no_digits ("x12345678");
+    BOOST_CHECK (!success (parse (hex_, no_digits)));
+}
+
+BOOST_AUTO_TEST_CASE (test_uint_other_bases) {
+    BOOST_CHECK_EQUAL (check_parse (parse_ll::oct_, "0", 1), 0u);
+    BOOST_CHECK_EQUAL (check_parse (parse_ll::oct_, "7778", 3), 0777u);
+    BOOST_CHECK_EQUAL (check_parse (parse_ll::bin_, "1011012", 6), 45u);
+    BOOST_CHECK_EQUAL (check_parse (
+        parse_ll::bin_, "11111111111111111111111111111111", 32),
+        0xffffffffu);
+    BOOST_CHECK_EQUAL (check_parse (
+        parse_ll::uint_as <unsigned char, 10>(), "255", 3), 255u);
+    BOOST_CHECK_EQUAL (check_parse (
+        parse_ll::uint_as <int, 36>(), "Zz", 2), 36 * 35 + 35);
+
+    std::string overflow ("256");
+    BOOST_CHECK_THROW (
+        output (parse (parse_ll::uint_as <unsigned char, 10>(), overflow)),
+        std::overflow_error);
+    std::string overflow_bin (std::string (33, '1'));
+    BOOST_CHECK_THROW (output (parse (parse_ll::bin_, overflow_bin)),
+        std::overflow_error);
+    // 2^64 in octal, which fits in safe_digits only in part.
+    std::string overflow64 ("2000000000000000000000");
+    BOOST_CHECK_THROW (output (parse (
+        parse_ll::uint_as <std::uint64_t, 8>(), overflow64)),
+        std::overflow_error);
+    BOOST_CHECK_EQUAL (check_parse (parse_ll::uint_as <std::uint64_t, 8>(),
+        "1777777777777777777777", 22), 0xffffffffffffffffull);
+
+    std::string not_octal ("8");
+    BOOST_CHECK (!success (parse (parse_ll::oct_, not_octal)));
+}
+
+BOOST_AUTO_TEST_CASE (test_uint_in_grammar) {
+    std::string text ("ff 10 ");
+    // The skip parser should not be used inside the number.
+    auto parser = parse_ll::skip (parse_ll::literal (' ')) [
+        parse_ll::hex_ >> fuzz (parse_ll::hex_)];
+    auto result = parse (parser, text);
+    BOOST_CHECK (success (result));
+    BOOST_CHECK_EQUAL (std::get <0> (output (result)), 255u);
+    BOOST_CHECK_EQUAL (std::get <1> (output (result)), 16u);
+    BOOST_CHECK_EQUAL (range::first (rest (result)), ' ');
+
+    BOOST_CHECK_EQUAL (parse_ll::describe (parse_ll::hex_),
+        std::string ("hex"));
+    BOOST_CHECK_EQUAL (parse_ll::describe (parse_ll::bin_),
+        std::string ("binary"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test block_range.
+*/
+
+#define BOOST_TEST_MODULE block_range
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/support/block_range.hpp"
+
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+
+#include "range/core.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/number/unsigned.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_block_range)
+
+using range::empty;
+using range::first;
+using range::drop;
+using range::block_range;
+
+/**
+Read function that produces text, and then throws if throw_at_end is set.
+*/
+struct read_text {
+    std::shared_ptr <std::string> text;
+    std::shared_ptr <std::size_t> position;
+    bool throw_at_end;
+
+    read_text (std::string const & text, bool throw_at_end = false)
+    : text (std::make_shared <std::string> (text)),
+        position (std::make_shared <std::size_t> (0)),
+        throw_at_end (throw_at_end) {}
+
+    std::size_t operator() (char * buffer, std::size_t size) const {
+        std::size_t length = std::min (size, text->size() - *position);
+        if (length == 0 && throw_at_end)
+            throw parse_ll::input_error()
+                << parse_ll::error_description ("Corrupt data");
+        std::copy (text->begin() + *position,
+            text->begin() + *position + length, buffer);
+        *position += length;
+        return length;
+    }
+};
+
+std::string numbers (int number_num) {
+    std::string result;
+    for (int i = 0; i != number_num; ++ i)
+        result += std::to_string (i) + ' ';
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE (test_block_range_empty) {
+    block_range r (read_text (""));
+    BOOST_CHECK (empty (r));
+    BOOST_CHECK (r == r);
+}
+
+BOOST_AUTO_TEST_CASE (test_block_range_read) {
+    std::string text = numbers (1000);
+    // Small blocks, so that many block boundaries are crossed.
+    block_range r (read_text (text), 7, 2);
+
+    block_range start = r;
+    std::string result;
+    for (; !empty (r); r = drop (r))
+        result.push_back (first (r));
+    BOOST_CHECK_EQUAL (result, text);
+
+    // A copy that was kept still refers to the start, even though the
+    // producer has finished.
+    BOOST_CHECK (start != r);
+    BOOST_CHECK_EQUAL (first (start), '0');
+    BOOST_CHECK_EQUAL (range::walk_size (start), text.size());
+}
+
+BOOST_AUTO_TEST_CASE (test_block_range_parse) {
+    std::string text = numbers (10000);
+    block_range input (read_text (text), 100, 3);
+
+    struct add {
+        unsigned operator() (unsigned sum, unsigned value) const
+        { return sum + value; }
+    };
+
+    auto parser = parse_ll::skip (parse_ll::literal (' ')) [
+        parse_ll::fold (0u, add()) [*parse_ll::unsigned_] >> parse_ll::end];
+    auto result = parse_ll::parse (parser, input);
+    BOOST_CHECK (parse_ll::success (result));
+    BOOST_CHECK_EQUAL (std::get <0> (parse_ll::output (result)),
+        10000u * 9999u / 2);
+}
+
+BOOST_AUTO_TEST_CASE (test_block_range_error) {
+    std::string text = "0123456789";
+    block_range r (read_text (text, true), 4);
+    for (int i = 0; i != 9; ++ i) {
+        BOOST_CHECK_EQUAL (first (r), char ('0' + i));
+        r = drop (r);
+    }
+    BOOST_CHECK_EQUAL (first (r), '9');
+    BOOST_CHECK_THROW (drop (r), parse_ll::input_error);
+    // The exception is rethrown every time.
+    BOOST_CHECK_THROW (drop (r), parse_ll::input_error);
+
+    BOOST_CHECK_THROW (block_range (read_text ("", true)),
+        parse_ll::input_error);
+}
+
+// Destructing the range while the producer is waiting should stop it.
+BOOST_AUTO_TEST_CASE (test_block_range_stop) {
+    auto read_forever = [] (char * buffer, std::size_t size) {
+        std::fill (buffer, buffer + size, 'a');
+        return size;
+    };
+    block_range r (read_forever, 16, 2);
+    for (int i = 0; i != 100; ++ i)
+        r = drop (r);
+    BOOST_CHECK_EQUAL (first (r), 'a');
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test utf8_range.
+*/
+
+#define BOOST_TEST_MODULE utf8_range
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/support/utf8_range.hpp"
+
+#include <string>
+#include <sstream>
+#include <type_traits>
+
+#include "range/core.hpp"
+
+#include "parse_ll/core.hpp"
+#include "parse_ll/debug/ostream_observer.hpp"
+#include "parse_ll/debug/trace.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_utf8_range)
+
+using range::empty;
+using range::first;
+using range::drop;
+using range::utf8_range;
+
+/**
+\return The offset that constructing a utf8_range on text reports, or -1 if
+it does not throw.
+*/
+long invalid_offset (std::string const & text) {
+    try {
+        utf8_range r (text);
+        return -1;
+    } catch (parse_ll::utf8_error & e) {
+        std::size_t const * offset = boost::get_error_info <
+            parse_ll::utf8_offset> (e);
+        BOOST_REQUIRE (offset);
+        return long (*offset);
+    }
+}
+
+BOOST_AUTO_TEST_CASE (test_utf8_range_decode) {
+    // a, e acute, euro sign, G clef.
+    std::string text = "a\xc3\xa9\xe2\x82\xac\xf0\x9d\x84\x9e";
+    utf8_range r (text);
+    BOOST_CHECK (!r.ascii());
+    BOOST_CHECK_EQUAL (r.offset(), 0u);
+
+    BOOST_CHECK (!empty (r));
+    BOOST_CHECK_EQUAL (first (r), U'a');
+    r = drop (r);
+    BOOST_CHECK_EQUAL (r.offset(), 1u);
+    BOOST_CHECK_EQUAL (first (r), U'é');
+    r = drop (r);
+    BOOST_CHECK_EQUAL (r.offset(), 3u);
+    BOOST_CHECK_EQUAL (first (r), U'€');
+    r = drop (r);
+    BOOST_CHECK_EQUAL (r.offset(), 6u);
+    BOOST_CHECK_EQUAL (first (r), U'\U0001d11e');
+    r = drop (r);
+    BOOST_CHECK_EQUAL (r.offset(), 10u);
+    BOOST_CHECK (empty (r));
+    BOOST_CHECK (r == utf8_range (text.data() + 10, text.data() + 10));
+    BOOST_CHECK (r.position() == text.data() + text.size());
+}
+
+BOOST_AUTO_TEST_CASE (test_utf8_range_ascii) {
+    std::string text = "The quick brown fox jumps over the lazy dog.";
+    utf8_range r (text);
+    BOOST_CHECK (r.ascii());
+    std::string decoded;
+    for (; !empty (r); r = drop (r))
+        decoded.push_back (char (first (r)));
+    BOOST_CHECK_EQUAL (decoded, text);
+
+    // Non-ASCII after a few blocks of ASCII.
+    std::string late = text + "\xc3\xa9";
+    utf8_range r2 (late);
+    BOOST_CHECK (!r2.ascii());
+    std::size_t count = 0;
+    for (; !empty (r2); r2 = drop (r2))
+        ++ count;
+    BOOST_CHECK_EQUAL (count, text.size() + 1);
+}
+
+// A range cannot be made from a temporary string, which it would outlive.
+static_assert (std::is_constructible <utf8_range, std::string &>::value, "");
+static_assert (!std::is_constructible <utf8_range, std::string>::value, "");
+
+BOOST_AUTO_TEST_CASE (test_utf8_range_invalid) {
+    std::string padding (20, 'x');
+
+    BOOST_CHECK_EQUAL (invalid_offset (""), -1);
+    BOOST_CHECK_EQUAL (invalid_offset ("\xed\x9f\xbf\xf4\x8f\xbf\xbf"), -1);
+
+    // Continuation byte as lead.
+    BOOST_CHECK_EQUAL (invalid_offset ("a\x80"), 1);
+    BOOST_CHECK_EQUAL (invalid_offset (padding + "\xbf"), 20);
+    // Overlong sequences.
+    BOOST_CHECK_EQUAL (invalid_offset ("ab\xc0\xaf"), 2);
+    BOOST_CHECK_EQUAL (invalid_offset ("\xc1\xbf"), 0);
+    BOOST_CHECK_EQUAL (invalid_offset ("\xe0\x80\xaf"), 0);
+    BOOST_CHECK_EQUAL (invalid_offset ("\xf0\x80\x80\xaf"), 0);
+    // Surrogate.
+    BOOST_CHECK_EQUAL (invalid_offset ("\xed\xa0\x80"), 0);
+    // Beyond U+10FFFF.
+    BOOST_CHECK_EQUAL (invalid_offset ("\xf4\x90\x80\x80"), 0);
+    BOOST_CHECK_EQUAL (invalid_offset ("\xf5\x80\x80\x80"), 0);
+    // Truncated.
+    BOOST_CHECK_EQUAL (invalid_offset (padding + "\xe2\x82"), 20);
+    // Bad continuation byte.
+    BOOST_CHECK_EQUAL (invalid_offset ("\xe2\x82x"), 0);
+    BOOST_CHECK_EQUAL (invalid_offset ("a\xf0\x9d\x84\x1e"), 1);
+}
+
+BOOST_AUTO_TEST_CASE (test_utf8_range_parse) {
+    using parse_ll::char_;
+    using parse_ll::literal;
+
+    std::string text = "caf\xc3\xa9 na\xc3\xafve";
+    utf8_range input (text);
+
+    auto word = +(char_ - literal (U' '));
+    auto words = literal (U'c') >> literal (U'a') >> literal (U'f')
+        >> literal (U'é') >> literal (U' ') >> word;
+    auto result = parse_ll::parse (words, input);
+    BOOST_CHECK (parse_ll::success (result));
+    BOOST_CHECK (empty (parse_ll::rest (result)));
+
+    auto result2 = parse_ll::parse (char_ (U'é'), input);
+    BOOST_CHECK (!parse_ll::success (result2));
+
+    // A char_class only matches ASCII code points.
+    parse_ll::char_parser <parse_ll::char_class> letter (
+        parse_ll::char_class ("acefinv"));
+    auto letters = +letter;
+    auto result3 = parse_ll::parse (letters, input);
+    BOOST_CHECK (parse_ll::success (result3));
+    BOOST_CHECK_EQUAL (parse_ll::rest (result3).offset(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE (test_utf8_range_trace) {
+    std::string text = "\xc3\xa9t\xc3\xa9";
+    utf8_range input (text);
+
+    std::stringstream stream;
+    auto parser = parse_ll::trace (parse_ll::ostream_observer (stream),
+        parse_ll::parse_policy::stop_at_no_skip()) [
+            parse_ll::char_ >> parse_ll::char_ ];
+    auto result = parse_ll::parse (parser, input);
+    BOOST_CHECK (parse_ll::success (result));
+    // The text consumed is shown as UTF-8.
+    BOOST_CHECK (stream.str().find ("(3) \"\xc3\xa9t\"")
+        != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
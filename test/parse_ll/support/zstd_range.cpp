@@ -0,0 +1,97 @@
+/*
+Copyright 2015 Rogier van Dalen.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/** \file
+Test zstd_file_range.
+*/
+
+#define BOOST_TEST_MODULE zstd_range
+#include "utility/test/boost_unit_test.hpp"
+
+#include "parse_ll/support/zstd_range.hpp"
+
+#include <cstdio>
+#include <string>
+#include <fstream>
+
+#include "range/core.hpp"
+
+BOOST_AUTO_TEST_SUITE(test_parse_zstd_range)
+
+using range::empty;
+using range::first;
+using range::drop;
+
+std::string read_all (range::block_range r) {
+    std::string result;
+    for (; !empty (r); r = drop (r))
+        result.push_back (first (r));
+    return result;
+}
+
+std::string make_text() {
+    std::string text;
+    for (int i = 0; i != 20000; ++ i)
+        text += "line " + std::to_string (i * 7919 % 10007) + '\n';
+    return text;
+}
+
+std::string compress (std::string const & text) {
+    std::string result (ZSTD_compressBound (text.size()), '\0');
+    std::size_t size = ZSTD_compress (&result [0], result.size(),
+        text.data(), text.size(), 3);
+    BOOST_REQUIRE (!ZSTD_isError (size));
+    result.resize (size);
+    return result;
+}
+
+void write_file (std::string const & file_name, std::string const & data) {
+    std::ofstream file (file_name.c_str(), std::ios::binary);
+    file << data;
+}
+
+BOOST_AUTO_TEST_CASE (test_zstd_range) {
+    std::string const file_name = "zstd_range_test.zst";
+    std::string const text = make_text();
+    std::string const compressed = compress (text);
+
+    write_file (file_name, compressed);
+    BOOST_CHECK (read_all (range::zstd_file_range (file_name)) == text);
+    // Small blocks.
+    BOOST_CHECK (read_all (range::zstd_file_range (file_name, 1000, 2))
+        == text);
+
+    // Two frames.
+    write_file (file_name, compressed + compress ("end\n"));
+    BOOST_CHECK (read_all (range::zstd_file_range (file_name))
+        == text + "end\n");
+
+    // Truncated.
+    write_file (file_name, compressed.substr (0, compressed.size() - 3));
+    BOOST_CHECK_THROW (read_all (range::zstd_file_range (file_name)),
+        parse_ll::input_error);
+
+    // Not compressed.
+    write_file (file_name, "plain text");
+    BOOST_CHECK_THROW (read_all (range::zstd_file_range (file_name)),
+        parse_ll::input_error);
+
+    std::remove (file_name.c_str());
+    BOOST_CHECK_THROW (range::zstd_file_range (file_name),
+        parse_ll::input_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()